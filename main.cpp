@@ -4,17 +4,24 @@
 #include <QFontDatabase>
 #include <QDir>
 #include <QQuickStyle>
+#include <QCommandLineParser>
+#include <QDebug>
 
 #include "src/backend/NavigationBackend.h"
 #include "src/backend/PerceptionBackend.h"
 #include "src/backend/GlobalReceiver.h"
+#include "src/backend/RxMetrics.h"
+#include "src/backend/RxConflator.h"
 #include "src/backend/GlobalTransmitter.h"
 #include "src/backend/SettingsBackend.h"
 #include "src/backend/LoggerBackend.h"
+#include "src/backend/CanSignalsBackend.h"
+#include "src/backend/CanStatsBackend.h"
 #include "src/backend/InternetBackend.h"
 #include "src/backend/TerminalBackend.h"
 #include "src/backend/CameraFramesBackend.h"
 #include "src/backend/LogBackupBackend.h"
+#include "src/backend/LogStorageBackend.h"
 #include "src/backend/IntelLogsBackend.h"
 
 static void loadAppFonts()
@@ -48,6 +55,24 @@ int main(int argc, char *argv[])
 
     loadAppFonts();
 
+    // Profiling aids: capture raw RX traffic, or replay a capture as deterministic load
+    QCommandLineParser parser;
+    const QCommandLineOption helpOpt = parser.addHelpOption();
+    const QCommandLineOption rxCaptureOpt(QStringLiteral("rx-capture"),
+        QStringLiteral("Record every received RX payload to <file> (.hmicap)."), QStringLiteral("file"));
+    const QCommandLineOption rxReplayOpt(QStringLiteral("rx-replay"),
+        QStringLiteral("Replay a capture <file> (.hmicap or .hmises session) into the RX parser."), QStringLiteral("file"));
+    const QCommandLineOption rxReplaySpeedOpt(QStringLiteral("rx-replay-speed"),
+        QStringLiteral("Replay speed factor; 0 = as fast as possible (default 1)."), QStringLiteral("factor"),
+        QStringLiteral("1"));
+    const QCommandLineOption rxReplayLoopOpt(QStringLiteral("rx-replay-loop"),
+        QStringLiteral("Restart the replay when it reaches the end."));
+    parser.addOptions({ rxCaptureOpt, rxReplayOpt, rxReplaySpeedOpt, rxReplayLoopOpt });
+    if (!parser.parse(QCoreApplication::arguments()))
+        qWarning() << "[main]" << parser.errorText();
+    if (parser.isSet(helpOpt))
+        parser.showHelp();
+
     QQmlApplicationEngine engine;
 
     auto* navBackend = new NavigationBackend(&engine);
@@ -61,13 +86,23 @@ int main(int argc, char *argv[])
     // Apply initial settings from QSettings to backends
     settingsBackend->applyInitialSettings();
 
+    if (parser.isSet(rxCaptureOpt))
+        navBackend->startRxCapture(parser.value(rxCaptureOpt));
+    if (parser.isSet(rxReplayOpt)) {
+        navBackend->startRxReplay(parser.value(rxReplayOpt),
+                                  parser.value(rxReplaySpeedOpt).toDouble(),
+                                  parser.isSet(rxReplayLoopOpt));
+    }
+
     engine.rootContext()->setContextProperty("NavigationBackend", navBackend);
+    engine.rootContext()->setContextProperty("RxMetrics", navBackend->rxMetrics());
+    engine.rootContext()->setContextProperty("RxConflator", navBackend->rxConflator());
     engine.rootContext()->setContextProperty("GlobalTx", txBackend);
     engine.rootContext()->setContextProperty("SettingsBackend", settingsBackend);
 
     auto* perceptionBackend = new PerceptionBackend(&engine);
     engine.rootContext()->setContextProperty("PerceptionBackend", perceptionBackend);
-    QObject::connect(navBackend->globalReceiver(), &GlobalReceiver::perceptionFrameReceived,
+    QObject::connect(navBackend->rxConflator(), &RxConflator::perceptionFrameReceived,
                      perceptionBackend, &PerceptionBackend::onPerceptionFrameReceived);
 
     auto* loggerBackend = new LoggerBackend(&engine);
@@ -85,6 +120,24 @@ int main(int argc, char *argv[])
 
     QObject::connect(navBackend->globalReceiver(), &GlobalReceiver::canBatchReceived,
                      loggerBackend, &LoggerBackend::onCanBatch);
+    QObject::connect(loggerBackend, &LoggerBackend::allStreamsRecordingStarted,
+                     navBackend, &NavigationBackend::startSessionRecording);
+    QObject::connect(loggerBackend, &LoggerBackend::allStreamsRecordingStopped,
+                     navBackend, &NavigationBackend::stopSessionRecording);
+    QObject::connect(navBackend->globalReceiver(), &GlobalReceiver::sessionStarted,
+                     loggerBackend, &LoggerBackend::onSessionContainerStarted);
+    QObject::connect(navBackend->globalReceiver(), &GlobalReceiver::sessionFailed,
+                     loggerBackend, &LoggerBackend::onSessionContainerFailed);
+    QObject::connect(navBackend->globalReceiver(), &GlobalReceiver::sessionProgress,
+                     loggerBackend, &LoggerBackend::onSessionContainerProgress);
+    QObject::connect(navBackend->globalReceiver(), &GlobalReceiver::sessionFinished,
+                     loggerBackend, &LoggerBackend::onSessionContainerFinished);
+    auto* canSignalsBackend = new CanSignalsBackend(&engine);
+    canSignalsBackend->attach(navBackend->globalReceiver());
+    engine.rootContext()->setContextProperty("CanSignalsBackend", canSignalsBackend);
+    auto* canStatsBackend = new CanStatsBackend(&engine);
+    canStatsBackend->attach(navBackend->globalReceiver());
+    engine.rootContext()->setContextProperty("CanStatsBackend", canStatsBackend);
 
     auto* cameraFramesBackend = new CameraFramesBackend(&engine);
     cameraFramesBackend->addImageProviderTo(&engine);
@@ -95,6 +148,14 @@ int main(int argc, char *argv[])
     auto* intelLogsBackend = new IntelLogsBackend(&engine);
     engine.rootContext()->setContextProperty("IntelLogsBackend", intelLogsBackend);
 
+    // Quotas and free-space reserve for src/logs/CAN and src/logs/intel
+    auto* logStorageBackend = new LogStorageBackend(&engine);
+    loggerBackend->setStorageBackend(logStorageBackend);
+    intelLogsBackend->setStorageBackend(logStorageBackend);
+    QObject::connect(logBackupBackend, &LogBackupBackend::fileBackedUp,
+                     logStorageBackend, &LogStorageBackend::markBackedUp);
+    engine.rootContext()->setContextProperty("LogStorageBackend", logStorageBackend);
+
     // Cross-platform maps directory:
     // On Linux you used /home/hmi/HMI/maps/. On Windows, use a local "maps" folder next to the exe.
     const QString mapsDir = QDir(QCoreApplication::applicationDirPath()).filePath("maps");
@@ -79,15 +79,17 @@ Item {
             root.canSC = LoggerBackend.canSC
             root.canLS = LoggerBackend.canLS
             root.canBusSelectionEnabled = typeof NavigationBackend !== "undefined" ? NavigationBackend.canLoggerOn : false
-            LoggerBackend.refreshLogList()
-            refreshLogsTimer.start()
         }
     }
-    Timer {
-        id: refreshLogsTimer
-        interval: 400
-        repeat: false
-        onTriggered: if (typeof LoggerBackend !== "undefined") LoggerBackend.refreshLogList()
+
+    // Second line of a saved-log row (LogDirectoryIndex roles): "1:23 • 45,000 events • 12.3 MB • backed up"
+    function logFileDetails(durationText, events, sizeText, backedUp, eventsLabel) {
+        var parts = []
+        if (durationText !== "") parts.push(durationText)
+        if (events >= 0) parts.push(events.toLocaleString(Qt.locale(), "f", 0) + " " + eventsLabel)
+        parts.push(sizeText)
+        if (backedUp) parts.push("backed up")
+        return parts.join(" • ")
     }
 
     Timer {
@@ -140,12 +142,46 @@ Item {
                     anchors.margins: HMI.Theme.px(16)
                     spacing: HMI.Theme.px(14)
 
-                    Label {
-                        text: "CAN Network"
-                        color: HMI.Theme.text
-                        font.pixelSize: HMI.Theme.px(24)
-                        font.bold: true
+                    RowLayout {
                         Layout.fillWidth: true
+                        spacing: HMI.Theme.px(8)
+
+                        Label {
+                            text: "CAN Network"
+                            color: HMI.Theme.text
+                            font.pixelSize: HMI.Theme.px(24)
+                            font.bold: true
+                            Layout.fillWidth: true
+                        }
+
+                        // Recording file format; fixed for the duration of a recording
+                        FormatChip {
+                            label: "CSV"
+                            checked: LoggerBackend.recordFormat === "csv"
+                            enabled: !root.recording
+                            onClicked: LoggerBackend.recordFormat = "csv"
+                        }
+                        FormatChip {
+                            label: "Binary"
+                            checked: LoggerBackend.recordFormat === "binary"
+                            enabled: !root.recording
+                            onClicked: LoggerBackend.recordFormat = "binary"
+                        }
+                        FormatChip {
+                            label: "Compress"
+                            checked: LoggerBackend.compressRecordings
+                            enabled: !root.recording
+                            toggle: true
+                            onClicked: LoggerBackend.compressRecordings = !LoggerBackend.compressRecordings
+                        }
+                        // Also record Navigation / Camera / Perception into one session container
+                        FormatChip {
+                            label: "All streams"
+                            checked: LoggerBackend.recordAllStreams
+                            enabled: !root.recording
+                            toggle: true
+                            onClicked: LoggerBackend.recordAllStreams = !LoggerBackend.recordAllStreams
+                        }
                     }
 
                     RowLayout {
@@ -263,7 +299,10 @@ Item {
                                 anchors.horizontalCenter: parent.horizontalCenter
                                 anchors.topMargin: HMI.Theme.px(4)
                                 visible: root.recording || root._postRecordingMessage !== ""
-                                text: root.recording ? root.formatRecordingTime(root.recordingElapsedMs) : (root._postRecordingMessage + " • " + root._postRecordingTime)
+                                text: root.recording
+                                      ? root.formatRecordingTime(root.recordingElapsedMs)
+                                        + (LoggerBackend.writerDroppedEvents > 0 ? " • " + LoggerBackend.writerDroppedEvents + " dropped" : "")
+                                      : (root._postRecordingMessage + " • " + root._postRecordingTime)
                                 color: root.recording ? HMI.Theme.text : (root._postRecordingGreen ? "#2E7D32" : "#C62828")
                                 font.pixelSize: HMI.Theme.px(20)
                                 font.family: "monospace"
@@ -288,13 +327,26 @@ Item {
                                 Layout.fillWidth: true
                             }
 
+                            // Disk space: free space, or the storage warning before writes start failing
+                            Label {
+                                readonly property var storage: typeof LogStorageBackend !== "undefined" ? LogStorageBackend : null
+                                visible: storage !== null && storage.freeBytes >= 0
+                                text: !storage ? "" : storage.warning !== "" ? storage.warning
+                                      : (Math.floor(storage.freeBytes / 1048576) + " MB free")
+                                color: !storage || storage.level === "ok" ? HMI.Theme.sub
+                                       : (storage.level === "full" ? "#C62828" : "#EF6C00")
+                                font.pixelSize: HMI.Theme.px(14)
+                                wrapMode: Text.WordWrap
+                                Layout.fillWidth: true
+                            }
+
                             ListView {
                                 id: savedLogsList
                                 Layout.fillWidth: true
                                 Layout.fillHeight: true
                                 Layout.minimumHeight: HMI.Theme.px(80)
                                 clip: true
-                                model: typeof LoggerBackend !== "undefined" ? LoggerBackend.logFileNames : []
+                                model: typeof LoggerBackend !== "undefined" ? LoggerBackend.logFiles : null
                                 spacing: HMI.Theme.px(4)
                                 boundsBehavior: Flickable.DragAndOvershootBounds
                                 flickDeceleration: 3000
@@ -302,22 +354,46 @@ Item {
                                 ScrollBar.vertical: ScrollBar { policy: ScrollBar.AlwaysOff }
 
                                 delegate: Rectangle {
+                                    required property string fileName
+                                    required property string durationText
+                                    required property var events
+                                    required property string sizeText
+                                    required property bool backedUp
+
                                     width: savedLogsList.width - HMI.Theme.px(2)
-                                    height: HMI.Theme.px(36)
+                                    height: HMI.Theme.px(52)
                                     radius: HMI.Theme.px(8)
                                     color: HMI.Theme.surface
                                     border.color: HMI.Theme.outline
                                     border.width: 1
 
-                                    Text {
+                                    Column {
                                         anchors.fill: parent
                                         anchors.margins: HMI.Theme.px(8)
-                                        text: modelData
-                                        color: HMI.Theme.text
-                                        font.pixelSize: HMI.Theme.px(14)
-                                        font.family: "monospace"
-                                        verticalAlignment: Text.AlignVCenter
-                                        elide: Text.ElideRight
+                                        spacing: HMI.Theme.px(2)
+
+                                        Text {
+                                            width: parent.width
+                                            text: fileName
+                                            color: HMI.Theme.text
+                                            font.pixelSize: HMI.Theme.px(14)
+                                            font.family: "monospace"
+                                            elide: Text.ElideRight
+                                        }
+                                        Text {
+                                            width: parent.width
+                                            text: root.logFileDetails(durationText, events, sizeText, backedUp, "events")
+                                            color: HMI.Theme.sub
+                                            font.pixelSize: HMI.Theme.px(12)
+                                            elide: Text.ElideRight
+                                        }
+                                    }
+
+                                    // Tap to inspect the recording below
+                                    MouseArea {
+                                        anchors.fill: parent
+                                        cursorShape: Qt.PointingHandCursor
+                                        onClicked: LoggerBackend.browseLog(fileName)
                                     }
                                 }
                             }
@@ -326,6 +402,239 @@ Item {
                 }
             }
 
+            // ——— Log Browser ——— (recording opened from "Saved logs")
+            Rectangle {
+                id: browserSection
+                readonly property var browser: typeof LoggerBackend !== "undefined" ? LoggerBackend.browser : null
+                visible: browser && browser.fileName !== ""
+                Layout.fillWidth: true
+                Layout.preferredHeight: HMI.Theme.px(420)
+                radius: HMI.Theme.px(18)
+                color: HMI.Theme.center
+                border.color: HMI.Theme.outline
+                border.width: 1
+                clip: true
+
+                ColumnLayout {
+                    anchors.fill: parent
+                    anchors.margins: HMI.Theme.px(16)
+                    spacing: HMI.Theme.px(10)
+
+                    RowLayout {
+                        Layout.fillWidth: true
+                        spacing: HMI.Theme.px(10)
+
+                        Label {
+                            text: browserSection.browser ? browserSection.browser.fileName : ""
+                            color: HMI.Theme.text
+                            font.pixelSize: HMI.Theme.px(20)
+                            font.bold: true
+                            font.family: "monospace"
+                            elide: Text.ElideMiddle
+                            Layout.fillWidth: true
+                        }
+                        Label {
+                            readonly property var b: browserSection.browser
+                            text: !b ? "" : b.errorString !== "" ? b.errorString
+                                  : (b.count + " events" + (b.indexing ? " • indexing…" : ""))
+                            color: b && b.errorString !== "" ? "#C62828" : HMI.Theme.sub
+                            font.pixelSize: HMI.Theme.px(14)
+                        }
+                        FormatChip {
+                            label: "Close"
+                            onClicked: browserSection.browser.close()
+                        }
+                    }
+
+                    ListView {
+                        id: browserList
+                        Layout.fillWidth: true
+                        Layout.fillHeight: true
+                        clip: true
+                        model: browserSection.browser
+                        // Fixed-height rows: the view never has to measure decoded rows
+                        reuseItems: true
+                        boundsBehavior: Flickable.StopAtBounds
+                        ScrollBar.vertical: ScrollBar { policy: ScrollBar.AsNeeded }
+
+                        delegate: Text {
+                            required property string timeText
+                            required property int busId
+                            required property string canIdText
+                            required property int dlc
+                            required property string dataHex
+                            width: browserList.width
+                            height: HMI.Theme.px(24)
+                            text: timeText.padStart(14) + "  " + busId + "  " + canIdText.padStart(8) + "  [" + dlc + "]  " + dataHex
+                            color: HMI.Theme.text
+                            font.pixelSize: HMI.Theme.px(14)
+                            font.family: "monospace"
+                            verticalAlignment: Text.AlignVCenter
+                            elide: Text.ElideRight
+                        }
+                    }
+                }
+            }
+
+            // ——— CAN Signals ——— (live DBC decode, see Settings → CAN DBC File)
+            Rectangle {
+                id: signalsSection
+                readonly property bool available: typeof CanSignalsBackend !== "undefined" && CanSignalsBackend.loaded
+                visible: available
+                Layout.fillWidth: true
+                Layout.preferredHeight: HMI.Theme.px(420)
+                radius: HMI.Theme.px(18)
+                color: HMI.Theme.center
+                border.color: HMI.Theme.outline
+                border.width: 1
+                clip: true
+
+                ColumnLayout {
+                    anchors.fill: parent
+                    anchors.margins: HMI.Theme.px(16)
+                    spacing: HMI.Theme.px(10)
+
+                    RowLayout {
+                        Layout.fillWidth: true
+                        spacing: HMI.Theme.px(10)
+
+                        Label {
+                            text: "CAN Signals"
+                            color: HMI.Theme.text
+                            font.pixelSize: HMI.Theme.px(24)
+                            font.bold: true
+                            Layout.fillWidth: true
+                        }
+                        Label {
+                            text: signalsSection.available
+                                  ? (CanSignalsBackend.decodedFrames + " decoded • " + CanSignalsBackend.unknownFrames + " unknown")
+                                  : ""
+                            color: HMI.Theme.sub
+                            font.pixelSize: HMI.Theme.px(14)
+                        }
+                    }
+
+                    ListView {
+                        id: signalsList
+                        Layout.fillWidth: true
+                        Layout.fillHeight: true
+                        clip: true
+                        model: signalsSection.available ? CanSignalsBackend.model : null
+                        reuseItems: true
+                        boundsBehavior: Flickable.StopAtBounds
+                        ScrollBar.vertical: ScrollBar { policy: ScrollBar.AsNeeded }
+
+                        delegate: Text {
+                            required property string message
+                            required property string name
+                            required property string valueText
+                            required property string unit
+                            required property bool seen
+                            width: signalsList.width
+                            height: HMI.Theme.px(24)
+                            text: (message + "." + name).padEnd(40) + "  " + valueText.padStart(14) + " " + unit
+                            color: seen ? HMI.Theme.text : HMI.Theme.sub
+                            font.pixelSize: HMI.Theme.px(14)
+                            font.family: "monospace"
+                            verticalAlignment: Text.AlignVCenter
+                            elide: Text.ElideRight
+                        }
+                    }
+                }
+            }
+
+            // ——— Bus Statistics ——— (per-ID rate / period / jitter, estimated bus load)
+            Rectangle {
+                id: statsSection
+                readonly property var stats: typeof CanStatsBackend !== "undefined" ? CanStatsBackend : null
+                visible: stats !== null
+                Layout.fillWidth: true
+                Layout.preferredHeight: HMI.Theme.px(420)
+                radius: HMI.Theme.px(18)
+                color: HMI.Theme.center
+                border.color: HMI.Theme.outline
+                border.width: 1
+                clip: true
+
+                ColumnLayout {
+                    anchors.fill: parent
+                    anchors.margins: HMI.Theme.px(16)
+                    spacing: HMI.Theme.px(10)
+
+                    RowLayout {
+                        Layout.fillWidth: true
+                        spacing: HMI.Theme.px(10)
+
+                        Label {
+                            text: "Bus Statistics"
+                            color: HMI.Theme.text
+                            font.pixelSize: HMI.Theme.px(24)
+                            font.bold: true
+                        }
+                        // Estimated load per bus
+                        Repeater {
+                            model: ["HS", "CE", "SC", "LS"]
+                            delegate: Label {
+                                required property string modelData
+                                required property int index
+                                readonly property real load: statsSection.stats ? statsSection.stats.busLoad[index] : 0
+                                text: modelData + " " + load.toFixed(1) + "%"
+                                color: load >= 80 ? "#C62828" : load >= 50 ? "#F9A825" : HMI.Theme.sub
+                                font.pixelSize: HMI.Theme.px(14)
+                                font.family: "monospace"
+                            }
+                        }
+                        Item { Layout.fillWidth: true }
+                        Repeater {
+                            model: [["ID", "id"], ["Rate", "rate"], ["Jitter", "jitter"], ["Age", "age"]]
+                            delegate: FormatChip {
+                                required property var modelData
+                                label: modelData[0]
+                                checked: statsSection.stats && statsSection.stats.model.sortKey === modelData[1]
+                                onClicked: statsSection.stats.model.sortKey = modelData[1]
+                            }
+                        }
+                        FormatChip {
+                            label: "Reset"
+                            onClicked: statsSection.stats.reset()
+                        }
+                    }
+
+                    ListView {
+                        id: statsList
+                        Layout.fillWidth: true
+                        Layout.fillHeight: true
+                        clip: true
+                        model: statsSection.stats ? statsSection.stats.model : null
+                        reuseItems: true
+                        boundsBehavior: Flickable.StopAtBounds
+                        ScrollBar.vertical: ScrollBar { policy: ScrollBar.AsNeeded }
+
+                        delegate: Text {
+                            required property int busId
+                            required property string canIdText
+                            required property var count
+                            required property real rate
+                            required property real periodMs
+                            required property real jitterMs
+                            required property var ageMs
+                            required property bool silent
+                            required property string dataHex
+                            width: statsList.width
+                            height: HMI.Theme.px(24)
+                            text: busId + "  " + canIdText.padStart(8) + "  " + String(count).padStart(9)
+                                  + "  " + rate.toFixed(1).padStart(8) + "/s  " + periodMs.toFixed(1).padStart(8) + " ms  ±"
+                                  + jitterMs.toFixed(2).padStart(7) + "  " + dataHex
+                            color: silent ? "#C62828" : HMI.Theme.text
+                            font.pixelSize: HMI.Theme.px(14)
+                            font.family: "monospace"
+                            verticalAlignment: Text.AlignVCenter
+                            elide: Text.ElideRight
+                        }
+                    }
+                }
+            }
+
             // ——— Intel Logs ———
             Rectangle {
                 Layout.fillWidth: true
@@ -356,7 +665,7 @@ Item {
                         Layout.fillHeight: true
                         Layout.minimumHeight: HMI.Theme.px(120)
                         clip: true
-                        model: IntelLogsBackend ? IntelLogsBackend.logFileNames : []
+                        model: IntelLogsBackend ? IntelLogsBackend.logFiles : null
                         spacing: HMI.Theme.px(4)
                         boundsBehavior: Flickable.DragAndOvershootBounds
                         flickDeceleration: 3000
@@ -364,6 +673,12 @@ Item {
                         ScrollBar.vertical: ScrollBar { policy: ScrollBar.AlwaysOff }
 
                         delegate: Rectangle {
+                            required property string fileName
+                            required property string durationText
+                            required property var events
+                            required property string sizeText
+                            required property bool backedUp
+
                             width: intelSavedLogsList.width - HMI.Theme.px(2)
                             height: HMI.Theme.px(36)
                             radius: HMI.Theme.px(8)
@@ -371,15 +686,24 @@ Item {
                             border.color: HMI.Theme.outline
                             border.width: 1
 
-                            Text {
+                            RowLayout {
                                 anchors.fill: parent
                                 anchors.margins: HMI.Theme.px(8)
-                                text: modelData
-                                color: HMI.Theme.text
-                                font.pixelSize: HMI.Theme.px(14)
-                                font.family: "monospace"
-                                verticalAlignment: Text.AlignVCenter
-                                elide: Text.ElideRight
+                                spacing: HMI.Theme.px(8)
+
+                                Text {
+                                    text: fileName
+                                    color: HMI.Theme.text
+                                    font.pixelSize: HMI.Theme.px(14)
+                                    font.family: "monospace"
+                                    elide: Text.ElideRight
+                                    Layout.fillWidth: true
+                                }
+                                Text {
+                                    text: root.logFileDetails(durationText, events, sizeText, backedUp, "lines")
+                                    color: HMI.Theme.sub
+                                    font.pixelSize: HMI.Theme.px(12)
+                                }
                             }
                         }
                     }
@@ -388,7 +712,14 @@ Item {
                         Layout.fillWidth: true
                         spacing: HMI.Theme.px(10)
 
-                        Item { Layout.fillWidth: true } // spacer
+                        // Last save failure (disk full, quota); the spacer otherwise
+                        Label {
+                            text: IntelLogsBackend ? IntelLogsBackend.lastSaveError : ""
+                            color: "#C62828"
+                            font.pixelSize: HMI.Theme.px(14)
+                            wrapMode: Text.WordWrap
+                            Layout.fillWidth: true
+                        }
 
                         RecordControlButton {
                             iconSource: "../src/icons/discard.svg"
@@ -403,10 +734,8 @@ Item {
                             highlighted: false
                             enabled: IntelLogsBackend !== undefined && IntelLogsBackend
                             onClicked: {
-                                if (IntelLogsBackend) {
+                                if (IntelLogsBackend)
                                     IntelLogsBackend.saveLogs()
-                                    IntelLogsBackend.refreshLogList()
-                                }
                             }
                         }
                         RecordControlButton {
@@ -417,7 +746,6 @@ Item {
                             onClicked: {
                                 if (!IntelLogsBackend || typeof LogBackupBackend === "undefined") return
                                 IntelLogsBackend.saveLogs()
-                                IntelLogsBackend.refreshLogList()
                                 LogBackupBackend.startBackupFolder(IntelLogsBackend.logsDir, "Intel")
                             }
                         }
@@ -498,6 +826,42 @@ Item {
         Behavior on border.color { ColorAnimation { duration: 120 } }
     }
 
+    // Small toggle chip for the recording format selector
+    component FormatChip: Rectangle {
+        id: chip
+        property string label: ""
+        property bool checked: false
+        property bool enabled: true
+        property bool toggle: false   // clickable while checked (on/off chip rather than one-of-N)
+        signal clicked()
+
+        implicitWidth: chipText.implicitWidth + HMI.Theme.px(24)
+        implicitHeight: HMI.Theme.px(34)
+        radius: HMI.Theme.px(10)
+        opacity: chip.enabled ? 1.0 : 0.5
+        color: checked ? HMI.Theme.accent : (chipMouse.pressed ? Qt.darker(HMI.Theme.surface, 1.2) : HMI.Theme.surface)
+        border.color: checked ? HMI.Theme.accent : HMI.Theme.outline
+        border.width: 1
+
+        Text {
+            id: chipText
+            anchors.centerIn: parent
+            text: chip.label
+            color: chip.checked ? "#FFFFFF" : HMI.Theme.text
+            font.pixelSize: HMI.Theme.px(14)
+            font.bold: chip.checked
+        }
+
+        MouseArea {
+            id: chipMouse
+            anchors.fill: parent
+            cursorShape: Qt.PointingHandCursor
+            onClicked: if (chip.enabled && (chip.toggle || !chip.checked)) chip.clicked()
+        }
+
+        Behavior on color { ColorAnimation { duration: 120 } }
+    }
+
     // Record control button (icon + optional label)
     component RecordControlButton: Rectangle {
         id: btn
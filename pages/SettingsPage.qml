@@ -87,6 +87,13 @@ Item {
                         note: "Controls stream. Save and restart to apply."
                     }
 
+                    SettingRow {
+                        label: "RX Transport"
+                        value: settings.rxTransport
+                        onValueEdited: (value) => { settings.rxTransport = value }
+                        note: "tcp, udp (cameras need tcp) or shm (same host). Save and restart to apply."
+                    }
+
                     SettingRow {
                         label: "RX Port (Perception)"
                         value: String(settings.rxPortPerception)
@@ -100,6 +107,20 @@ Item {
                         note: "Perception stream. Save and restart to apply."
                     }
 
+                    SettingRow {
+                        label: "RX Transport (Perception)"
+                        value: settings.rxTransportPerception
+                        onValueEdited: (value) => { settings.rxTransportPerception = value }
+                        note: "tcp, udp or shm (same host). Save and restart to apply."
+                    }
+
+                    SettingRow {
+                        label: "RX Multicast Group"
+                        value: settings.rxMulticastGroup
+                        onValueEdited: (value) => { settings.rxMulticastGroup = value }
+                        note: "UDP streams only; empty for unicast (e.g. 239.1.1.1)"
+                    }
+
                     SettingRow {
                         label: "RX Port (Logger)"
                         value: String(settings.rxPortLogger)
@@ -113,6 +134,43 @@ Item {
                         note: "CAN batch stream. Save and restart to apply."
                     }
 
+                    SettingRow {
+                        label: "RX Transport (Logger)"
+                        value: settings.rxTransportLogger
+                        onValueEdited: (value) => { settings.rxTransportLogger = value }
+                        note: "tcp or shm (same host). Save and restart to apply."
+                    }
+
+                    SettingRow {
+                        label: "CAN Log ID Filter"
+                        value: LoggerBackend.idFilter
+                        onValueEdited: (value) => { LoggerBackend.idFilter = value }
+                        note: LoggerBackend.idFilterError !== "" ? ("Rejected: " + LoggerBackend.idFilterError)
+                              : "Hex IDs, ranges (100-1FF), masks (18FF0000/1FFF0000), bus prefix (HS:7DF), !exclude. Empty logs all."
+                    }
+
+                    SettingRow {
+                        label: "CAN Pre-trigger (s)"
+                        value: String(LoggerBackend.preTriggerSeconds)
+                        onValueEdited: (value) => {
+                            var seconds = parseInt(value)
+                            if (!isNaN(seconds)) LoggerBackend.preTriggerSeconds = seconds
+                        }
+                        inputType: "number"
+                        minValue: 0
+                        maxValue: 600
+                        note: "History written at the start of each recording; 0 disables"
+                    }
+
+                    SettingRow {
+                        label: "CAN DBC File"
+                        value: CanSignalsBackend.dbcPath
+                        onValueEdited: (value) => { CanSignalsBackend.dbcPath = value }
+                        note: CanSignalsBackend.errorString !== "" ? ("Not loaded: " + CanSignalsBackend.errorString)
+                              : CanSignalsBackend.loaded ? (CanSignalsBackend.messageCount + " messages, " + CanSignalsBackend.signalCount + " signals")
+                              : "Path to a .dbc file; decoded signals appear on the Logger page."
+                    }
+
                     SettingRow {
                         label: "GNSS Timeout (ms)"
                         value: String(settings.gnssTimeout)
@@ -124,6 +182,22 @@ Item {
                         minValue: 100
                         maxValue: 10000
                     }
+
+                    SettingRow {
+                        label: "Latest-only Navigation"
+                        value: settings.rxConflateNavigation ? "true" : "false"
+                        onValueEdited: (value) => { settings.rxConflateNavigation = (value === "true") }
+                        inputType: "toggle"
+                        note: "Skip stale poses when the UI falls behind"
+                    }
+
+                    SettingRow {
+                        label: "Latest-only Perception"
+                        value: settings.rxConflatePerception ? "true" : "false"
+                        onValueEdited: (value) => { settings.rxConflatePerception = (value === "true") }
+                        inputType: "toggle"
+                        note: "Skip stale frames when the UI falls behind"
+                    }
                 }
             }
 
@@ -0,0 +1,142 @@
+#include "CanIdFilter.h"
+#include <QRegularExpression>
+#include <QStringList>
+#include <algorithm>
+
+namespace {
+
+constexpr quint32 kMaxExtendedId = 0x1FFFFFFF;
+
+bool parseHex(QStringView s, quint32& v)
+{
+    if (s.startsWith(u"0x", Qt::CaseInsensitive))
+        s = s.mid(2);
+    bool ok = false;
+    const qulonglong n = s.toULongLong(&ok, 16);
+    if (!ok || n > kMaxExtendedId) return false;
+    v = static_cast<quint32>(n);
+    return true;
+}
+
+int parseBus(QStringView s)
+{
+    static const char* const names[CanIdFilter::kBuses] = { "HS", "CE", "SC", "LS" };
+    for (int i = 0; i < CanIdFilter::kBuses; ++i) {
+        if (s.compare(QLatin1String(names[i]), Qt::CaseInsensitive) == 0 || s == QString::number(i))
+            return i;
+    }
+    return -1;
+}
+
+} // namespace
+
+bool CanIdFilter::Set::matchesExtended(quint32 id) const
+{
+    // Last range starting at or below id
+    auto it = std::upper_bound(ranges.begin(), ranges.end(), id,
+                               [](quint32 v, const std::pair<quint32, quint32>& r) { return v < r.first; });
+    if (it != ranges.begin() && id <= std::prev(it)->second)
+        return true;
+    for (const auto& m : masks) {
+        if ((id & m.second) == m.first)
+            return true;
+    }
+    return false;
+}
+
+void CanIdFilter::Set::addRange(quint32 lo, quint32 hi)
+{
+    for (quint32 id = lo; id <= qMin<quint32>(hi, 0x7FF); ++id)
+        standard.set(id);
+    ranges.emplace_back(lo, hi);
+}
+
+void CanIdFilter::Set::addMask(quint32 value, quint32 mask)
+{
+    for (quint32 id = 0; id <= 0x7FF; ++id) {
+        if ((id & mask) == (value & mask))
+            standard.set(id);
+    }
+    masks.emplace_back(value & mask, mask);
+}
+
+void CanIdFilter::Set::finish()
+{
+    std::sort(ranges.begin(), ranges.end());
+    std::vector<std::pair<quint32, quint32>> merged;
+    for (const auto& r : ranges) {
+        if (!merged.empty() && r.first <= merged.back().second + 1)
+            merged.back().second = qMax(merged.back().second, r.second);
+        else
+            merged.push_back(r);
+    }
+    ranges.swap(merged);
+    std::sort(masks.begin(), masks.end());
+    masks.erase(std::unique(masks.begin(), masks.end()), masks.end());
+}
+
+bool CanIdFilter::compile(const QString& expression, QString* error)
+{
+    Table tables[kBuses];
+    bool any = false;
+
+    static const QRegularExpression separators(QStringLiteral("[,;\\s]+"));
+    const QStringList terms = expression.split(separators, Qt::SkipEmptyParts);
+    for (const QString& term : terms) {
+        QStringView t(term);
+        const bool exclude = t.startsWith(u'!');
+        if (exclude)
+            t = t.mid(1);
+
+        int bus = -1;
+        const qsizetype colon = t.indexOf(u':');
+        if (colon >= 0) {
+            bus = parseBus(t.left(colon));
+            if (bus < 0) {
+                if (error) *error = QStringLiteral("unknown bus in \"%1\"").arg(term);
+                return false;
+            }
+            t = t.mid(colon + 1);
+        }
+
+        quint32 lo = 0, hi = 0, mask = 0;
+        bool isMask = false;
+        const qsizetype dash = t.indexOf(u'-');
+        const qsizetype slash = t.indexOf(u'/');
+        bool ok;
+        if (dash >= 0) {
+            ok = parseHex(t.left(dash), lo) && parseHex(t.mid(dash + 1), hi) && lo <= hi;
+        } else if (slash >= 0) {
+            ok = parseHex(t.left(slash), lo) && parseHex(t.mid(slash + 1), mask);
+            isMask = true;
+        } else {
+            ok = parseHex(t, lo);
+            hi = lo;
+        }
+        if (!ok) {
+            if (error) *error = QStringLiteral("bad ID term \"%1\"").arg(term);
+            return false;
+        }
+
+        for (int b = 0; b < kBuses; ++b) {
+            if (bus >= 0 && b != bus) continue;
+            Set& set = exclude ? tables[b].exclude : tables[b].include;
+            if (isMask)
+                set.addMask(lo, mask);
+            else
+                set.addRange(lo, hi);
+            if (!exclude)
+                tables[b].hasIncludes = true;
+        }
+        any = true;
+    }
+
+    for (Table& t : tables) {
+        t.include.finish();
+        t.exclude.finish();
+    }
+    std::copy(std::begin(tables), std::end(tables), std::begin(m_tables));
+    m_empty = !any;
+    if (error) error->clear();
+    return true;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+#include <bitset>
+#include <vector>
+
+// CAN-ID filter for recording, compiled from a short expression into per-bus lookup tables.
+//
+//   terms are separated by commas, semicolons or spaces; IDs and masks are hexadecimal ("0x" optional)
+//   123            one ID
+//   100-1FF        an inclusive range
+//   18FF0000/1FFF0000   value/mask: matches when (id & mask) == (value & mask)
+//   HS:7DF         restrict a term to one bus (HS, CE, SC, LS or 0..3); otherwise it applies to all
+//   !123           exclude (takes precedence over includes)
+//
+// An empty expression, or one with only exclusions, passes everything not excluded. Standard
+// (11-bit) IDs resolve with one bitset test; extended IDs go through sorted ranges and masks.
+class CanIdFilter
+{
+public:
+    static constexpr int kBuses = 4;
+
+    // Replaces the filter with `expression`; on a syntax error the filter is left unchanged.
+    bool compile(const QString& expression, QString* error = nullptr);
+    bool isEmpty() const { return m_empty; }
+
+    bool accepts(quint32 busId, quint32 canId, bool extended) const
+    {
+        if (m_empty) return true;
+        if (busId >= kBuses) return false;
+        const Table& t = m_tables[busId];
+        if (extended) {
+            if (t.exclude.matchesExtended(canId)) return false;
+            return !t.hasIncludes || t.include.matchesExtended(canId);
+        }
+        const quint32 id = canId & 0x7FF;
+        if (t.exclude.standard.test(id)) return false;
+        return !t.hasIncludes || t.include.standard.test(id);
+    }
+
+private:
+    struct Set
+    {
+        std::bitset<2048> standard;
+        std::vector<std::pair<quint32, quint32>> ranges;   // extended; sorted, disjoint, inclusive
+        std::vector<std::pair<quint32, quint32>> masks;    // extended; (value & mask, mask)
+
+        bool matchesExtended(quint32 id) const;
+        void addRange(quint32 lo, quint32 hi);
+        void addMask(quint32 value, quint32 mask);
+        void finish();   // sorts and merges the ranges
+    };
+    struct Table
+    {
+        Set include;
+        Set exclude;
+        bool hasIncludes = false;
+    };
+
+    Table m_tables[kBuses];
+    bool m_empty = true;
+};
@@ -0,0 +1,234 @@
+#include "CanLogBrowserModel.h"
+#include "CanLogIndex.h"
+#include "LogBlockFile.h"
+#include <QDebug>
+#include <QFileInfo>
+#include <climits>
+#include <cstring>
+
+CanLogBrowserModel::CanLogBrowserModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+    m_scanTimer.setInterval(0);
+    connect(&m_scanTimer, &QTimer::timeout, this, &CanLogBrowserModel::scanStep);
+}
+
+int CanLogBrowserModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_rows;
+}
+
+QHash<int, QByteArray> CanLogBrowserModel::roleNames() const
+{
+    return {
+        { BusIdRole, "busId" },
+        { CanIdRole, "canId" },
+        { CanIdTextRole, "canIdText" },
+        { ExtendedRole, "extended" },
+        { RtrRole, "rtr" },
+        { TsNsRole, "tsNs" },
+        { TimeTextRole, "timeText" },
+        { DlcRole, "dlc" },
+        { DataHexRole, "dataHex" },
+    };
+}
+
+QVariant CanLogBrowserModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_rows)
+        return {};
+
+    CanLog::Record r;
+    if (!decodeRow(index.row(), r))
+        return {};
+
+    const bool extended = (r.flags & CanLog::kFlagExtended) != 0;
+    switch (role) {
+    case BusIdRole:
+        return r.busId;
+    case CanIdRole:
+        return r.canId;
+    case CanIdTextRole:
+        return QStringLiteral("%1").arg(r.canId, extended ? 8 : 3, 16, QLatin1Char('0')).toUpper();
+    case ExtendedRole:
+        return extended;
+    case RtrRole:
+        return (r.flags & CanLog::kFlagRtr) != 0;
+    case TsNsRole:
+        return static_cast<qint64>(r.tsNs);
+    case TimeTextRole: {
+        const qint64 rel = static_cast<qint64>(r.tsNs - m_baseTsNs);
+        const qint64 us = rel / 1000;
+        return QStringLiteral("%1.%2").arg(us / 1000000).arg(qAbs(us % 1000000), 6, 10, QLatin1Char('0'));
+    }
+    case DlcRole:
+        return r.dlc;
+    case DataHexRole:
+        return QString::fromLatin1(QByteArray(reinterpret_cast<const char*>(r.data), qMin<int>(r.dlc, 8)).toHex(' '));
+    default:
+        return {};
+    }
+}
+
+bool CanLogBrowserModel::open(const QString& path)
+{
+    close();
+    m_fileName = QFileInfo(path).fileName();
+
+    if (path.endsWith("." + LogBlock::fileSuffix())) {
+        setError(QStringLiteral("compressed recordings cannot be browsed"));
+        return false;
+    }
+
+    if (path.endsWith("." + CanLog::fileSuffix())) {
+        if (!m_reader.open(path)) {
+            setError(m_reader.errorString());
+            return false;
+        }
+        m_binary = true;
+        beginResetModel();
+        m_rows = static_cast<int>(qMin<qint64>(m_reader.count(), INT_MAX));
+        CanLog::Record first;
+        if (m_reader.record(0, first))
+            m_baseTsNs = first.tsNs;
+        endResetModel();
+        emit fileChanged();
+        emit countChanged();
+        return true;
+    }
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        setError(m_file.errorString());
+        return false;
+    }
+    m_size = m_file.size();
+    m_map = m_size > 0 ? m_file.map(0, m_size) : nullptr;
+    if (!m_map) {
+        setError(m_size > 0 ? m_file.errorString() : QStringLiteral("empty file"));
+        m_file.close();
+        return false;
+    }
+
+    // Skip the header line; data rows start after it
+    m_scanPos = 0;
+    if (m_size >= 6 && std::memcmp(m_map, "bus_id", 6) == 0) {
+        const void* nl = std::memchr(m_map, '\n', static_cast<size_t>(m_size));
+        m_scanPos = nl ? (static_cast<const uchar*>(nl) - m_map) + 1 : m_size;
+    }
+    m_anchors.clear();
+    emit fileChanged();
+    m_scanTimer.start();
+    emit indexingChanged();
+    scanStep();
+    return true;
+}
+
+void CanLogBrowserModel::close()
+{
+    const bool wasIndexing = m_scanTimer.isActive();
+    m_scanTimer.stop();
+    beginResetModel();
+    m_rows = 0;
+    m_baseTsNs = 0;
+    m_reader.close();
+    m_binary = false;
+    if (m_map)
+        m_file.unmap(const_cast<uchar*>(m_map));
+    m_map = nullptr;
+    if (m_file.isOpen())
+        m_file.close();
+    m_size = 0;
+    m_scanPos = 0;
+    m_anchors.clear();
+    m_cacheRow = -1;
+    endResetModel();
+    if (!m_fileName.isEmpty() || !m_error.isEmpty()) {
+        m_fileName.clear();
+        m_error.clear();
+        emit fileChanged();
+    }
+    emit countChanged();
+    if (wasIndexing)
+        emit indexingChanged();
+}
+
+void CanLogBrowserModel::setError(const QString& error)
+{
+    qWarning() << "CanLogBrowserModel:" << m_fileName << error;
+    m_error = error;
+    emit fileChanged();
+}
+
+void CanLogBrowserModel::scanStep()
+{
+    // Count complete lines in the next slice; rows appear as they are found
+    const qint64 end = qMin(m_size, m_scanPos + kScanBytesPerStep);
+    int rows = m_rows;
+    qint64 pos = m_scanPos;
+    while (pos < end && rows < INT_MAX) {
+        const void* nl = std::memchr(m_map + pos, '\n', static_cast<size_t>(m_size - pos));
+        if (!nl) {
+            pos = m_size;   // trailing partial line (interrupted recording) is not a row
+            break;
+        }
+        if (rows % kAnchorStride == 0)
+            m_anchors.append(pos);
+        ++rows;
+        pos = (static_cast<const uchar*>(nl) - m_map) + 1;
+    }
+    m_scanPos = pos;
+
+    if (rows > m_rows) {
+        const bool first = m_rows == 0;
+        beginInsertRows(QModelIndex(), m_rows, rows - 1);
+        m_rows = rows;
+        endInsertRows();
+        if (first) {
+            CanLog::Record r;
+            if (decodeRow(0, r))
+                m_baseTsNs = r.tsNs;
+        }
+        emit countChanged();
+    }
+    if (m_scanPos >= m_size || m_rows == INT_MAX) {
+        m_scanTimer.stop();
+        emit indexingChanged();
+    }
+}
+
+qint64 CanLogBrowserModel::csvLineOffset(int row) const
+{
+    // Walk forward from the nearest known line: the row's anchor, or the last row read if closer
+    int at = (row / kAnchorStride) * kAnchorStride;
+    qint64 offset = m_anchors.at(row / kAnchorStride);
+    if (m_cacheRow >= at && m_cacheRow <= row) {
+        at = m_cacheRow;
+        offset = m_cacheOffset;
+    }
+    for (; at < row; ++at) {
+        const void* nl = std::memchr(m_map + offset, '\n', static_cast<size_t>(m_size - offset));
+        if (!nl) return -1;
+        offset = (static_cast<const uchar*>(nl) - m_map) + 1;
+    }
+    m_cacheRow = row;
+    m_cacheOffset = offset;
+    return offset;
+}
+
+bool CanLogBrowserModel::decodeRow(int row, CanLog::Record& r) const
+{
+    if (m_binary)
+        return m_reader.record(row, r);
+    if (!m_map || row / kAnchorStride >= m_anchors.size())
+        return false;
+    const qint64 offset = csvLineOffset(row);
+    if (offset < 0)
+        return false;
+    const char* begin = reinterpret_cast<const char*>(m_map + offset);
+    const void* nl = std::memchr(begin, '\n', static_cast<size_t>(m_size - offset));
+    const char* end = nl ? static_cast<const char*>(nl) : reinterpret_cast<const char*>(m_map + m_size);
+    return CanLogIndex::parseCsvLine(begin, end, r);
+}
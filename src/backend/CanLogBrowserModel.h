@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QFile>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+#include "CanLogFormat.h"
+
+// Read-only view of one CAN recording for LoggerPage. The file is memory-mapped and rows are decoded
+// only when the view asks for them, so opening costs nothing up front and memory stays flat however
+// long the recording is. .canb records are addressed directly; CSV lines are found through a sparse
+// line index (one offset per kAnchorStride lines) built in the background, with rows appearing as
+// the scan advances.
+class CanLogBrowserModel final : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QString fileName READ fileName NOTIFY fileChanged)
+    Q_PROPERTY(QString errorString READ errorString NOTIFY fileChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(bool indexing READ indexing NOTIFY indexingChanged)
+
+public:
+    enum Roles {
+        BusIdRole = Qt::UserRole + 1,
+        CanIdRole,
+        CanIdTextRole,
+        ExtendedRole,
+        RtrRole,
+        TsNsRole,
+        TimeTextRole,   // seconds since the first row, "s.uuuuuu"
+        DlcRole,
+        DataHexRole
+    };
+
+    explicit CanLogBrowserModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    QString fileName() const { return m_fileName; }
+    QString errorString() const { return m_error; }
+    int count() const { return m_rows; }
+    bool indexing() const { return m_scanTimer.isActive(); }
+
+    // Uncompressed .csv and .canb recordings; block-compressed (.hbz) files are not mappable.
+    Q_INVOKABLE bool open(const QString& path);
+    Q_INVOKABLE void close();
+
+signals:
+    void fileChanged();
+    void countChanged();
+    void indexingChanged();
+
+private slots:
+    void scanStep();
+
+private:
+    static constexpr int kAnchorStride = 1024;
+    static constexpr qint64 kScanBytesPerStep = 16 * 1024 * 1024;
+
+    bool decodeRow(int row, CanLog::Record& r) const;
+    qint64 csvLineOffset(int row) const;
+    void setError(const QString& error);
+
+    QString m_fileName;
+    QString m_error;
+    int m_rows = 0;
+    quint64 m_baseTsNs = 0;
+
+    // .canb
+    bool m_binary = false;
+    CanLogReader m_reader;
+
+    // CSV
+    QFile m_file;
+    const uchar* m_map = nullptr;
+    qint64 m_size = 0;
+    qint64 m_scanPos = 0;           // next byte to scan for line ends
+    QVector<qint64> m_anchors;      // offset of line k * kAnchorStride
+    QTimer m_scanTimer;
+    mutable int m_cacheRow = -1;    // last decoded row and its offset: sequential reads skip the walk
+    mutable qint64 m_cacheOffset = 0;
+};
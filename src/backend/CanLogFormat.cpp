@@ -0,0 +1,197 @@
+#include "CanLogFormat.h"
+#include <QtEndian>
+#include <cstring>
+
+namespace CanLog {
+
+QByteArray makeHeader(qint64 startEpochMs)
+{
+    QByteArray h(kHeaderBytes, '\0');
+    uchar* p = reinterpret_cast<uchar*>(h.data());
+    std::memcpy(p, kMagic, sizeof(kMagic));
+    qToLittleEndian<quint16>(kVersion, p + 8);
+    qToLittleEndian<quint16>(kHeaderBytes, p + 10);
+    qToLittleEndian<quint16>(kRecordBytes, p + 12);
+    qToLittleEndian<qint64>(startEpochMs, p + 16);
+    return h;
+}
+
+void appendRecord(QByteArray& out, const can_stream::CanEvent& e)
+{
+    const qsizetype at = out.size();
+    out.resize(at + kRecordBytes);
+    encodeRecord(reinterpret_cast<uchar*>(out.data() + at), e);
+}
+
+void encodeRecord(uchar* p, const can_stream::CanEvent& e)
+{
+    qToLittleEndian<quint64>(e.ts_ns(), p);
+    qToLittleEndian<quint32>(e.can_id(), p + 8);
+    p[12] = static_cast<quint8>(e.bus_id());
+    p[13] = static_cast<quint8>((e.is_extended() ? kFlagExtended : 0) | (e.is_rtr() ? kFlagRtr : 0));
+    p[14] = static_cast<quint8>(qMin<quint32>(e.dlc(), 8));
+    p[15] = 0;
+    const std::string& data = e.data();
+    const size_t n = qMin<size_t>(data.size(), 8);
+    std::memcpy(p + 16, data.data(), n);
+    std::memset(p + 16 + n, 0, 8 - n);
+}
+
+void decodeRecord(const uchar* p, Record& r)
+{
+    r.tsNs = qFromLittleEndian<quint64>(p);
+    r.canId = qFromLittleEndian<quint32>(p + 8);
+    r.busId = p[12];
+    r.flags = p[13];
+    r.dlc = p[14];
+    std::memcpy(r.data, p + 16, 8);
+}
+
+QByteArray csvHeader()
+{
+    return QByteArrayLiteral("bus_id,can_id,is_extended,is_rtr,ts_ns,dlc,data_hex\n");
+}
+
+namespace {
+
+// "000102...ff": two characters per byte value
+struct HexTable
+{
+    char pairs[512];
+    constexpr HexTable() : pairs()
+    {
+        constexpr char digits[] = "0123456789abcdef";
+        for (int i = 0; i < 256; ++i) {
+            pairs[2 * i] = digits[i >> 4];
+            pairs[2 * i + 1] = digits[i & 0xF];
+        }
+    }
+};
+constexpr HexTable kHex;
+
+// "00".."99": two decimal digits per call halves the divisions
+struct DecTable
+{
+    char pairs[200];
+    constexpr DecTable() : pairs()
+    {
+        for (int i = 0; i < 100; ++i) {
+            pairs[2 * i] = static_cast<char>('0' + i / 10);
+            pairs[2 * i + 1] = static_cast<char>('0' + i % 10);
+        }
+    }
+};
+constexpr DecTable kDec;
+
+inline char* writeDecimal(char* p, quint64 v)
+{
+    char tmp[20];
+    char* t = tmp + sizeof(tmp);
+    while (v >= 100) {
+        const unsigned r = static_cast<unsigned>(v % 100);
+        v /= 100;
+        t -= 2;
+        std::memcpy(t, kDec.pairs + 2 * r, 2);
+    }
+    if (v >= 10) {
+        t -= 2;
+        std::memcpy(t, kDec.pairs + 2 * v, 2);
+    } else {
+        *--t = static_cast<char>('0' + v);
+    }
+    const size_t n = static_cast<size_t>(tmp + sizeof(tmp) - t);
+    std::memcpy(p, t, n);
+    return p + n;
+}
+
+} // namespace
+
+void appendCsvLine(QByteArray& out, const can_stream::CanEvent& e)
+{
+    // Worst case: 3 u32 + 1 u64 in decimal (50), 2 flags, 6 commas, newline, 3 chars per data byte
+    const std::string& data = e.data();
+    const qsizetype at = out.size();
+    out.resize(at + 64 + 3 * static_cast<qsizetype>(data.size()));
+    char* const begin = out.data() + at;
+    char* p = begin;
+
+    p = writeDecimal(p, e.bus_id());
+    *p++ = ',';
+    p = writeDecimal(p, e.can_id());
+    *p++ = ',';
+    *p++ = e.is_extended() ? '1' : '0';
+    *p++ = ',';
+    *p++ = e.is_rtr() ? '1' : '0';
+    *p++ = ',';
+    p = writeDecimal(p, e.ts_ns());
+    *p++ = ',';
+    p = writeDecimal(p, e.dlc());
+    *p++ = ',';
+    const uchar* d = reinterpret_cast<const uchar*>(data.data());
+    for (size_t i = 0; i < data.size(); ++i) {
+        if (i) *p++ = ' ';
+        std::memcpy(p, kHex.pairs + 2 * d[i], 2);
+        p += 2;
+    }
+    *p++ = '\n';
+
+    out.resize(at + (p - begin));
+}
+
+} // namespace CanLog
+
+bool CanLogReader::open(const QString& path)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_size = m_file.size();
+    if (m_size < CanLog::kHeaderBytes) {
+        m_error = QStringLiteral("not a binary CAN log (too short)");
+        m_file.close();
+        return false;
+    }
+    m_map = m_file.map(0, m_size);
+    if (!m_map) {
+        m_error = m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    m_version = qFromLittleEndian<quint16>(m_map + 8);
+    m_headerBytes = qFromLittleEndian<quint16>(m_map + 10);
+    m_recordBytes = qFromLittleEndian<quint16>(m_map + 12);
+    if (std::memcmp(m_map, CanLog::kMagic, sizeof(CanLog::kMagic)) != 0
+        || m_headerBytes < CanLog::kHeaderBytes || m_recordBytes < CanLog::kRecordBytes
+        || m_headerBytes > m_size) {
+        m_error = QStringLiteral("not a binary CAN log or unsupported layout");
+        close();
+        return false;
+    }
+    m_startEpochMs = qFromLittleEndian<qint64>(m_map + 16);
+    m_count = (m_size - m_headerBytes) / m_recordBytes;
+    m_error.clear();
+    return true;
+}
+
+void CanLogReader::close()
+{
+    if (m_map)
+        m_file.unmap(const_cast<uchar*>(m_map));
+    m_map = nullptr;
+    m_size = 0;
+    m_count = 0;
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+bool CanLogReader::record(qint64 index, CanLog::Record& r) const
+{
+    if (!m_map || index < 0 || index >= m_count)
+        return false;
+    CanLog::decodeRecord(m_map + m_headerBytes + index * m_recordBytes, r);
+    return true;
+}
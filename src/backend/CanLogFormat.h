@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QtGlobal>
+
+#include "../proto/HMI_RX_CAN.pb.h"
+
+// Binary CAN recording (*.canb), the compact alternative to LoggerBackend's CSV:
+//
+//   header  "HMICANB1" | u16 version | u16 headerBytes | u16 recordBytes | u16 reserved
+//           | i64 startEpochMs | u64 reserved                                    (32 bytes)
+//   record  u64 ts_ns | u32 can_id | u8 bus_id | u8 flags | u8 dlc | u8 reserved
+//           | u8 data[8]                                                         (24 bytes)
+//
+// Little-endian throughout; flags bit 0 = extended ID, bit 1 = RTR; data is zero-padded past dlc.
+// Readers honour headerBytes / recordBytes, so a later version can append fields without breaking
+// them. A record is ~24 bytes against ~60 for the same event as CSV text, and needs no formatting.
+namespace CanLog {
+
+constexpr char kMagic[8] = { 'H', 'M', 'I', 'C', 'A', 'N', 'B', '1' };
+constexpr quint16 kVersion = 1;
+constexpr int kHeaderBytes = 32;
+constexpr int kRecordBytes = 24;
+constexpr quint8 kFlagExtended = 0x01;
+constexpr quint8 kFlagRtr = 0x02;
+inline QString fileSuffix() { return QStringLiteral("canb"); }
+
+struct Record
+{
+    quint64 tsNs = 0;
+    quint32 canId = 0;
+    quint8 busId = 0;
+    quint8 flags = 0;
+    quint8 dlc = 0;
+    quint8 data[8] = {};
+};
+
+QByteArray makeHeader(qint64 startEpochMs);
+// Encodes one record into the kRecordBytes at `p`.
+void encodeRecord(uchar* p, const can_stream::CanEvent& e);
+// Appends one encoded record to `out` (grows it by kRecordBytes).
+void appendRecord(QByteArray& out, const can_stream::CanEvent& e);
+void decodeRecord(const uchar* p, Record& r);
+
+// CSV recording (*.csv): the header line, and one event appended as
+// "bus_id,can_id,is_extended,is_rtr,ts_ns,dlc,data_hex\n" with data_hex as space-separated
+// lowercase byte pairs. Formats straight into `out` with lookup tables: no QString, no
+// QTextStream and no allocation once `out` has grown to a batch's size.
+QByteArray csvHeader();
+void appendCsvLine(QByteArray& out, const can_stream::CanEvent& e);
+
+} // namespace CanLog
+
+// Random-access reader over a memory-mapped .canb file.
+class CanLogReader
+{
+public:
+    CanLogReader() = default;
+    ~CanLogReader() { close(); }
+    CanLogReader(const CanLogReader&) = delete;
+    CanLogReader& operator=(const CanLogReader&) = delete;
+
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return m_map != nullptr; }
+    QString errorString() const { return m_error; }
+
+    quint16 version() const { return m_version; }
+    qint64 startEpochMs() const { return m_startEpochMs; }
+    // Complete records only; a partially written tail (e.g. after power loss) is ignored.
+    qint64 count() const { return m_count; }
+    bool record(qint64 index, CanLog::Record& r) const;
+
+private:
+    QFile m_file;
+    const uchar* m_map = nullptr;
+    qint64 m_size = 0;
+    qint64 m_count = 0;
+    int m_headerBytes = CanLog::kHeaderBytes;
+    int m_recordBytes = CanLog::kRecordBytes;
+    quint16 m_version = 0;
+    qint64 m_startEpochMs = 0;
+    QString m_error;
+};
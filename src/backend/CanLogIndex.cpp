@@ -0,0 +1,324 @@
+#include "CanLogIndex.h"
+#include "LogBlockFile.h"
+#include <QFile>
+#include <QtEndian>
+#include <cstring>
+
+namespace CanLogIndex {
+
+void Builder::reset()
+{
+    m_entries.clear();
+    m_hasOpen = false;
+}
+
+void Builder::addBatch(quint64 rawOffset, quint32 rawBytes, const Span& span)
+{
+    if (span.events == 0 || rawBytes == 0) return;
+    if (!m_hasOpen) {
+        m_open = Entry();
+        m_open.rawOffset = rawOffset;
+        m_open.span = span;
+        m_hasOpen = true;
+    } else {
+        Span& s = m_open.span;
+        s.minTsNs = qMin(s.minTsNs, span.minTsNs);
+        s.maxTsNs = qMax(s.maxTsNs, span.maxTsNs);
+        s.events += span.events;
+        for (int i = 0; i < kIdBits / 64; ++i)
+            s.ids[i] |= span.ids[i];
+    }
+    // Batches arrive back to back, so the chunk covers everything up to the end of this one
+    m_open.rawBytes = static_cast<quint32>(rawOffset + rawBytes - m_open.rawOffset);
+    if (m_open.span.events >= m_chunkEvents) {
+        m_entries.append(m_open);
+        m_hasOpen = false;
+    }
+}
+
+QByteArray Builder::finish(bool binary, bool compressed)
+{
+    if (m_hasOpen) {
+        m_entries.append(m_open);
+        m_hasOpen = false;
+    }
+    QByteArray out(kHeaderBytes + m_entries.size() * kEntryBytes, '\0');
+    uchar* p = reinterpret_cast<uchar*>(out.data());
+    std::memcpy(p, kMagic, sizeof(kMagic));
+    qToLittleEndian<quint16>(kVersion, p + 8);
+    qToLittleEndian<quint16>(kHeaderBytes, p + 10);
+    qToLittleEndian<quint16>(kEntryBytes, p + 12);
+    qToLittleEndian<quint16>(kIdBits, p + 14);
+    qToLittleEndian<quint32>(static_cast<quint32>(m_entries.size()), p + 16);
+    p[20] = binary ? 1 : 0;
+    p[21] = compressed ? 1 : 0;
+    p += kHeaderBytes;
+    for (const Entry& e : m_entries) {
+        qToLittleEndian<quint64>(e.rawOffset, p);
+        qToLittleEndian<quint32>(e.rawBytes, p + 8);
+        qToLittleEndian<quint32>(e.span.events, p + 12);
+        qToLittleEndian<quint64>(e.span.minTsNs, p + 16);
+        qToLittleEndian<quint64>(e.span.maxTsNs, p + 24);
+        for (int i = 0; i < kIdBits / 64; ++i)
+            qToLittleEndian<quint64>(e.span.ids[i], p + 32 + 8 * i);
+        p += kEntryBytes;
+    }
+    m_entries.clear();
+    return out;
+}
+
+namespace {
+
+bool loadIndex(const QString& path, QVector<Entry>& entries)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return false;
+    const QByteArray data = f.readAll();
+    const uchar* p = reinterpret_cast<const uchar*>(data.constData());
+    if (data.size() < kHeaderBytes || std::memcmp(p, kMagic, sizeof(kMagic)) != 0)
+        return false;
+    const int headerBytes = qFromLittleEndian<quint16>(p + 10);
+    const int entryBytes = qFromLittleEndian<quint16>(p + 12);
+    const int idBits = qFromLittleEndian<quint16>(p + 14);
+    const quint32 count = qFromLittleEndian<quint32>(p + 16);
+    if (headerBytes < kHeaderBytes || entryBytes < kEntryBytes || idBits != kIdBits
+        || headerBytes + qint64(count) * entryBytes > data.size())
+        return false;
+    entries.resize(count);
+    p += headerBytes;
+    for (quint32 i = 0; i < count; ++i, p += entryBytes) {
+        Entry& e = entries[i];
+        e.rawOffset = qFromLittleEndian<quint64>(p);
+        e.rawBytes = qFromLittleEndian<quint32>(p + 8);
+        e.span.events = qFromLittleEndian<quint32>(p + 12);
+        e.span.minTsNs = qFromLittleEndian<quint64>(p + 16);
+        e.span.maxTsNs = qFromLittleEndian<quint64>(p + 24);
+        for (int w = 0; w < kIdBits / 64; ++w)
+            e.span.ids[w] = qFromLittleEndian<quint64>(p + 32 + 8 * w);
+    }
+    return true;
+}
+
+bool mayMatch(const Entry& e, const Query& q)
+{
+    if (e.span.maxTsNs < q.fromNs || e.span.minTsNs > q.toNs)
+        return false;
+    if (q.canIds.isEmpty())
+        return true;
+    auto bitSet = [&e](int bit) { return (e.span.ids[bit >> 6] >> (bit & 63)) & 1; };
+    for (quint32 id : q.canIds) {
+        // An ID that fits in 11 bits may have been sent either way
+        if ((id <= 0x7FF && bitSet(idBit(id, false))) || bitSet(idBit(id, true)))
+            return true;
+    }
+    return false;
+}
+
+// The segment's uncompressed stream, read by range
+class StreamSource
+{
+public:
+    bool open(const QString& path, QString* error)
+    {
+        m_compressed = path.endsWith("." + LogBlock::fileSuffix());
+        if (m_compressed) {
+            if (!m_blocks.open(path)) {
+                if (error) *error = m_blocks.errorString();
+                return false;
+            }
+            return true;
+        }
+        m_file.setFileName(path);
+        if (!m_file.open(QIODevice::ReadOnly)) {
+            if (error) *error = m_file.errorString();
+            return false;
+        }
+        return true;
+    }
+
+    qint64 size() const { return m_compressed ? m_blocks.rawSize() : m_file.size(); }
+
+    bool read(qint64 offset, qint64 length, QByteArray& out)
+    {
+        out.resize(0);
+        if (!m_compressed) {
+            if (!m_file.seek(offset)) return false;
+            out = m_file.read(length);
+            return out.size() == length;
+        }
+        for (int b = m_blocks.blockForRawOffset(offset); b >= 0 && b < m_blocks.blocks().size() && length > 0; ++b) {
+            const LogBlockReader::Block& blk = m_blocks.blocks().at(b);
+            if (b != m_cachedBlock) {
+                if (!m_blocks.readBlock(b, m_cache)) return false;
+                m_cachedBlock = b;
+            }
+            const qint64 from = offset - blk.rawOffset;
+            const qint64 n = qMin<qint64>(length, blk.rawBytes - from);
+            out.append(m_cache.constData() + from, n);
+            offset += n;
+            length -= n;
+        }
+        return length == 0;
+    }
+
+private:
+    bool m_compressed = false;
+    QFile m_file;
+    LogBlockReader m_blocks;
+    QByteArray m_cache;       // last inflated block; chunks are far smaller than blocks
+    int m_cachedBlock = -1;
+};
+
+// Turns stream bytes into records; bytes of a record or line split across feeds are carried over.
+class RecordParser
+{
+public:
+    explicit RecordParser(bool binary) : m_binary(binary) {}
+
+    void reset() { m_carry.clear(); }
+
+    // False once `sink` asks to stop
+    bool feed(const QByteArray& data, const Query& q, const std::function<bool(const CanLog::Record&)>& sink)
+    {
+        const QByteArray buf = m_carry.isEmpty() ? data : m_carry + data;
+        m_carry.clear();
+        const char* p = buf.constData();
+        const char* const end = p + buf.size();
+        CanLog::Record r;
+        if (m_binary) {
+            for (; end - p >= CanLog::kRecordBytes; p += CanLog::kRecordBytes) {
+                CanLog::decodeRecord(reinterpret_cast<const uchar*>(p), r);
+                if (matches(r, q) && !sink(r)) return false;
+            }
+        } else {
+            for (;;) {
+                const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+                if (!nl) break;
+                if (parseCsvLine(p, nl, r) && matches(r, q) && !sink(r)) return false;
+                p = nl + 1;
+            }
+        }
+        m_carry = QByteArray(p, end - p);
+        return true;
+    }
+
+private:
+    static bool matches(const CanLog::Record& r, const Query& q)
+    {
+        return r.tsNs >= q.fromNs && r.tsNs <= q.toNs && (q.canIds.isEmpty() || q.canIds.contains(r.canId));
+    }
+
+    bool m_binary;
+    QByteArray m_carry;
+};
+
+inline bool parseUInt(const char*& p, const char* end, quint64& v)
+{
+    const char* start = p;
+    v = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+        v = v * 10 + static_cast<quint64>(*p++ - '0');
+    return p != start;
+}
+
+inline int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+} // namespace
+
+bool parseCsvLine(const char* p, const char* end, CanLog::Record& r)
+{
+    if (end > p && end[-1] == '\r') --end;
+    quint64 v[6];
+    for (int i = 0; i < 6; ++i) {
+        if (!parseUInt(p, end, v[i]) || p >= end || *p != ',')
+            return false;
+        ++p;
+    }
+    r.busId = static_cast<quint8>(v[0]);
+    r.canId = static_cast<quint32>(v[1]);
+    r.flags = static_cast<quint8>((v[2] ? CanLog::kFlagExtended : 0) | (v[3] ? CanLog::kFlagRtr : 0));
+    r.tsNs = v[4];
+    r.dlc = static_cast<quint8>(qMin<quint64>(v[5], 8));
+    std::memset(r.data, 0, sizeof(r.data));
+    int n = 0;
+    while (p < end && n < 8) {
+        if (*p == ' ') { ++p; continue; }
+        if (end - p < 2) return false;
+        const int hi = hexValue(p[0]);
+        const int lo = hexValue(p[1]);
+        if (hi < 0 || lo < 0) return false;
+        r.data[n++] = static_cast<quint8>((hi << 4) | lo);
+        p += 2;
+    }
+    return true;
+}
+
+bool query(const QString& segmentPath, const Query& q,
+           const std::function<bool(const CanLog::Record&)>& sink, QString* error)
+{
+    StreamSource source;
+    if (!source.open(segmentPath, error))
+        return false;
+
+    QString inner = segmentPath;
+    if (inner.endsWith("." + LogBlock::fileSuffix()))
+        inner.chop(LogBlock::fileSuffix().size() + 1);
+    const bool binary = inner.endsWith("." + CanLog::fileSuffix());
+    RecordParser parser(binary);
+    QByteArray buf;
+
+    QVector<Entry> entries;
+    if (loadIndex(segmentPath + "." + fileSuffix(), entries)) {
+        for (const Entry& e : entries) {
+            if (!mayMatch(e, q)) continue;
+            if (!source.read(static_cast<qint64>(e.rawOffset), e.rawBytes, buf))
+                break;   // index newer than a truncated segment
+            parser.reset();
+            if (!parser.feed(buf, q, sink))
+                return true;
+        }
+        return true;
+    }
+
+    // No index (e.g. a segment recovered after a crash): scan the stream in large pieces
+    constexpr qint64 kPiece = 4 * 1024 * 1024;
+    const qint64 size = source.size();
+    qint64 offset = 0;
+    if (binary) {
+        if (!source.read(0, qMin<qint64>(size, CanLog::kHeaderBytes), buf) || buf.size() < CanLog::kHeaderBytes)
+            return true;
+        offset = qFromLittleEndian<quint16>(reinterpret_cast<const uchar*>(buf.constData()) + 10);
+    }
+    for (; offset < size; offset += kPiece) {
+        if (!source.read(offset, qMin(kPiece, size - offset), buf))
+            break;
+        if (!parser.feed(buf, q, sink))
+            break;
+    }
+    return true;
+}
+
+bool summarize(const QString& indexPath, quint64& events, quint64& minTsNs, quint64& maxTsNs)
+{
+    QVector<Entry> entries;
+    if (!loadIndex(indexPath, entries))
+        return false;
+    events = 0;
+    minTsNs = 0;
+    maxTsNs = 0;
+    for (const Entry& e : entries) {
+        if (e.span.events == 0) continue;
+        if (events == 0 || e.span.minTsNs < minTsNs) minTsNs = e.span.minTsNs;
+        if (events == 0 || e.span.maxTsNs > maxTsNs) maxTsNs = e.span.maxTsNs;
+        events += e.span.events;
+    }
+    return true;
+}
+
+} // namespace CanLogIndex
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <QByteArray>
+#include <QSet>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include <functional>
+
+#include "CanLogFormat.h"
+
+// Sparse index sidecar for a recording segment (<segment>.idx), written by CanLogWriter when the
+// segment is finalised. The segment's stream (CSV or .canb, before any block compression) is cut
+// into chunks at batch boundaries; each chunk records where it starts, its timestamp range and
+// which CAN IDs occur in it, so a query reads only the chunks that can match.
+//
+//   header  "HMICIDX1" | u16 version | u16 headerBytes | u16 entryBytes | u16 idBits
+//           | u32 entries | u8 format (0 csv, 1 binary) | u8 compressed | u16 reserved | u64 reserved (32)
+//   entry   u64 rawOffset | u32 rawBytes | u32 events | u64 minTsNs | u64 maxTsNs | idBits/8 bitmap (32 + 256)
+//
+// Little-endian. Offsets are into the uncompressed stream (equal to file offsets unless the
+// segment is a LogBlockFile container). Standard IDs map to their own bit; extended IDs are hashed
+// onto the same bitmap, so a set bit can be a false positive but a clear bit never is.
+namespace CanLogIndex {
+
+constexpr char kMagic[8] = { 'H', 'M', 'I', 'C', 'I', 'D', 'X', '1' };
+constexpr quint16 kVersion = 1;
+constexpr int kHeaderBytes = 32;
+constexpr int kIdBits = 2048;
+constexpr int kEntryBytes = 32 + kIdBits / 8;
+inline QString fileSuffix() { return QStringLiteral("idx"); }
+
+inline int idBit(quint32 canId, bool extended)
+{
+    if (!extended)
+        return static_cast<int>(canId & (kIdBits - 1));
+    // Fibonacci hash of the 29-bit ID
+    return static_cast<int>((canId * 2654435761u) >> 21) & (kIdBits - 1);
+}
+
+// Summary of one submitted batch: the events that went into the file
+struct Span
+{
+    quint32 events = 0;
+    quint64 minTsNs = 0;
+    quint64 maxTsNs = 0;
+    quint64 ids[kIdBits / 64] = {};
+
+    void clear() { *this = Span(); }
+    void add(quint32 canId, bool extended, quint64 tsNs)
+    {
+        if (events == 0 || tsNs < minTsNs) minTsNs = tsNs;
+        if (events == 0 || tsNs > maxTsNs) maxTsNs = tsNs;
+        const int bit = idBit(canId, extended);
+        ids[bit >> 6] |= quint64(1) << (bit & 63);
+        ++events;
+    }
+};
+
+struct Entry
+{
+    quint64 rawOffset = 0;
+    quint32 rawBytes = 0;
+    Span span;
+};
+
+// Accumulates batches into chunks of at least `chunkEvents` events.
+class Builder
+{
+public:
+    explicit Builder(quint32 chunkEvents = 4096) : m_chunkEvents(qMax<quint32>(1, chunkEvents)) {}
+
+    void reset();
+    void addBatch(quint64 rawOffset, quint32 rawBytes, const Span& span);
+    // Serialises the index (closing the open chunk); `binary`/`compressed` describe the segment.
+    QByteArray finish(bool binary, bool compressed);
+
+private:
+    quint32 m_chunkEvents;
+    QVector<Entry> m_entries;
+    Entry m_open;
+    bool m_hasOpen = false;
+};
+
+struct Query
+{
+    quint64 fromNs = 0;
+    quint64 toNs = ~quint64(0);          // inclusive
+    QSet<quint32> canIds;                // empty = any ID
+};
+
+// Streams the records of `segmentPath` matching `query` to `sink` (return false from it to stop).
+// Uses <segmentPath>.idx when present to read only candidate chunks, otherwise scans the segment.
+// Returns false if the segment cannot be read.
+bool query(const QString& segmentPath, const Query& query,
+           const std::function<bool(const CanLog::Record&)>& sink, QString* error = nullptr);
+
+// Totals of the sidecar `indexPath`: events in the segment and their timestamp range. False when
+// there is no valid index.
+bool summarize(const QString& indexPath, quint64& events, quint64& minTsNs, quint64& maxTsNs);
+
+// Parses one CSV data line ("bus_id,can_id,is_extended,is_rtr,ts_ns,dlc,data_hex"); false for the
+// header or a malformed line.
+bool parseCsvLine(const char* begin, const char* end, CanLog::Record& r);
+
+} // namespace CanLogIndex
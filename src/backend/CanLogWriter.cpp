@@ -0,0 +1,333 @@
+#include "CanLogWriter.h"
+#include "LogBlockFile.h"
+#include <QDateTime>
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+#include <QThread>
+
+#if defined(Q_OS_WIN)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+CanLogWriter::~CanLogWriter()
+{
+    stop();
+    wait();
+}
+
+bool CanLogWriter::start(const Target& target, const Config& config, const SegmentClosed& onSegmentClosed,
+                         const Finished& onFinished, QString* error)
+{
+    stop();
+    wait();
+    m_target = target;
+    m_onSegmentClosed = onSegmentClosed;
+    m_onFinished = onFinished;
+    m_config = config;
+    m_config.flushIntervalMs = qMax(1, m_config.flushIntervalMs);
+    m_config.flushBytes = qMax<qsizetype>(4096, m_config.flushBytes);
+    m_config.maxQueuedBytes = qMax(m_config.flushBytes, m_config.maxQueuedBytes);
+    m_config.compressLevel = qBound(0, m_config.compressLevel, 9);
+    m_config.blockBytes = qMax<qsizetype>(64 * 1024, m_config.blockBytes);
+    m_config.blockMaxAgeMs = qMax(m_config.flushIntervalMs, m_config.blockMaxAgeMs);
+    m_config.segmentMaxBytes = qMax<qint64>(0, m_config.segmentMaxBytes);
+    m_config.segmentMaxMs = qMax<qint64>(0, m_config.segmentMaxMs);
+    m_index = CanLogIndex::Builder(m_config.indexChunkEvents);
+
+    m_front.clear();
+    m_front.reserve(m_config.flushBytes);
+    m_frontEvents = 0;
+    m_frontBatches.clear();
+    m_backBatches.clear();
+    m_stopRequested = false;
+    m_closed.clear();
+    m_block.clear();
+    if (compressing())
+        m_block.reserve(m_config.blockBytes + m_config.flushBytes);
+    m_dirty = false;
+    m_warned = false;
+    m_queuedBytes.store(0, std::memory_order_relaxed);
+    m_droppedEvents.store(0, std::memory_order_relaxed);
+    m_writtenBytes.store(0, std::memory_order_relaxed);
+    m_writeErrors.store(0, std::memory_order_relaxed);
+    m_rawBytes.store(0, std::memory_order_relaxed);
+    m_packedBytes.store(0, std::memory_order_relaxed);
+    m_compressNs.store(0, std::memory_order_relaxed);
+
+    if (!openSegment(1, error))
+        return false;
+
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->setObjectName(QStringLiteral("CanLogWriter"));
+    m_thread->start(QThread::LowPriority);
+    return true;
+}
+
+void CanLogWriter::stop()
+{
+    if (!m_thread) return;
+    {
+        QMutexLocker lock(&m_mutex);
+        if (m_stopRequested) return;
+        m_stopRequested = true;
+    }
+    m_wake.wakeOne();
+}
+
+void CanLogWriter::wait()
+{
+    if (!m_thread) return;
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+}
+
+bool CanLogWriter::isRunning() const
+{
+    if (!m_thread) return false;
+    QMutexLocker lock(&m_mutex);
+    return !m_stopRequested;
+}
+
+bool CanLogWriter::submit(const QByteArray& bytes, int events, const CanLogIndex::Span* span)
+{
+    if (!m_thread || bytes.isEmpty()) return true;
+    if (m_queuedBytes.load(std::memory_order_relaxed) + bytes.size() > m_config.maxQueuedBytes) {
+        m_droppedEvents.fetch_add(static_cast<quint64>(events), std::memory_order_relaxed);
+        return false;
+    }
+    bool wake = false;
+    {
+        QMutexLocker lock(&m_mutex);
+        m_front.append(bytes);
+        m_frontEvents += static_cast<quint64>(events);
+        PendingBatch batch;
+        batch.bytes = bytes.size();
+        if (span && m_config.indexChunkEvents > 0)
+            batch.span = *span;
+        m_frontBatches.append(batch);
+        m_queuedBytes.fetch_add(bytes.size(), std::memory_order_relaxed);
+        wake = m_front.size() >= m_config.flushBytes;
+    }
+    if (wake)
+        m_wake.wakeOne();
+    return true;
+}
+
+QVector<CanLogWriter::Segment> CanLogWriter::segments() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_closed;
+}
+
+QString CanLogWriter::currentSegmentPath() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_currentPath;
+}
+
+bool CanLogWriter::openSegment(int index, QString* error)
+{
+    const QString path = m_target.segmentPath(index);
+    auto* file = new QFile(path + partialSuffix());
+    if (!file->open(QIODevice::WriteOnly)) {
+        if (error) *error = file->errorString();
+        qWarning() << "CanLogWriter: failed to open" << file->fileName() << file->errorString();
+        delete file;
+        return false;
+    }
+    m_file = file;
+    m_segment = Segment();
+    m_segment.index = index;
+    m_segment.path = path;
+    m_segment.startEpochMs = QDateTime::currentMSecsSinceEpoch();
+    m_segmentAge.start();
+    {
+        QMutexLocker lock(&m_mutex);
+        m_currentPath = path;
+    }
+
+    const QByteArray header = m_target.header();
+    m_segmentRawBytes = static_cast<quint64>(header.size());
+    m_index.reset();
+    if (compressing()) {
+        writeOut(LogBlock::makeHeader());
+        m_block.append(header);
+        m_blockAge.start();
+    } else {
+        writeOut(header);
+    }
+    return true;
+}
+
+void CanLogWriter::finalizeSegment()
+{
+    if (!m_file) return;
+    closeBlock();
+    writeIndex();
+    syncToDisk(*m_file);
+    m_dirty = false;
+    m_segment.bytes = m_file->size();
+    m_segment.endEpochMs = QDateTime::currentMSecsSinceEpoch();
+    m_file->close();
+
+    // Only a complete, synced segment gets its final name
+    const QString partial = m_file->fileName();
+    QFile::remove(m_segment.path);
+    if (!QFile::rename(partial, m_segment.path)) {
+        qWarning() << "CanLogWriter: failed to finalise" << partial;
+        m_segment.path = partial;
+    }
+    delete m_file;
+    m_file = nullptr;
+
+    {
+        QMutexLocker lock(&m_mutex);
+        m_closed.append(m_segment);
+        m_currentPath.clear();
+    }
+    if (m_onSegmentClosed)
+        m_onSegmentClosed(m_segment);
+}
+
+void CanLogWriter::closeBlock()
+{
+    if (m_block.isEmpty() || !m_file) return;
+    QElapsedTimer t;
+    t.start();
+    m_packed.resize(0);
+    LogBlock::appendBlock(m_packed, m_block.constData(), m_block.size(), m_config.compressLevel);
+    m_compressNs.fetch_add(t.nsecsElapsed(), std::memory_order_relaxed);
+    m_rawBytes.fetch_add(static_cast<quint64>(m_block.size()), std::memory_order_relaxed);
+    m_packedBytes.fetch_add(static_cast<quint64>(m_packed.size()), std::memory_order_relaxed);
+    writeOut(m_packed);
+    m_block.resize(0);
+    m_blockAge.restart();
+}
+
+void CanLogWriter::writeIndex()
+{
+    if (m_config.indexChunkEvents == 0) return;
+    // Written (atomically) before the segment is renamed, so a final segment always has its index
+    QSaveFile f(m_segment.path + "." + CanLogIndex::fileSuffix());
+    if (!f.open(QIODevice::WriteOnly)) {
+        qWarning() << "CanLogWriter: failed to write index" << f.fileName() << f.errorString();
+        return;
+    }
+    f.write(m_index.finish(m_target.binary, compressing()));
+    if (!f.commit())
+        qWarning() << "CanLogWriter: failed to commit index" << f.fileName() << f.errorString();
+}
+
+bool CanLogWriter::writeOut(const QByteArray& bytes)
+{
+    if (!m_file) return false;
+    const qint64 n = m_file->write(bytes);
+    if (n != bytes.size()) {
+        m_writeErrors.fetch_add(1, std::memory_order_relaxed);
+        if (!m_warned) {
+            qWarning() << "CanLogWriter: write failed on" << m_file->fileName() << m_file->errorString();
+            m_warned = true;
+        }
+    }
+    m_file->flush();
+    if (n > 0)
+        m_writtenBytes.fetch_add(static_cast<quint64>(n), std::memory_order_relaxed);
+    m_dirty = true;
+    return n == bytes.size();
+}
+
+bool CanLogWriter::segmentFull() const
+{
+    if (!m_file) return false;
+    return (m_config.segmentMaxBytes > 0 && m_file->size() >= m_config.segmentMaxBytes)
+        || (m_config.segmentMaxMs > 0 && m_segmentAge.elapsed() >= m_config.segmentMaxMs);
+}
+
+void CanLogWriter::run()
+{
+    QByteArray back;
+    back.reserve(m_config.flushBytes);
+    QElapsedTimer sinceSync;
+    sinceSync.start();
+
+    for (;;) {
+        bool stopping = false;
+        quint64 events = 0;
+        {
+            QMutexLocker lock(&m_mutex);
+            QDeadlineTimer deadline(m_config.flushIntervalMs);
+            while (!m_stopRequested && m_front.size() < m_config.flushBytes && !deadline.hasExpired())
+                m_wake.wait(&m_mutex, deadline);
+            back.swap(m_front);
+            m_backBatches.swap(m_frontBatches);
+            m_frontBatches.resize(0);
+            events = m_frontEvents;
+            m_frontEvents = 0;
+            stopping = m_stopRequested;
+        }
+
+        if (!back.isEmpty()) {
+            if (!m_file) {
+                // Rollover could not open the next segment; nothing more can be written
+                m_droppedEvents.fetch_add(events, std::memory_order_relaxed);
+            } else {
+                if (compressing())
+                    m_block.append(back);
+                else
+                    writeOut(back);
+                m_segment.events += events;
+                for (const PendingBatch& b : std::as_const(m_backBatches)) {
+                    m_index.addBatch(m_segmentRawBytes, static_cast<quint32>(b.bytes), b.span);
+                    m_segmentRawBytes += static_cast<quint64>(b.bytes);
+                }
+            }
+            m_backBatches.resize(0);
+            m_queuedBytes.fetch_sub(back.size(), std::memory_order_relaxed);
+            back.resize(0);   // keeps capacity for the next swap
+        }
+        if (compressing() && !m_block.isEmpty()
+            && (stopping || m_block.size() >= m_config.blockBytes || m_blockAge.elapsed() >= m_config.blockMaxAgeMs))
+            closeBlock();
+
+        if (!stopping && segmentFull()) {
+            const int next = m_segment.index + 1;
+            finalizeSegment();
+            openSegment(next, nullptr);
+            sinceSync.restart();
+        }
+
+        if (m_dirty && m_file && m_config.syncIntervalMs > 0 && sinceSync.elapsed() >= m_config.syncIntervalMs) {
+            syncToDisk(*m_file);
+            sinceSync.restart();
+            m_dirty = false;
+        }
+
+        if (stopping) {
+            QMutexLocker lock(&m_mutex);
+            if (m_front.isEmpty())
+                break;
+        }
+    }
+
+    finalizeSegment();
+    if (m_onFinished)
+        m_onFinished(segments());
+}
+
+bool CanLogWriter::syncToDisk(QFile& file)
+{
+    const int fd = file.handle();
+    if (fd < 0) return false;
+#if defined(Q_OS_WIN)
+    return ::_commit(fd) == 0;
+#elif defined(Q_OS_LINUX)
+    return ::fdatasync(fd) == 0;
+#else
+    return ::fsync(fd) == 0;
+#endif
+}
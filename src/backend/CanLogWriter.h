@@ -0,0 +1,163 @@
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <QWaitCondition>
+#include <QtGlobal>
+#include <atomic>
+#include <functional>
+
+#include "CanLogIndex.h"
+
+class QFile;
+class QThread;
+
+// Background file writer for CAN recordings. The GUI thread appends encoded bytes to a front buffer;
+// a dedicated thread swaps it with the back buffer and writes that to disk, so a slow SD card never
+// stalls the event loop. When the queue is over its byte budget the batch is dropped and counted
+// rather than blocking the caller.
+//
+// With compression on, the file is a LogBlockFile container: the writer thread gathers the stream
+// into blocks and deflates each one before it reaches the disk, so ingest never waits on zlib.
+//
+// A recording is a series of segments. Each is written as "<path>.partial" and renamed to its final
+// name only once it is complete and synced, so a finished segment on disk is always whole; a new
+// segment starts when the current one reaches segmentMaxBytes or segmentMaxMs (between batches,
+// so records never straddle two files).
+//
+// Batches submitted with an index span are indexed per segment; the <segment>.idx sidecar (see
+// CanLogIndex.h) is written just before the segment is renamed.
+class CanLogWriter
+{
+public:
+    struct Config
+    {
+        int flushIntervalMs = 250;               // write at least this often while data is queued
+        qsizetype flushBytes = 256 * 1024;       // ...or as soon as this much is queued
+        int syncIntervalMs = 2000;               // fdatasync period; 0 = only on close
+        qsizetype maxQueuedBytes = 8 * 1024 * 1024;
+        int compressLevel = 0;                   // zlib 1..9; 0 = write the stream uncompressed
+        qsizetype blockBytes = 1024 * 1024;      // raw bytes per compressed block
+        int blockMaxAgeMs = 5000;                // close a partial block after this long
+        qint64 segmentMaxBytes = 0;              // bytes on disk per segment; 0 = no size limit
+        qint64 segmentMaxMs = 0;                 // wall time per segment; 0 = no time limit
+        quint32 indexChunkEvents = 4096;         // events per index entry; 0 = no sidecar
+    };
+
+    // What to write: the final path of segment `index` (1-based) and the stream header each
+    // segment starts with. Called on the writer thread for every segment after the first.
+    // The stream is written byte for byte (no text-mode newline translation) so index offsets hold.
+    struct Target
+    {
+        std::function<QString(int index)> segmentPath;
+        std::function<QByteArray()> header;
+        bool binary = false;                     // .canb records rather than CSV lines
+    };
+
+    struct Segment
+    {
+        int index = 0;
+        QString path;                            // final name
+        qint64 bytes = 0;                        // on disk
+        quint64 events = 0;
+        qint64 startEpochMs = 0;
+        qint64 endEpochMs = 0;
+    };
+    // Runs on the writer thread after a segment has been synced and renamed.
+    using SegmentClosed = std::function<void(const Segment&)>;
+    // Runs on the writer thread once the last segment is finalised, with every segment of the recording.
+    using Finished = std::function<void(const QVector<Segment>& segments)>;
+
+    static QString partialSuffix() { return QStringLiteral(".partial"); }
+    // fdatasync (fsync / _commit elsewhere) of an open file
+    static bool syncToDisk(QFile& file);
+
+    CanLogWriter() = default;
+    ~CanLogWriter();   // stops and waits for the writer thread
+    CanLogWriter(const CanLogWriter&) = delete;
+    CanLogWriter& operator=(const CanLogWriter&) = delete;
+
+    // Opens the first segment (synchronously, so a bad path is reported here) and starts the thread.
+    bool start(const Target& target, const Config& config, const SegmentClosed& onSegmentClosed = {},
+               const Finished& onFinished = {}, QString* error = nullptr);
+    // Drains the queue and finalises the last segment, then calls onFinished. Returns immediately;
+    // later calls are ignored.
+    void stop();
+    // Blocks until the writer thread has exited.
+    void wait();
+    // Started and not yet asked to stop
+    bool isRunning() const;
+
+    // Queues `events` events encoded in `bytes`, summarised by `span` for the index. False (and the
+    // events are counted as dropped) when the queue is full.
+    bool submit(const QByteArray& bytes, int events, const CanLogIndex::Span* span = nullptr);
+
+    // Segments finalised so far; complete once onFinished has run.
+    QVector<Segment> segments() const;
+    // Final path of the segment being written (its file carries partialSuffix()).
+    QString currentSegmentPath() const;
+
+    qint64 queuedBytes() const { return m_queuedBytes.load(std::memory_order_relaxed); }
+    quint64 droppedEvents() const { return m_droppedEvents.load(std::memory_order_relaxed); }
+    quint64 writtenBytes() const { return m_writtenBytes.load(std::memory_order_relaxed); }
+    quint64 writeErrors() const { return m_writeErrors.load(std::memory_order_relaxed); }
+    // Compression: stream bytes deflated so far, their size on disk and the time spent in zlib.
+    bool compressing() const { return m_config.compressLevel > 0; }
+    quint64 rawBytes() const { return m_rawBytes.load(std::memory_order_relaxed); }
+    quint64 packedBytes() const { return m_packedBytes.load(std::memory_order_relaxed); }
+    qint64 compressNs() const { return m_compressNs.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    bool openSegment(int index, QString* error);
+    void finalizeSegment();
+    void closeBlock();
+    bool writeOut(const QByteArray& bytes);
+    bool segmentFull() const;
+    void writeIndex();
+
+    struct PendingBatch
+    {
+        qsizetype bytes = 0;
+        CanLogIndex::Span span;
+    };
+
+    Config m_config;
+    Target m_target;
+    SegmentClosed m_onSegmentClosed;
+    Finished m_onFinished;
+    QThread* m_thread = nullptr;
+
+    // Writer thread only (between start and the end of run)
+    QFile* m_file = nullptr;     // owned; the current segment's .partial file
+    Segment m_segment;           // the segment being written
+    QElapsedTimer m_segmentAge;
+    QElapsedTimer m_blockAge;
+    QByteArray m_block;          // raw bytes of the block being filled
+    QByteArray m_packed;
+    quint64 m_segmentRawBytes = 0;   // stream bytes of the segment so far (index offsets)
+    CanLogIndex::Builder m_index;
+    QVector<PendingBatch> m_backBatches;
+    bool m_dirty = false;        // written since the last sync
+    bool m_warned = false;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_wake;
+    QByteArray m_front;          // guarded by m_mutex
+    quint64 m_frontEvents = 0;   // guarded by m_mutex
+    QVector<PendingBatch> m_frontBatches;   // guarded by m_mutex; one per indexed batch in m_front
+    bool m_stopRequested = false;
+    QVector<Segment> m_closed;   // guarded by m_mutex
+    QString m_currentPath;       // guarded by m_mutex
+
+    std::atomic<qint64> m_queuedBytes{0};
+    std::atomic<quint64> m_droppedEvents{0};
+    std::atomic<quint64> m_writtenBytes{0};
+    std::atomic<quint64> m_writeErrors{0};
+    std::atomic<quint64> m_rawBytes{0};
+    std::atomic<quint64> m_packedBytes{0};
+    std::atomic<qint64> m_compressNs{0};
+};
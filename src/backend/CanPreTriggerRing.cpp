@@ -0,0 +1,13 @@
+#include "CanPreTriggerRing.h"
+
+void CanPreTriggerRing::configure(qint64 maxBytes)
+{
+    const qint64 capacity = qMax<qint64>(0, maxBytes) / CanLog::kRecordBytes;
+    if (capacity == m_capacity)
+        return;
+    m_capacity = capacity;
+    m_buffer = QByteArray();
+    if (m_capacity > 0)
+        m_buffer.resize(m_capacity * CanLog::kRecordBytes);
+    clear();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QByteArray>
+#include <QtGlobal>
+
+#include "CanLogFormat.h"
+
+// Fixed-size history of the most recent CAN events, kept while nothing is being recorded so that a
+// recording can start with the moments before Record was pressed. Events are stored as .canb
+// records (CanLogFormat.h) in one buffer allocated by configure(); pushing overwrites the oldest
+// slot and never allocates.
+//
+// Timestamps follow the transmitter's monotonic clock. An event more than kClockRestartNs older
+// than the previous one means that clock restarted: the history before it is dropped, since its
+// timestamps cannot be compared with the new ones.
+class CanPreTriggerRing
+{
+public:
+    // Reallocates only when the capacity changes; 0 frees the buffer and disables the ring.
+    void configure(qint64 maxBytes);
+    bool isEnabled() const { return m_capacity > 0; }
+    void clear() { m_head = 0; m_count = 0; m_newestTsNs = 0; }
+
+    static constexpr quint64 kClockRestartNs = 1000000000ULL;
+
+    qint64 count() const { return m_count; }
+    // Timestamp of the last event pushed
+    quint64 newestTsNs() const { return m_newestTsNs; }
+
+    void push(const can_stream::CanEvent& e)
+    {
+        if (e.ts_ns() + kClockRestartNs < m_newestTsNs)
+            clear();
+        CanLog::encodeRecord(reinterpret_cast<uchar*>(m_buffer.data()) + m_head * CanLog::kRecordBytes, e);
+        m_newestTsNs = e.ts_ns();
+        m_head = m_head + 1 == m_capacity ? 0 : m_head + 1;
+        if (m_count < m_capacity)
+            ++m_count;
+    }
+
+    // Encoded record i, oldest first (0 <= i < count())
+    const uchar* record(qint64 i) const
+    {
+        qint64 slot = m_head - m_count + i;
+        if (slot < 0) slot += m_capacity;
+        return reinterpret_cast<const uchar*>(m_buffer.constData()) + slot * CanLog::kRecordBytes;
+    }
+
+private:
+    QByteArray m_buffer;
+    qint64 m_capacity = 0;   // records
+    qint64 m_head = 0;       // next slot to write
+    qint64 m_count = 0;
+    quint64 m_newestTsNs = 0;
+};
@@ -0,0 +1,266 @@
+#include "CanSignalsBackend.h"
+#include "GlobalReceiver.h"
+
+#include <QDebug>
+#include <QSettings>
+#include <algorithm>
+#include <cmath>
+
+static const char* const kCanSignalsGroup = "canSignals";
+
+// ---- CanSignalModel ----
+
+CanSignalModel::CanSignalModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int CanSignalModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid() || !m_db)
+        return 0;
+    return m_db->signalDefs().size();
+}
+
+QVariant CanSignalModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || !m_db || index.row() < 0 || index.row() >= m_db->signalDefs().size())
+        return {};
+
+    const int row = index.row();
+    const DbcDatabase::Signal& s = m_db->signalDefs().at(row);
+    const DbcDatabase::Message& m = m_db->messages().at(m_messageOf.at(row));
+    switch (role) {
+    case NameRole:
+        return s.name;
+    case MessageRole:
+        return m.name;
+    case CanIdTextRole:
+        return QString::number(m.canId, 16).toUpper().rightJustified(m.extended ? 8 : 3, QLatin1Char('0'));
+    case ValueRole:
+        return m_values[row];
+    case ValueTextRole: {
+        if (!m_seen[row])
+            return QStringLiteral("--");
+        // Integer-scaled signals print as integers; fractional scales keep enough decimals for one step
+        const double scale = std::abs(s.scale);
+        const int decimals = (scale >= 1.0 || scale == 0.0) ? 0 : qMin(6, int(std::ceil(-std::log10(scale))));
+        return QString::number(m_values[row], 'f', decimals);
+    }
+    case UnitRole:
+        return s.unit;
+    case SeenRole:
+        return m_seen[row] != 0;
+    default:
+        return {};
+    }
+}
+
+QHash<int, QByteArray> CanSignalModel::roleNames() const
+{
+    return {
+        { NameRole, "name" },
+        { MessageRole, "message" },
+        { CanIdTextRole, "canIdText" },
+        { ValueRole, "value" },
+        { ValueTextRole, "valueText" },
+        { UnitRole, "unit" },
+        { SeenRole, "seen" },
+    };
+}
+
+void CanSignalModel::reset(const std::shared_ptr<const DbcDatabase>& db)
+{
+    beginResetModel();
+    m_db = db;
+    m_messageOf.clear();
+    m_values.clear();
+    m_seen.clear();
+    if (m_db) {
+        const int n = m_db->signalDefs().size();
+        m_messageOf.resize(n);
+        for (int i = 0; i < m_db->messages().size(); ++i) {
+            const DbcDatabase::Message& m = m_db->messages().at(i);
+            std::fill(m_messageOf.begin() + m.firstSignal, m_messageOf.begin() + m.firstSignal + m.signalCount, i);
+        }
+        m_values.assign(n, 0.0);
+        m_seen.assign(n, 0);
+    }
+    endResetModel();
+}
+
+void CanSignalModel::update(const std::vector<double>& values, const std::vector<uchar>& dirty)
+{
+    static const QList<int> roles = { ValueRole, ValueTextRole, SeenRole };
+    const int n = static_cast<int>(qMin(m_values.size(), dirty.size()));
+    int runStart = -1;
+    for (int i = 0; i <= n; ++i) {
+        if (i < n && dirty[i]) {
+            m_values[i] = values[i];
+            m_seen[i] = 1;
+            if (runStart < 0) runStart = i;
+        } else if (runStart >= 0) {
+            emit dataChanged(index(runStart), index(i - 1), roles);
+            runStart = -1;
+        }
+    }
+}
+
+// ---- CanSignalsBackend ----
+
+CanSignalsBackend::CanSignalsBackend(QObject* parent)
+    : QObject(parent)
+{
+    QSettings s(QStringLiteral("OSU"), QStringLiteral("HMI_Mk1"));
+    s.beginGroup(kCanSignalsGroup);
+    m_dbcPath = s.value("dbcPath").toString();
+    // Model refresh rate; the decoder itself keeps up with the bus regardless
+    const int rateHz = qBound(1, s.value("uiRateHz", 10).toInt(), 60);
+    // A DBC describes one network; -1 decodes frames from every bus
+    m_busId = s.value("busId", -1).toInt();
+    s.endGroup();
+
+    m_publishTimer.setInterval(1000 / rateHz);
+    connect(&m_publishTimer, &QTimer::timeout, this, &CanSignalsBackend::publish);
+
+    if (!m_dbcPath.isEmpty())
+        reload();
+}
+
+void CanSignalsBackend::attach(GlobalReceiver* rx)
+{
+    if (!rx) return;
+    connect(rx, &GlobalReceiver::canBatchReceived,
+            this, &CanSignalsBackend::decodeBatch, Qt::DirectConnection);
+}
+
+void CanSignalsBackend::setDbcPath(const QString& path)
+{
+    const QString p = path.trimmed();
+    if (p == m_dbcPath) return;
+    m_dbcPath = p;
+
+    QSettings s(QStringLiteral("OSU"), QStringLiteral("HMI_Mk1"));
+    s.beginGroup(kCanSignalsGroup);
+    s.setValue("dbcPath", m_dbcPath);
+    s.endGroup();
+
+    reload();
+}
+
+bool CanSignalsBackend::reload()
+{
+    if (m_dbcPath.isEmpty()) {
+        m_error.clear();
+        install(nullptr);
+        return true;
+    }
+
+    auto db = std::make_shared<DbcDatabase>();
+    QString error;
+    if (!db->load(m_dbcPath, &error)) {
+        qWarning() << "CanSignalsBackend: cannot load" << m_dbcPath << ":" << error;
+        m_error = error;
+        install(nullptr);
+        return false;
+    }
+    qInfo() << "CanSignalsBackend: loaded" << m_dbcPath << "-" << db->messages().size() << "messages,"
+            << db->signalDefs().size() << "signals";
+    m_error.clear();
+    install(std::move(db));
+    return true;
+}
+
+void CanSignalsBackend::install(std::shared_ptr<const DbcDatabase> db)
+{
+    const size_t n = db ? static_cast<size_t>(db->signalDefs().size()) : 0;
+    {
+        QMutexLocker lock(&m_mutex);
+        m_liveDb = db;
+        m_values.assign(n, 0.0);
+        m_dirty.assign(n, 0);
+        m_anyDirty = false;
+    }
+    m_snapshot.assign(n, 0.0);
+    m_snapshotDirty.assign(n, 0);
+    m_db = std::move(db);
+    m_model.reset(m_db);
+
+    if (m_db)
+        m_publishTimer.start();
+    else
+        m_publishTimer.stop();
+    emit databaseChanged();
+}
+
+void CanSignalsBackend::decodeBatch(const can_stream::CanBatch& batch)
+{
+    quint64 decoded = 0, unknown = 0;
+    {
+        QMutexLocker lock(&m_mutex);
+        const DbcDatabase* db = m_liveDb.get();
+        if (!db) return;
+        const auto& messages = db->messages();
+        const auto& sigs = db->signalDefs();
+
+        for (const auto& ev : batch.events()) {
+            if (m_busId >= 0 && ev.bus_id() != static_cast<quint32>(m_busId))
+                continue;
+            const int mi = db->findMessage(ev.can_id(), ev.is_extended());
+            if (mi < 0) {
+                ++unknown;
+                continue;
+            }
+            const DbcDatabase::Message& m = messages.at(mi);
+            const std::string& payload = ev.data();
+            quint64 le, be;
+            DbcDatabase::loadWords(reinterpret_cast<const uchar*>(payload.data()), static_cast<int>(payload.size()), le, be);
+
+            qint64 mux = -1;
+            if (m.muxSignal >= 0)
+                mux = DbcDatabase::extract(sigs.at(m.muxSignal), le, be);
+            const int end = m.firstSignal + m.signalCount;
+            for (int i = m.firstSignal; i < end; ++i) {
+                const DbcDatabase::Signal& s = sigs.at(i);
+                if (s.muxValue >= 0 && s.muxValue != mux)
+                    continue;
+                m_values[i] = DbcDatabase::physical(s, DbcDatabase::extract(s, le, be));
+                m_dirty[i] = 1;
+            }
+            m_anyDirty = true;
+            ++decoded;
+        }
+    }
+    if (decoded) m_decoded.fetch_add(decoded, std::memory_order_relaxed);
+    if (unknown) m_unknown.fetch_add(unknown, std::memory_order_relaxed);
+}
+
+void CanSignalsBackend::publish()
+{
+    bool changed = false;
+    {
+        QMutexLocker lock(&m_mutex);
+        if (m_anyDirty && m_values.size() == m_snapshot.size()) {
+            // Only the flags and their values cross over; the model update runs after unlocking
+            for (size_t i = 0; i < m_dirty.size(); ++i) {
+                if (m_dirty[i]) {
+                    m_snapshot[i] = m_values[i];
+                    m_dirty[i] = 0;
+                    m_snapshotDirty[i] = 1;
+                }
+            }
+            m_anyDirty = false;
+            changed = true;
+        }
+    }
+    if (changed) {
+        m_model.update(m_snapshot, m_snapshotDirty);
+        std::fill(m_snapshotDirty.begin(), m_snapshotDirty.end(), uchar(0));
+    }
+
+    const quint64 decoded = m_decoded.load(std::memory_order_relaxed);
+    if (decoded != m_decodedReported) {
+        m_decodedReported = decoded;
+        emit statsChanged();
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "DbcDatabase.h"
+#include "../proto/HMI_RX_CAN.pb.h"   // can_stream::CanBatch
+
+class GlobalReceiver;
+
+// One row per DBC signal; values are pushed in by CanSignalsBackend at the UI rate, never per frame.
+class CanSignalModel final : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        NameRole = Qt::UserRole + 1,
+        MessageRole,
+        CanIdTextRole,
+        ValueRole,
+        ValueTextRole,
+        UnitRole,
+        SeenRole        // at least one frame carrying the signal has been decoded
+    };
+
+    explicit CanSignalModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    void reset(const std::shared_ptr<const DbcDatabase>& db);
+    // Copies the rows flagged in `dirty` from `values` and emits one dataChanged per contiguous run
+    void update(const std::vector<double>& values, const std::vector<uchar>& dirty);
+
+private:
+    std::shared_ptr<const DbcDatabase> m_db;
+    QVector<int> m_messageOf;     // signal index -> message index
+    std::vector<double> m_values;
+    std::vector<uchar> m_seen;
+};
+
+// Live CAN signal decoding. A DBC file is compiled into flat tables (DbcDatabase); CAN batches are
+// decoded directly on the RX thread into a value array, and a GUI-thread timer publishes whatever
+// changed to the model at most uiRateHz times per second. Decoding a frame is one table lookup plus
+// a shift-and-mask per signal, and the UI cost is bounded by the tick rate rather than the bus load.
+class CanSignalsBackend final : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QObject* model READ model CONSTANT)
+    Q_PROPERTY(QString dbcPath READ dbcPath WRITE setDbcPath NOTIFY databaseChanged)
+    Q_PROPERTY(bool loaded READ loaded NOTIFY databaseChanged)
+    Q_PROPERTY(QString errorString READ errorString NOTIFY databaseChanged)
+    Q_PROPERTY(int messageCount READ messageCount NOTIFY databaseChanged)
+    Q_PROPERTY(int signalCount READ signalCount NOTIFY databaseChanged)
+    Q_PROPERTY(quint64 decodedFrames READ decodedFrames NOTIFY statsChanged)
+    Q_PROPERTY(quint64 unknownFrames READ unknownFrames NOTIFY statsChanged)
+
+public:
+    explicit CanSignalsBackend(QObject* parent = nullptr);
+
+    // Subscribe to the receiver's CAN batches (direct: decodeBatch() runs on the RX thread)
+    void attach(GlobalReceiver* rx);
+
+    QObject* model() { return &m_model; }
+    QString dbcPath() const { return m_dbcPath; }
+    void setDbcPath(const QString& path);
+    bool loaded() const { return m_db != nullptr; }
+    QString errorString() const { return m_error; }
+    int messageCount() const { return m_db ? m_db->messages().size() : 0; }
+    int signalCount() const { return m_db ? m_db->signalDefs().size() : 0; }
+    quint64 decodedFrames() const { return m_decoded.load(std::memory_order_relaxed); }
+    quint64 unknownFrames() const { return m_unknown.load(std::memory_order_relaxed); }
+
+    Q_INVOKABLE bool reload();
+
+    // Thread-safe; called on the receiver thread
+    void decodeBatch(const can_stream::CanBatch& batch);
+
+signals:
+    void databaseChanged();
+    void statsChanged();
+
+private slots:
+    void publish();
+
+private:
+    void install(std::shared_ptr<const DbcDatabase> db);
+
+    CanSignalModel m_model;
+    QString m_dbcPath;
+    QString m_error;
+    std::shared_ptr<const DbcDatabase> m_db;   // GUI thread's reference
+
+    // Shared with the RX thread; the lock is taken once per batch and once per UI tick
+    QMutex m_mutex;
+    std::shared_ptr<const DbcDatabase> m_liveDb;
+    std::vector<double> m_values;
+    std::vector<uchar> m_dirty;
+    bool m_anyDirty = false;
+
+    std::vector<double> m_snapshot;            // GUI thread
+    std::vector<uchar> m_snapshotDirty;
+    std::atomic<quint64> m_decoded{0};
+    std::atomic<quint64> m_unknown{0};
+    quint64 m_decodedReported = 0;
+    int m_busId = -1;              // fixed at construction
+    QTimer m_publishTimer;
+};
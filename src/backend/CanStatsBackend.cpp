@@ -0,0 +1,313 @@
+#include "CanStatsBackend.h"
+#include "GlobalReceiver.h"
+
+#include <QSettings>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static const char* const kCanStatsGroup = "canStats";
+
+// ---- CanStatsTable ----
+
+void CanStatsTable::clear()
+{
+    m_slots.assign(1024, Entry());
+    m_shift = 32 - 10;
+    m_size = 0;
+}
+
+CanStatsTable::Entry& CanStatsTable::slotFor(quint32 key)
+{
+    const size_t mask = m_slots.size() - 1;
+    size_t i = (key * 0x9E3779B1u) >> m_shift;
+    for (;;) {
+        Entry& e = m_slots[i];
+        if (e.used && e.key == key)
+            return e;
+        if (!e.used) {
+            if ((m_size + 1) * 2 > static_cast<int>(m_slots.size())) {
+                grow();
+                return slotFor(key);
+            }
+            e.used = 1;
+            e.key = key;
+            ++m_size;
+            return e;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+void CanStatsTable::grow()
+{
+    std::vector<Entry> old;
+    old.swap(m_slots);
+    m_slots.assign(old.size() * 2, Entry());
+    --m_shift;
+    const size_t mask = m_slots.size() - 1;
+    for (const Entry& e : old) {
+        if (!e.used) continue;
+        size_t i = (e.key * 0x9E3779B1u) >> m_shift;
+        while (m_slots[i].used)
+            i = (i + 1) & mask;
+        m_slots[i] = e;
+    }
+}
+
+void CanStatsTable::add(const can_stream::CanEvent& ev, qint64 rxMs)
+{
+    Entry& e = slotFor(makeKey(ev.bus_id(), ev.can_id(), ev.is_extended()));
+    const quint64 ts = ev.ts_ns();
+    if (e.count > 0 && ts > e.lastTsNs) {
+        // 1/16 EWMA; the first interval seeds the mean so a new ID settles immediately
+        const float dt = static_cast<float>(ts - e.lastTsNs);
+        if (e.count == 1) {
+            e.meanDtNs = dt;
+        } else {
+            e.jitterNs += (std::abs(dt - e.meanDtNs) - e.jitterNs) * (1.0f / 16);
+            e.meanDtNs += (dt - e.meanDtNs) * (1.0f / 16);
+        }
+    }
+    ++e.count;
+    e.lastTsNs = ts;
+    e.lastRxMs = rxMs;
+    e.dlc = static_cast<quint8>(ev.dlc());
+    const std::string& d = ev.data();
+    e.size = static_cast<quint8>(qMin<size_t>(d.size(), sizeof(e.data)));
+    std::memcpy(e.data, d.data(), e.size);
+}
+
+// ---- CanStatsModel ----
+
+CanStatsModel::CanStatsModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int CanStatsModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_rows.size();
+}
+
+QVariant CanStatsModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_rows.size())
+        return {};
+
+    const Row& r = m_rows.at(index.row());
+    const bool extended = (r.key >> 29) & 1;
+    switch (role) {
+    case BusIdRole:
+        return int(r.key >> 30);
+    case CanIdTextRole:
+        return QString::number(r.key & 0x1FFFFFFF, 16).toUpper().rightJustified(extended ? 8 : 3, QLatin1Char('0'));
+    case CountRole:
+        return r.count;
+    case RateRole:
+        return r.rate;
+    case PeriodMsRole:
+        return r.periodMs;
+    case JitterMsRole:
+        return r.jitterMs;
+    case AgeMsRole:
+        return r.ageMs;
+    case SilentRole:
+        // Several periods without a frame; IDs that are normally slow get at least a second
+        return r.ageMs > qMax(1000.0, 5.0 * r.periodMs);
+    case DlcRole:
+        return r.dlc;
+    case DataHexRole:
+        return r.dataHex;
+    default:
+        return {};
+    }
+}
+
+QHash<int, QByteArray> CanStatsModel::roleNames() const
+{
+    return {
+        { BusIdRole, "busId" },
+        { CanIdTextRole, "canIdText" },
+        { CountRole, "count" },
+        { RateRole, "rate" },
+        { PeriodMsRole, "periodMs" },
+        { JitterMsRole, "jitterMs" },
+        { AgeMsRole, "ageMs" },
+        { SilentRole, "silent" },
+        { DlcRole, "dlc" },
+        { DataHexRole, "dataHex" },
+    };
+}
+
+void CanStatsModel::setSortKey(const QString& key)
+{
+    if (key == m_sortKey) return;
+    m_sortKey = key;
+    emit sortKeyChanged();
+    sortRows();
+}
+
+void CanStatsModel::clear()
+{
+    beginResetModel();
+    m_rows.clear();
+    m_rowOf.clear();
+    endResetModel();
+}
+
+void CanStatsModel::update(QVector<Row>& snapshot)
+{
+    QVector<Row> added;
+    for (Row& s : snapshot) {
+        const auto it = m_rowOf.constFind(s.key);
+        if (it == m_rowOf.constEnd())
+            added.append(std::move(s));
+        else
+            m_rows[it.value()] = std::move(s);
+    }
+    if (!added.isEmpty()) {
+        const int first = m_rows.size();
+        beginInsertRows(QModelIndex(), first, first + added.size() - 1);
+        for (Row& r : added) {
+            m_rowOf.insert(r.key, m_rows.size());
+            m_rows.append(std::move(r));
+        }
+        endInsertRows();
+    }
+    sortRows();
+    if (!m_rows.isEmpty())
+        emit dataChanged(index(0), index(m_rows.size() - 1));
+}
+
+void CanStatsModel::sortRows()
+{
+    if (m_rows.size() < 2) return;
+    emit layoutAboutToBeChanged();
+    // Ties fall back to (bus, ID) so equal rows keep a stable position between refreshes
+    const auto byKey = [](const Row& a, const Row& b) { return a.key < b.key; };
+    if (m_sortKey == QLatin1String("rate"))
+        std::sort(m_rows.begin(), m_rows.end(), [&](const Row& a, const Row& b) {
+            return a.rate != b.rate ? a.rate > b.rate : byKey(a, b); });
+    else if (m_sortKey == QLatin1String("jitter"))
+        std::sort(m_rows.begin(), m_rows.end(), [&](const Row& a, const Row& b) {
+            return a.jitterMs != b.jitterMs ? a.jitterMs > b.jitterMs : byKey(a, b); });
+    else if (m_sortKey == QLatin1String("age"))
+        std::sort(m_rows.begin(), m_rows.end(), [&](const Row& a, const Row& b) {
+            return a.ageMs != b.ageMs ? a.ageMs > b.ageMs : byKey(a, b); });
+    else
+        std::sort(m_rows.begin(), m_rows.end(), byKey);
+    for (int i = 0; i < m_rows.size(); ++i)
+        m_rowOf[m_rows.at(i).key] = i;
+    emit layoutChanged();
+}
+
+// ---- CanStatsBackend ----
+
+CanStatsBackend::CanStatsBackend(QObject* parent)
+    : QObject(parent)
+{
+    static const char* const bitrateKeys[kBuses] = { "bitrateHS", "bitrateCE", "bitrateSC", "bitrateLS" };
+    static const double defaultBitrates[kBuses] = { 500000, 500000, 500000, 125000 };
+
+    QSettings s(QStringLiteral("OSU"), QStringLiteral("HMI_Mk1"));
+    s.beginGroup(kCanStatsGroup);
+    for (int b = 0; b < kBuses; ++b)
+        m_bitrate[b] = qMax(1.0, s.value(bitrateKeys[b], defaultBitrates[b]).toDouble());
+    const int refreshHz = qBound(1, s.value("refreshHz", 4).toInt(), 20);
+    s.endGroup();
+
+    m_clock.start();
+    m_refreshTimer.setInterval(1000 / refreshHz);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &CanStatsBackend::refresh);
+    m_refreshTimer.start();
+}
+
+void CanStatsBackend::attach(GlobalReceiver* rx)
+{
+    if (!rx) return;
+    connect(rx, &GlobalReceiver::canBatchReceived,
+            this, &CanStatsBackend::onCanBatch, Qt::DirectConnection);
+}
+
+QVariantList CanStatsBackend::busLoad() const
+{
+    QVariantList out;
+    for (double l : m_load)
+        out.append(l);
+    return out;
+}
+
+void CanStatsBackend::onCanBatch(const can_stream::CanBatch& batch)
+{
+    quint64 bits[kBuses] = {};
+    const qint64 rxMs = m_clock.elapsed();
+    {
+        QMutexLocker lock(&m_mutex);
+        for (const auto& ev : batch.events()) {
+            m_table.add(ev, rxMs);
+            // Nominal frame length: 47 bits of framing (67 extended) plus the data field
+            const quint32 dataBits = ev.is_rtr() ? 0 : 8 * static_cast<quint32>(ev.data().size());
+            bits[ev.bus_id() & 3] += (ev.is_extended() ? 67 : 47) + dataBits;
+        }
+    }
+    for (int b = 0; b < kBuses; ++b) {
+        if (bits[b])
+            m_busBits[b].fetch_add(bits[b], std::memory_order_relaxed);
+    }
+}
+
+void CanStatsBackend::refresh()
+{
+    const qint64 now = m_clock.elapsed();
+    const double dtSec = qMax<qint64>(1, now - m_prevRefreshMs) / 1000.0;
+    m_prevRefreshMs = now;
+
+    m_snapshot.clear();
+    {
+        // Raw copy under the lock; formatting happens after it is released
+        QMutexLocker lock(&m_mutex);
+        m_snapshot.reserve(m_table.size());
+        for (const CanStatsTable::Entry& e : m_table.slots()) {
+            if (!e.used) continue;
+            CanStatsModel::Row r;
+            r.key = e.key;
+            r.count = e.count;
+            r.periodMs = e.meanDtNs / 1e6;
+            r.jitterMs = e.jitterNs / 1e6;
+            r.ageMs = now - e.lastRxMs;
+            r.dlc = e.dlc;
+            r.size = e.size;
+            std::memcpy(r.data, e.data, sizeof(r.data));
+            m_snapshot.append(std::move(r));
+        }
+    }
+    for (CanStatsModel::Row& r : m_snapshot) {
+        quint64& prev = m_prevCount[r.key];
+        r.rate = (r.count - prev) / dtSec;
+        prev = r.count;
+        r.dataHex = QString::fromLatin1(QByteArray::fromRawData(reinterpret_cast<const char*>(r.data), r.size).toHex(' ').toUpper());
+    }
+
+    for (int b = 0; b < kBuses; ++b) {
+        const quint64 bits = m_busBits[b].load(std::memory_order_relaxed);
+        m_load[b] = qMin(100.0, 100.0 * (bits - m_prevBusBits[b]) / (m_bitrate[b] * dtSec));
+        m_prevBusBits[b] = bits;
+    }
+
+    m_model.update(m_snapshot);
+    emit statsChanged();
+}
+
+void CanStatsBackend::reset()
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        m_table.clear();
+    }
+    m_prevCount.clear();
+    m_model.clear();
+    emit statsChanged();
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVariantList>
+#include <QVector>
+#include <atomic>
+#include <vector>
+
+#include "../proto/HMI_RX_CAN.pb.h"   // can_stream::CanBatch
+
+class GlobalReceiver;
+
+// Per-(bus, ID) traffic statistics, updated on the RX thread for every frame. Open addressing with
+// linear probing over a power-of-two array of 64-byte slots: a frame costs one multiply-shift hash
+// and (almost always) one cache line. The table only grows when a new ID pushes it past half full.
+class CanStatsTable
+{
+public:
+    struct Entry
+    {
+        quint32 key = 0;            // bus << 30 | extended << 29 | id
+        quint32 used = 0;
+        quint64 count = 0;
+        quint64 lastTsNs = 0;
+        qint64 lastRxMs = 0;        // receiver clock, for "gone silent"
+        float meanDtNs = 0;         // EWMA of the inter-arrival time
+        float jitterNs = 0;         // EWMA of |dt - mean|
+        quint8 dlc = 0;
+        quint8 size = 0;
+        uchar data[8] = {};
+        quint8 pad[14] = {};
+    };
+    static_assert(sizeof(Entry) == 64, "one entry per cache line");
+
+    static quint32 makeKey(quint32 bus, quint32 id, bool extended)
+    {
+        return (bus & 3u) << 30 | (extended ? 1u << 29 : 0u) | (id & 0x1FFFFFFF);
+    }
+
+    CanStatsTable() { clear(); }
+    void clear();
+    void add(const can_stream::CanEvent& ev, qint64 rxMs);
+
+    int size() const { return m_size; }
+    const std::vector<Entry>& slots() const { return m_slots; }
+
+private:
+    Entry& slotFor(quint32 key);
+    void grow();
+
+    std::vector<Entry> m_slots;
+    int m_shift = 0;    // 32 - log2(capacity)
+    int m_size = 0;
+};
+
+// Sortable view of the table for LoggerPage; rows are refreshed in place a few times per second.
+class CanStatsModel final : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QString sortKey READ sortKey WRITE setSortKey NOTIFY sortKeyChanged)
+
+public:
+    enum Roles {
+        BusIdRole = Qt::UserRole + 1,
+        CanIdTextRole,
+        CountRole,
+        RateRole,           // frames/s over the last refresh interval
+        PeriodMsRole,       // mean inter-arrival from ts_ns
+        JitterMsRole,
+        AgeMsRole,          // since the last frame was received
+        SilentRole,         // no frame for several periods
+        DlcRole,
+        DataHexRole
+    };
+
+    struct Row
+    {
+        quint32 key = 0;
+        quint64 count = 0;
+        double rate = 0;
+        double periodMs = 0;
+        double jitterMs = 0;
+        qint64 ageMs = 0;
+        quint8 dlc = 0;
+        quint8 size = 0;
+        uchar data[8] = {};        // raw payload; dataHex is built from it outside the table lock
+        QString dataHex;
+    };
+
+    explicit CanStatsModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // "id" (default), "rate", "jitter" or "age"
+    QString sortKey() const { return m_sortKey; }
+    void setSortKey(const QString& key);
+
+    void clear();
+    // Merges a snapshot (any order) into the rows, then re-sorts
+    void update(QVector<Row>& snapshot);
+
+signals:
+    void sortKeyChanged();
+
+private:
+    void sortRows();
+
+    QVector<Row> m_rows;
+    QHash<quint32, int> m_rowOf;
+    QString m_sortKey = QStringLiteral("id");
+};
+
+// Live CAN statistics: per-ID counters, rate, period and jitter, plus an estimated load per bus.
+// Counting happens on the RX thread (direct connection); a GUI timer snapshots the table into the
+// model at refreshHz. Load is the nominal frame length (SOF through IFS, no stuff bits) of all
+// frames seen on a bus divided by its configured bitrate, so it reads slightly low.
+class CanStatsBackend final : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QObject* model READ model CONSTANT)
+    Q_PROPERTY(QVariantList busLoad READ busLoad NOTIFY statsChanged)   // percent per bus 0..3
+    Q_PROPERTY(int idCount READ idCount NOTIFY statsChanged)
+
+public:
+    static constexpr int kBuses = 4;
+
+    explicit CanStatsBackend(QObject* parent = nullptr);
+
+    // Subscribe to the receiver's CAN batches (direct: onCanBatch() runs on the RX thread)
+    void attach(GlobalReceiver* rx);
+
+    QObject* model() { return &m_model; }
+    QVariantList busLoad() const;
+    int idCount() const { return m_model.rowCount(); }
+
+    Q_INVOKABLE void reset();
+
+    // Thread-safe; called on the receiver thread
+    void onCanBatch(const can_stream::CanBatch& batch);
+
+signals:
+    void statsChanged();
+
+private slots:
+    void refresh();
+
+private:
+    CanStatsModel m_model;
+    QTimer m_refreshTimer;
+    QElapsedTimer m_clock;
+
+    // Shared with the RX thread
+    QMutex m_mutex;
+    CanStatsTable m_table;
+    std::atomic<quint64> m_busBits[kBuses] = {};
+
+    // GUI thread
+    QHash<quint32, quint64> m_prevCount;
+    quint64 m_prevBusBits[kBuses] = {};
+    qint64 m_prevRefreshMs = 0;
+    double m_bitrate[kBuses] = {};
+    double m_load[kBuses] = {};
+    QVector<CanStatsModel::Row> m_snapshot;
+};
@@ -0,0 +1,151 @@
+#include "DbcDatabase.h"
+#include <QFile>
+#include <QRegularExpression>
+#include <QSet>
+
+bool DbcDatabase::load(const QString& path, QString* error)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        if (error) *error = f.errorString();
+        return false;
+    }
+    return parse(f.readAll(), error);
+}
+
+bool DbcDatabase::parse(const QByteArray& text, QString* error)
+{
+    static const QRegularExpression boRe(QStringLiteral("^BO_\\s+(\\d+)\\s+(\\w+)\\s*:\\s*(\\d+)"));
+    static const QRegularExpression sgRe(QStringLiteral(
+        "^SG_\\s+(\\w+)\\s*(M|m\\d+M?)?\\s*:\\s*(\\d+)\\|(\\d+)@([01])([+-])\\s*"
+        "\\(\\s*([^,\\s]+)\\s*,\\s*([^)\\s]+)\\s*\\)\\s*\\[\\s*([^|\\s]*)\\s*\\|\\s*([^\\]\\s]*)\\s*\\]\\s*\"([^\"]*)\""));
+    static const QRegularExpression mulValRe(QStringLiteral("^SG_MUL_VAL_\\s+(\\d+)\\s+(\\w+)\\s+(\\w+)"));
+
+    QVector<Message> messages;
+    QVector<Signal> sigs;
+    int current = -1;   // message the following SG_ lines belong to
+    QHash<quint64, int> messageByRawId;
+    QSet<int> nested;   // signals switched by a nested multiplexor (extended multiplexing)
+
+    const QList<QByteArray> lines = text.split('\n');
+    for (int n = 0; n < lines.size(); ++n) {
+        const QString line = QString::fromLatin1(lines.at(n)).trimmed();
+        if (line.startsWith(QLatin1String("BO_ "))) {
+            const QRegularExpressionMatch m = boRe.match(line);
+            if (!m.hasMatch()) {
+                if (error) *error = QStringLiteral("line %1: malformed BO_").arg(n + 1);
+                return false;
+            }
+            const quint64 rawId = m.captured(1).toULongLong();
+            current = -1;
+            if (rawId == 0xC0000000ULL)   // VECTOR__INDEPENDENT_SIG_MSG: signal parking lot
+                continue;
+            Message msg;
+            msg.extended = (rawId & 0x80000000ULL) != 0;
+            msg.canId = static_cast<quint32>(rawId & 0x1FFFFFFF);
+            msg.name = m.captured(2);
+            msg.dlc = static_cast<quint8>(qMin(m.captured(3).toUInt(), 64u));
+            msg.firstSignal = sigs.size();
+            messages.append(msg);
+            current = messages.size() - 1;
+            messageByRawId.insert(rawId, current);
+            continue;
+        }
+        if (line.startsWith(QLatin1String("SG_MUL_VAL_ "))) {
+            // SG_MUL_VAL_ <id> <signal> <switch> <ranges>; after all BO_ blocks
+            const QRegularExpressionMatch m = mulValRe.match(line);
+            const int msgIndex = m.hasMatch() ? messageByRawId.value(m.captured(1).toULongLong(), -1) : -1;
+            if (msgIndex < 0) continue;
+            const Message& msg = messages.at(msgIndex);
+            int signal = -1;
+            int muxSwitch = -1;
+            for (int i = msg.firstSignal; i < msg.firstSignal + msg.signalCount; ++i) {
+                if (sigs.at(i).name == m.captured(2)) signal = i;
+                if (sigs.at(i).name == m.captured(3)) muxSwitch = i;
+            }
+            if (signal >= 0 && muxSwitch >= 0 && muxSwitch != msg.muxSignal)
+                nested.insert(signal);
+            continue;
+        }
+        if (!line.startsWith(QLatin1String("SG_ ")) || current < 0)
+            continue;
+
+        const QRegularExpressionMatch m = sgRe.match(line);
+        if (!m.hasMatch()) {
+            if (error) *error = QStringLiteral("line %1: malformed SG_").arg(n + 1);
+            return false;
+        }
+        Signal s;
+        s.name = m.captured(1);
+        const QString mux = m.captured(2);
+        const int start = m.captured(3).toInt();
+        const int length = m.captured(4).toInt();
+        s.bigEndian = m.captured(5) == QLatin1String("0");
+        s.isSigned = m.captured(6) == QLatin1String("-");
+        s.scale = m.captured(7).toDouble();
+        s.offset = m.captured(8).toDouble();
+        s.minimum = m.captured(9).toDouble();
+        s.maximum = m.captured(10).toDouble();
+        s.unit = m.captured(11);
+        if (length < 1 || length > 64 || start < 0 || start > 63)
+            continue;   // CAN FD payloads beyond 8 bytes are not decoded
+        s.length = static_cast<quint8>(length);
+        s.mask = length == 64 ? ~quint64(0) : ((quint64(1) << length) - 1);
+
+        int shift;
+        if (!s.bigEndian) {
+            // Intel: start is the LSB's bit number in the little-endian word
+            shift = start;
+            if (start + length > 64) continue;
+        } else {
+            // Motorola: start is the MSB in DBC "sawtooth" numbering; in the big-endian word
+            // byte k bit b sits at position (k * 8 + 7 - b) counted from the most significant bit
+            const int msb = (start / 8) * 8 + (7 - start % 8);
+            const int lsb = msb + length - 1;
+            if (lsb > 63) continue;
+            shift = 63 - lsb;
+        }
+        s.shift = static_cast<quint8>(shift);
+
+        Message& msg = messages[current];
+        if (mux == QLatin1String("M"))
+            msg.muxSignal = sigs.size();
+        else if (!mux.isEmpty())   // "m3" or, flattened, the nested switch "m3M"
+            s.muxValue = static_cast<qint16>(mux.mid(1, mux.endsWith(QLatin1Char('M')) ? mux.size() - 2 : -1).toInt());
+        sigs.append(s);
+        ++msg.signalCount;
+    }
+
+    if (!nested.isEmpty()) {
+        // Drop the nested signals; indices shift, so rebuild each message's range and multiplexor
+        QVector<Signal> kept;
+        kept.reserve(sigs.size() - nested.size());
+        for (Message& msg : messages) {
+            const int first = kept.size();
+            int muxSignal = -1;
+            for (int i = msg.firstSignal; i < msg.firstSignal + msg.signalCount; ++i) {
+                if (nested.contains(i)) continue;
+                if (i == msg.muxSignal) muxSignal = kept.size();
+                kept.append(sigs.at(i));
+            }
+            msg.firstSignal = first;
+            msg.signalCount = kept.size() - first;
+            msg.muxSignal = muxSignal;
+        }
+        sigs = kept;
+    }
+
+    m_messages = messages;
+    m_signals = sigs;
+    m_standard.assign(2048, -1);
+    m_extended.clear();
+    for (int i = 0; i < m_messages.size(); ++i) {
+        const Message& msg = m_messages.at(i);
+        if (msg.extended)
+            m_extended.insert(msg.canId, i);
+        else if (msg.canId < 2048)
+            m_standard[msg.canId] = i;
+    }
+    if (error) error->clear();
+    return true;
+}
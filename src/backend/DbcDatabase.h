@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include <cstring>
+#include <vector>
+
+// CAN database (.dbc) compiled into flat decode tables. Parsing resolves everything a decode needs
+// (which 64-bit word to read, shift, mask, sign, scale, offset) so decoding a frame is a table lookup
+// followed by shift-and-mask per signal.
+//
+// Supported: BO_/SG_ lines, Intel (@1) and Motorola (@0) byte order, signed/unsigned, simple
+// multiplexing (M / mN). Extended multiplexing is flattened: a nested switch (mNM) decodes as a
+// plain mN signal and the signals SG_MUL_VAL_ puts under a nested switch are skipped. Not
+// supported: float signals (SIG_VALTYPE_) and value tables; those decode as plain integers.
+class DbcDatabase
+{
+public:
+    struct Signal
+    {
+        QString name;
+        QString unit;
+        double scale = 1.0;
+        double offset = 0.0;
+        double minimum = 0.0;
+        double maximum = 0.0;
+        quint64 mask = 0;
+        quint8 shift = 0;
+        quint8 length = 0;
+        bool bigEndian = false;    // read from the big-endian word
+        bool isSigned = false;
+        qint16 muxValue = -1;      // >= 0: only present when the message's multiplexor equals it
+    };
+    struct Message
+    {
+        QString name;
+        quint32 canId = 0;
+        bool extended = false;
+        quint8 dlc = 0;
+        int firstSignal = 0;       // into signals(); signal indices are stable per database
+        int signalCount = 0;
+        int muxSignal = -1;        // absolute index of the multiplexor, or -1
+    };
+
+    bool load(const QString& path, QString* error = nullptr);
+    bool parse(const QByteArray& text, QString* error = nullptr);
+
+    const QVector<Message>& messages() const { return m_messages; }
+    const QVector<Signal>& signalDefs() const { return m_signals; }
+
+    // Message index for a frame, or -1
+    int findMessage(quint32 canId, bool extended) const
+    {
+        if (!extended)
+            return canId < 2048 ? m_standard[canId] : -1;
+        return m_extended.value(canId, -1);
+    }
+
+    // Raw integer of `s` in a frame whose payload was loaded with loadWords()
+    static qint64 extract(const Signal& s, quint64 le, quint64 be)
+    {
+        const quint64 raw = ((s.bigEndian ? be : le) >> s.shift) & s.mask;
+        if (s.isSigned && s.length < 64 && (raw >> (s.length - 1)) & 1)
+            return static_cast<qint64>(raw | ~s.mask);
+        return static_cast<qint64>(raw);
+    }
+    static double physical(const Signal& s, qint64 raw) { return static_cast<double>(raw) * s.scale + s.offset; }
+
+    // The payload (zero-padded to 8 bytes) as little- and big-endian 64-bit words
+    static void loadWords(const uchar* data, int size, quint64& le, quint64& be)
+    {
+        uchar b[8] = {};
+        std::memcpy(b, data, static_cast<size_t>(qBound(0, size, 8)));
+        le = be = 0;
+        for (int i = 7; i >= 0; --i) le = (le << 8) | b[i];
+        for (int i = 0; i < 8; ++i) be = (be << 8) | b[i];
+    }
+
+private:
+    QVector<Message> m_messages;
+    QVector<Signal> m_signals;
+    std::vector<qint32> m_standard = std::vector<qint32>(2048, -1);
+    QHash<quint32, int> m_extended;
+};
@@ -1,12 +1,110 @@
 #include "GlobalReceiver.h"
+#include "ShmRing.h"
+#include <QDateTime>
 #include <QHostAddress>
 #include <QtEndian>
 #include <QDebug>
+#include <QMetaMethod>
+#include <cstring>
+#include <limits>
 
-GlobalReceiver::GlobalReceiver(QObject* parent) : QObject(parent) {}
+GlobalReceiver::GlobalReceiver(QObject* parent) : QObject(parent)
+{
+    registerMetaTypes();
+    m_clock.start();
+    m_metricsTimer = new QTimer(this);
+    m_metricsTimer->setInterval(kMetricsIntervalMs);
+    connect(m_metricsTimer, &QTimer::timeout, this, &GlobalReceiver::publishMetrics);
+    m_udpIdleTimer = new QTimer(this);
+    m_udpIdleTimer->setSingleShot(true);
+    m_udpIdleTimer->setInterval(kUdpIdleMs);
+    connect(m_udpIdleTimer, &QTimer::timeout, this, &GlobalReceiver::onUdpIdle);
+    m_shmTimer = new QTimer(this);
+    m_shmTimer->setTimerType(Qt::PreciseTimer);
+    m_shmTimer->setInterval(kShmPollMs);
+    connect(m_shmTimer, &QTimer::timeout, this, &GlobalReceiver::pollShm);
+    m_replayTimer = new QTimer(this);
+    m_replayTimer->setSingleShot(true);
+    m_replayTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_replayTimer, &QTimer::timeout, this, &GlobalReceiver::replayStep);
+}
+
+GlobalReceiver::~GlobalReceiver()
+{
+    m_capture.close();
+    // Finishes open and closing session files (waits for their writer threads)
+    m_session.reset();
+    m_closingSessions.clear();
+    qDeleteAll(m_conns);
+}
+
+void GlobalReceiver::registerMetaTypes()
+{
+    qRegisterMetaType<vehicle_msgs::Navigation>();
+    qRegisterMetaType<vehicle_msgs::CameraBatch>();
+    qRegisterMetaType<vehicle_msgs::Controls>();
+    qRegisterMetaType<can_stream::CanBatch>();
+    qRegisterMetaType<hmi::perception::v1::PerceptionFrame>();
+    qRegisterMetaType<RxStreamMetrics>();
+    qRegisterMetaType<QVector<RxStreamMetrics>>();
+}
 
 // === PUBLIC API ===
 bool GlobalReceiver::listenControls(quint16 port)
+{
+    return listenTcp(port, StreamKind::Controls);
+}
+
+bool GlobalReceiver::listenPerception(quint16 port)
+{
+    return listenTcp(port, StreamKind::Perception);
+}
+
+bool GlobalReceiver::listenLogger(quint16 port)
+{
+    return listenTcp(port, StreamKind::Logger);
+}
+
+bool GlobalReceiver::listenControlsUdp(quint16 port, const QString& multicastGroup)
+{
+    return listenUdp(port, StreamKind::Controls, multicastGroup);
+}
+
+bool GlobalReceiver::listenPerceptionUdp(quint16 port, const QString& multicastGroup)
+{
+    return listenUdp(port, StreamKind::Perception, multicastGroup);
+}
+
+bool GlobalReceiver::listenControlsShm(const QString& name)
+{
+    return listenShm(name, StreamKind::Controls);
+}
+
+bool GlobalReceiver::listenPerceptionShm(const QString& name)
+{
+    return listenShm(name, StreamKind::Perception);
+}
+
+bool GlobalReceiver::listenLoggerShm(const QString& name)
+{
+    return listenShm(name, StreamKind::Logger);
+}
+
+void GlobalReceiver::setStreamLimits(StreamKind kind, const StreamLimits& limits)
+{
+    StreamLimits l = limits;
+    l.maxFrameBytes = qBound(1, l.maxFrameBytes, std::numeric_limits<int>::max() - 4);
+    // A complete frame (prefix included) must always fit, or the connection could never make progress
+    l.maxBufferedBytes = qMax<qint64>(l.maxBufferedBytes, static_cast<qint64>(l.maxFrameBytes) + 4);
+    m_limits[static_cast<size_t>(kind)] = l;
+
+    for (ConnState* st : std::as_const(m_conns)) {
+        if (st && st->sock && m_portKinds.value(st->port, StreamKind::Controls) == kind)
+            st->sock->setReadBufferSize(l.maxBufferedBytes);
+    }
+}
+
+bool GlobalReceiver::listenTcp(quint16 port, StreamKind kind)
 {
     if (m_servers.contains(port)) return true; // already listening
 
@@ -17,46 +115,391 @@ bool GlobalReceiver::listenControls(quint16 port)
         return false;
     }
     m_servers.insert(port, srv);
-    m_portKinds.insert(port, StreamKind::Controls);
+    m_portKinds.insert(port, kind);
+    statsFor(kind).port = port;
+    m_transports[static_cast<size_t>(kind)] = QStringLiteral("tcp");
+    startMetrics();
 
     connect(srv, &QTcpServer::newConnection, this, &GlobalReceiver::onNewConnection);
-    qInfo() << "[GlobalReceiver] Listening Controls on" << port;
+    switch (kind) {
+    case StreamKind::Controls:   qInfo() << "[GlobalReceiver] Listening Controls on" << port; break;
+    case StreamKind::Perception: qInfo() << "[GlobalReceiver] Listening Perception on" << port; break;
+    case StreamKind::Logger:     qInfo() << "[GlobalReceiver] Listening Logger (CAN) on" << port; break;
+    }
     return true;
 }
 
-bool GlobalReceiver::listenPerception(quint16 port)
+bool GlobalReceiver::listenUdp(quint16 port, StreamKind kind, const QString& multicastGroup)
 {
-    if (m_servers.contains(port)) return true;
+    if (m_udp.contains(port)) return true; // already listening
+
+    QHostAddress group;
+    if (!multicastGroup.isEmpty()) {
+        if (!group.setAddress(multicastGroup) || !group.isMulticast()
+            || group.protocol() != QAbstractSocket::IPv4Protocol) {
+            qWarning() << "[GlobalReceiver] Invalid IPv4 multicast group" << multicastGroup;
+            return false;
+        }
+    }
 
-    auto* srv = new QTcpServer(this);
-    if (!srv->listen(QHostAddress::Any, port)) {
-        qWarning() << "[GlobalReceiver] Failed to listen on port" << port << srv->errorString();
-        srv->deleteLater();
+    auto* sock = new QUdpSocket(this);
+    if (!sock->bind(QHostAddress::AnyIPv4, port, QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint)) {
+        qWarning() << "[GlobalReceiver] Failed to bind UDP port" << port << sock->errorString();
+        sock->deleteLater();
         return false;
     }
-    m_servers.insert(port, srv);
-    m_portKinds.insert(port, StreamKind::Perception);
-    connect(srv, &QTcpServer::newConnection, this, &GlobalReceiver::onNewConnection);
-    qInfo() << "[GlobalReceiver] Listening Perception on" << port;
+    if (!group.isNull() && !sock->joinMulticastGroup(group)) {
+        qWarning() << "[GlobalReceiver] Failed to join multicast group" << multicastGroup
+                   << "on port" << port << sock->errorString();
+        sock->deleteLater();
+        return false;
+    }
+
+    UdpState st;
+    st.sock = sock;
+    st.port = port;
+    m_udp.insert(port, st);
+    m_portKinds.insert(port, kind);
+    statsFor(kind).port = port;
+    m_transports[static_cast<size_t>(kind)] = QStringLiteral("udp");
+    startMetrics();
+
+    connect(sock, &QUdpSocket::readyRead, this, &GlobalReceiver::onDatagramsReady);
+    const char* name = (kind == StreamKind::Perception) ? "Perception" : "Controls";
+    if (group.isNull())
+        qInfo() << "[GlobalReceiver] Listening" << name << "on UDP" << port;
+    else
+        qInfo() << "[GlobalReceiver] Listening" << name << "on UDP" << port << "multicast" << multicastGroup;
     return true;
 }
 
-bool GlobalReceiver::listenLogger(quint16 port)
+bool GlobalReceiver::listenShm(const QString& name, StreamKind kind)
 {
-    if (m_servers.contains(port)) return true;
-    auto* srv = new QTcpServer(this);
-    if (!srv->listen(QHostAddress::Any, port)) {
-        qWarning() << "[GlobalReceiver] Failed to listen on port" << port << srv->errorString();
-        srv->deleteLater();
+    if (!ShmRingSegment::isSupported()) {
+        qWarning() << "[GlobalReceiver] Shared-memory transport not available on this platform:" << name;
         return false;
     }
-    m_servers.insert(port, srv);
-    m_portKinds.insert(port, StreamKind::Logger);
-    connect(srv, &QTcpServer::newConnection, this, &GlobalReceiver::onNewConnection);
-    qInfo() << "[GlobalReceiver] Listening Logger (CAN) on" << port;
+    for (const ShmState& s : m_shm) {
+        if (s.kind == kind) return true; // already listening
+    }
+    if (!name.startsWith(QLatin1Char('/')) || name.indexOf(QLatin1Char('/'), 1) >= 0) {
+        qWarning() << "[GlobalReceiver] Invalid shared-memory name" << name << "(expected /name)";
+        return false;
+    }
+
+    ShmState st;
+    st.kind = kind;
+    st.name = name;
+    st.ring = std::make_unique<ShmRingConsumer>();
+    m_shm.push_back(std::move(st));
+    statsFor(kind).port = 0;
+    m_transports[static_cast<size_t>(kind)] = QStringLiteral("shm");
+    startMetrics();
+    if (!m_shmTimer->isActive())
+        m_shmTimer->start();
+
+    switch (kind) {
+    case StreamKind::Controls:   qInfo() << "[GlobalReceiver] Listening Controls on shm" << name; break;
+    case StreamKind::Perception: qInfo() << "[GlobalReceiver] Listening Perception on shm" << name; break;
+    case StreamKind::Logger:     qInfo() << "[GlobalReceiver] Listening Logger (CAN) on shm" << name; break;
+    }
+    pollShm();
+    return true;
+}
+
+void GlobalReceiver::pollShm()
+{
+    const qint64 now = m_clock.nsecsElapsed();
+    for (ShmState& s : m_shm) {
+        ShmRingConsumer& ring = *s.ring;
+        if (ring.isOpen() && now - s.lastActivityNs > static_cast<qint64>(kShmIdleMs) * 1000000) {
+            // The segment outlives its producer, so an open mapping says nothing about liveness.
+            // Detach and attach again right away: that maps a re-created segment, if any.
+            ring.close();
+            s.nextAttachNs = 0;
+            if (s.live) {
+                s.live = false;
+                qInfo() << "[GlobalReceiver] shm ring" << s.name << "idle, producer gone";
+                if (s.kind == StreamKind::Logger) {
+                    if (!hasLoggerConnection())
+                        m_loggerHasData = false;
+                    updateCanLoggerActive();
+                }
+            }
+        }
+        if (!ring.isOpen()) {
+            if (now < s.nextAttachNs) continue;
+            s.nextAttachNs = now + static_cast<qint64>(kShmAttachRetryMs) * 1000000;
+            if (!ring.open(s.name.toStdString()))
+                continue; // producer not up yet
+            if (s.lastActivityNs == 0)
+                qInfo() << "[GlobalReceiver] Attached shm ring" << s.name;
+            s.producerDropsSeen = ring.framesDropped();
+            s.corruptSeen = ring.corruptRecords();
+            s.publishedSeen = ring.framesWritten() + ring.framesDropped();
+            s.lastActivityNs = now;   // live only once the producer publishes something new
+        }
+
+        RxStreamCounters& stats = statsFor(s.kind);
+        const char* payload = nullptr;
+        quint32 len = 0;
+        int budget = kShmPollBudget;
+        while (budget-- > 0 && ring.peek(payload, len)) {
+            m_readStartNs = m_clock.nsecsElapsed();
+            stats.bytesTotal += static_cast<quint64>(len) + 4;
+            if (len > static_cast<quint32>(streamLimits(s.kind).maxFrameBytes)) {
+                ++stats.parseFailures;
+                stats.bytesDiscarded += len;
+            } else {
+                processFrame(s.kind, payload, static_cast<int>(len));
+            }
+            ring.release();
+        }
+
+        const quint64 drops = ring.framesDropped();
+        stats.datagramsLost += drops - s.producerDropsSeen;
+        s.producerDropsSeen = drops;
+        const quint64 corrupt = ring.corruptRecords();
+        stats.resyncs += corrupt - s.corruptSeen;
+        s.corruptSeen = corrupt;
+
+        const quint64 published = ring.framesWritten() + drops;
+        if (published != s.publishedSeen) {
+            s.publishedSeen = published;
+            s.lastActivityNs = now;
+            if (!s.live) {
+                s.live = true;
+                if (s.kind == StreamKind::Logger)
+                    updateCanLoggerActive();
+            }
+        }
+    }
+}
+
+bool GlobalReceiver::startCapture(const QString& path)
+{
+    if (!m_capture.open(path)) {
+        qWarning() << "[GlobalReceiver] Cannot open capture file" << path << m_capture.errorString();
+        return false;
+    }
+    m_captureStartNs = m_clock.nsecsElapsed();
+    startMetrics(); // also flushes the capture every interval
+    qInfo() << "[GlobalReceiver] Capturing RX payloads to" << path;
+    return true;
+}
+
+void GlobalReceiver::stopCapture()
+{
+    if (!m_capture.isOpen()) return;
+    const quint64 n = m_capture.records();
+    m_capture.close();
+    qInfo() << "[GlobalReceiver] Capture closed," << n << "records";
+}
+
+bool GlobalReceiver::startSession(const QString& path)
+{
+    stopSession();
+    auto writer = std::make_unique<SessionWriter>();
+    SessionWriter* w = writer.get();
+    auto onFinished = [this, w](const QString& finalPath, bool ok) {
+        // Writer thread: the writer is joined and deleted back on the receiver thread
+        QMetaObject::invokeMethod(this, [this, w, finalPath, ok]() { onSessionWriterFinished(w, finalPath, ok); },
+                                  Qt::QueuedConnection);
+    };
+    QString error;
+    if (!writer->start(path, QDateTime::currentMSecsSinceEpoch(), SessionWriter::Config(), onFinished, &error)) {
+        qWarning() << "[GlobalReceiver] Cannot open session file" << path << error;
+        emit sessionFailed(path, error);
+        return false;
+    }
+    m_session = std::move(writer);
+    m_sessionStartNs = m_clock.nsecsElapsed();
+    startMetrics(); // also reports sessionProgress every interval
+    qInfo() << "[GlobalReceiver] Recording session to" << path;
+    emit sessionStarted(path);
+    return true;
+}
+
+void GlobalReceiver::stopSession(bool discard)
+{
+    if (!m_session) return;
+    qInfo() << "[GlobalReceiver] Session" << (discard ? "discarded," : "closing,") << m_session->records() << "records,"
+            << m_session->droppedRecords() << "dropped";
+    m_session->stop(discard);
+    m_closingSessions.push_back(std::move(m_session));
+}
+
+void GlobalReceiver::onSessionWriterFinished(SessionWriter* writer, const QString& path, bool ok)
+{
+    for (auto it = m_closingSessions.begin(); it != m_closingSessions.end(); ++it) {
+        if (it->get() == writer) {
+            (*it)->wait();   // run() has returned; only the thread exit is left
+            m_closingSessions.erase(it);
+            break;
+        }
+    }
+    if (ok)
+        qInfo() << "[GlobalReceiver] Session written to" << path;
+    emit sessionFinished(path, ok);
+}
+
+void GlobalReceiver::recordSessionFrame(StreamKind kind, const char* payload, int size)
+{
+    const quint64 tNs = static_cast<quint64>(m_readStartNs - m_sessionStartNs);
+    switch (kind) {
+    case StreamKind::Controls:
+        // One channel per message type; the type byte is not part of the protobuf payload
+        if (size >= 1 && payload[0] >= 0x01 && payload[0] <= 0x03)
+            m_session->append(tNs, static_cast<quint16>(SessionContainer::Navigation + payload[0] - 0x01),
+                             payload + 1, size - 1);
+        break;
+    case StreamKind::Logger:
+        m_session->append(tNs, SessionContainer::CanBatch, payload, size);
+        break;
+    case StreamKind::Perception:
+        m_session->append(tNs, SessionContainer::Perception, payload, size);
+        break;
+    default:
+        break;
+    }
+}
+
+bool GlobalReceiver::nextReplayRecord()
+{
+    if (!m_sessionReplay.isOpen())
+        return m_replay.next(m_replayNext);
+
+    // Map the session record back onto the stream frame the parser expects
+    SessionContainer::Record rec;
+    while (m_sessionReplay.next(rec)) {
+        m_replayNext.tNs = static_cast<qint64>(rec.tNs);
+        m_replayNext.port = 0;
+        if (rec.channel <= SessionContainer::Controls) {
+            m_replayFrame.resize(rec.size + 1);
+            m_replayFrame[0] = static_cast<char>(0x01 + rec.channel);
+            std::memcpy(m_replayFrame.data() + 1, rec.payload, static_cast<size_t>(rec.size));
+            m_replayNext.kind = static_cast<quint8>(StreamKind::Controls);
+            m_replayNext.payload = m_replayFrame.constData();
+            m_replayNext.size = static_cast<int>(m_replayFrame.size());
+        } else if (rec.channel == SessionContainer::CanBatch || rec.channel == SessionContainer::Perception) {
+            m_replayNext.kind = static_cast<quint8>(rec.channel == SessionContainer::CanBatch
+                                                        ? StreamKind::Logger : StreamKind::Perception);
+            m_replayNext.payload = rec.payload;
+            m_replayNext.size = rec.size;
+        } else {
+            continue;   // channel from a newer writer
+        }
+        return true;
+    }
+    return false;
+}
+
+void GlobalReceiver::rewindReplay()
+{
+    if (m_sessionReplay.isOpen())
+        m_sessionReplay.rewind();
+    else
+        m_replay.rewind();
+}
+
+bool GlobalReceiver::startReplay(const QString& path, double speed, bool loop)
+{
+    stopReplay();
+    const bool session = path.endsWith("." + SessionContainer::fileSuffix(), Qt::CaseInsensitive);
+    if (session ? !m_sessionReplay.open(path) : !m_replay.open(path)) {
+        qWarning() << "[GlobalReceiver] Cannot replay" << path
+                   << (session ? m_sessionReplay.errorString() : m_replay.errorString());
+        return false;
+    }
+    m_replaySpeed = speed;
+    m_replayLoop = loop;
+    m_replayHaveNext = nextReplayRecord();
+    if (!m_replayHaveNext) {
+        qWarning() << "[GlobalReceiver] Capture" << path << "contains no records";
+        stopReplay();
+        return false;
+    }
+    m_replayBaseNs = m_replayNext.tNs;
+    m_replayStartNs = m_clock.nsecsElapsed();
+    startMetrics();
+    qInfo() << "[GlobalReceiver] Replaying" << path << "speed" << (speed > 0 ? speed : 0.0)
+            << (loop ? "(loop)" : "");
+    m_replayTimer->start(0);
     return true;
 }
 
+void GlobalReceiver::stopReplay()
+{
+    m_replayTimer->stop();
+    m_replayHaveNext = false;
+    m_replay.close();
+    m_sessionReplay.close();
+}
+
+void GlobalReceiver::replayStep()
+{
+    const bool asap = m_replaySpeed <= 0.0;
+    int budget = kReplayBatch;
+    m_replaying = true;
+    while (m_replayHaveNext) {
+        const qint64 now = m_clock.nsecsElapsed();
+        if (!asap) {
+            const qint64 dueNs = m_replayStartNs
+                + static_cast<qint64>((m_replayNext.tNs - m_replayBaseNs) / m_replaySpeed);
+            if (dueNs > now) {
+                // Sleep until the next record, rounded up so a sub-millisecond wait doesn't spin
+                m_replayTimer->start(static_cast<int>((dueNs - now + 999999) / 1000000));
+                break;
+            }
+        }
+        if (budget-- <= 0) {
+            // A dense burst is all due at once even in timed mode; let sockets and timers run
+            m_replayTimer->start(0);
+            break;
+        }
+
+        if (m_replayNext.kind < m_transports.size()) {
+            const auto kind = static_cast<StreamKind>(m_replayNext.kind);
+            QString& transport = m_transports[m_replayNext.kind];
+            if (transport.isEmpty())
+                transport = QStringLiteral("replay");
+            m_readStartNs = now;
+            statsFor(kind).bytesTotal += static_cast<quint64>(m_replayNext.size);
+            processFrame(kind, m_replayNext.payload, m_replayNext.size);
+        }
+
+        m_replayHaveNext = nextReplayRecord();
+        if (!m_replayHaveNext && m_replayLoop) {
+            rewindReplay();
+            m_replayHaveNext = nextReplayRecord();
+            m_replayBaseNs = m_replayNext.tNs;
+            m_replayStartNs = m_clock.nsecsElapsed();
+            // The first record of the next pass is due immediately; yield before starting it
+            if (m_replayHaveNext) {
+                m_replayTimer->start(0);
+                break;
+            }
+        }
+    }
+    m_replaying = false;
+
+    if (!m_replayHaveNext) {
+        qInfo() << "[GlobalReceiver] Replay finished";
+        m_replay.close();
+        m_sessionReplay.close();
+        emit replayFinished();
+    }
+}
+
+void GlobalReceiver::startMetrics()
+{
+    // Runs on the receiver thread, so the timer (a child moved along with us) can be started here
+    if (!m_metricsTimer->isActive()) {
+        m_lastMetricsNs = m_clock.nsecsElapsed();
+        m_metricsTimer->start();
+    }
+}
+
 void GlobalReceiver::onNewConnection()
 {
     auto* srv = qobject_cast<QTcpServer*>(sender());
@@ -65,8 +508,12 @@ void GlobalReceiver::onNewConnection()
 
     while (srv->hasPendingConnections()) {
         QTcpSocket* s = srv->nextPendingConnection();
-        auto* st = new ConnState{ s, QByteArray(), port };
+        auto* st = new ConnState;
+        st->sock = s;
+        st->port = port;
         m_conns.insert(s, st);
+        // Cap Qt's own socket buffer too; once full, the kernel window closes and the sender slows down
+        s->setReadBufferSize(streamLimits(m_portKinds.value(port, StreamKind::Controls)).maxBufferedBytes);
 
         connect(s, &QTcpSocket::readyRead, this, &GlobalReceiver::onReadyRead);
         connect(s, &QTcpSocket::disconnected, this, &GlobalReceiver::onDisconnected);
@@ -87,14 +534,35 @@ void GlobalReceiver::onReadyRead()
     if (!s || !m_conns.contains(s)) return;
 
     ConnState* st = m_conns.value(s);
-    st->buffer += s->readAll();
-
-    QByteArray frame;
-    const quint16 port = s->localPort();
-
-    while (tryPopFrame(st->port, st->buffer, frame)) {
-        processFrame(st->port, frame);
-        frame.clear();
+    const StreamKind kind = m_portKinds.value(st->port, StreamKind::Controls);
+    const qint64 maxBuffered = streamLimits(kind).maxBufferedBytes;
+    m_readStartNs = m_clock.nsecsElapsed();
+
+    // Read in chunks that keep the connection buffer under its cap; popping frames after each
+    // chunk frees room again (a partial frame is always smaller than the cap).
+    while (s->bytesAvailable() > 0) {
+        const qint64 room = maxBuffered - st->buffer.size();
+        const qint64 want = qMin(s->bytesAvailable(), room);
+        if (want <= 0) {
+            // Cannot happen with sane limits; drop the buffered bytes rather than grow without bound
+            qWarning() << "[GlobalReceiver] Port" << st->port << "buffer limit reached, dropping"
+                       << st->buffer.size() << "bytes";
+            statsFor(kind).bytesDiscarded += static_cast<quint64>(st->buffer.size());
+            ++statsFor(kind).resyncs;
+            st->buffer.clear();
+            continue;
+        }
+        char* dst = st->buffer.prepareWrite(static_cast<qsizetype>(want));
+        const qint64 n = s->read(dst, want);
+        if (n <= 0)
+            break;
+        st->buffer.commitWrite(static_cast<qsizetype>(n));
+        statsFor(kind).bytesTotal += static_cast<quint64>(n);
+
+        const char* frame = nullptr;
+        int frameLen = 0;
+        while (tryPopFrame(st->port, st->buffer, frame, frameLen))
+            processFrame(kind, frame, frameLen);
     }
 }
 
@@ -111,33 +579,149 @@ void GlobalReceiver::onDisconnected()
         updateCanLoggerActive();
     }
 
-    // LAN OFF when no active sockets remain
-    if (m_conns.isEmpty())
+    // LAN OFF when no active sockets remain and no datagrams are flowing
+    if (m_conns.isEmpty() && !m_udpIdleTimer->isActive())
         setLanConnected(false);
 
     s->deleteLater();
 }
 
+void GlobalReceiver::onDatagramsReady()
+{
+    auto* sock = qobject_cast<QUdpSocket*>(sender());
+    if (!sock) return;
+    auto it = m_udp.find(sock->localPort());
+    if (it == m_udp.end() || it->sock != sock) return;
+    UdpState* st = &it.value();
+
+    const StreamKind kind = m_portKinds.value(st->port, StreamKind::Controls);
+    RxStreamCounters& stats = statsFor(kind);
+    const qint64 maxFrame = streamLimits(kind).maxFrameBytes;
+
+    while (sock->hasPendingDatagrams()) {
+        const qint64 size = sock->pendingDatagramSize();
+        if (size < 0) break;
+        m_datagram.resize(static_cast<qsizetype>(size));
+        QHostAddress from;
+        quint16 fromPort = 0;
+        const qint64 n = sock->readDatagram(m_datagram.data(), size, &from, &fromPort);
+        if (n < 0) break;
+        m_readStartNs = m_clock.nsecsElapsed();
+        stats.bytesTotal += static_cast<quint64>(n);
+
+        if (n < 4 || n - 4 > maxFrame) {
+            ++stats.parseFailures;
+            stats.bytesDiscarded += static_cast<quint64>(n);
+            continue;
+        }
+        const quint32 seq = qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(m_datagram.constData()));
+        if (!acceptSequence(*st, seq, from, fromPort, stats)) {
+            stats.bytesDiscarded += static_cast<quint64>(n);
+            continue;
+        }
+
+        setLanConnected(true);
+        m_udpIdleTimer->start();
+        processFrame(kind, m_datagram.constData() + 4, static_cast<int>(n - 4));
+    }
+}
+
+// Newer-than-last check with 32-bit wraparound. Returns false for duplicates and late arrivals.
+bool GlobalReceiver::acceptSequence(UdpState& st, quint32 seq, const QHostAddress& from, quint16 fromPort,
+                                    RxStreamCounters& stats)
+{
+    if (st.haveSeq && (fromPort != st.senderPort || from != st.sender)) {
+        qInfo() << "[GlobalReceiver] UDP port" << st.port << "sender changed to"
+                << from.toString() << ":" << fromPort << ", restarting sequence";
+        st.haveSeq = false;
+    }
+    if (st.haveSeq) {
+        const qint32 delta = static_cast<qint32>(seq - st.lastSeq);
+        if (delta <= 0) {
+            ++stats.datagramsLate;
+            return false;
+        }
+        stats.datagramsLost += static_cast<quint64>(delta - 1);
+    }
+    st.haveSeq = true;
+    st.lastSeq = seq;
+    st.sender = from;
+    st.senderPort = fromPort;
+    return true;
+}
+
+void GlobalReceiver::onUdpIdle()
+{
+    // Sender went quiet: accept whatever sequence it restarts with
+    for (UdpState& st : m_udp)
+        st.haveSeq = false;
+    if (m_conns.isEmpty())
+        setLanConnected(false);
+}
+
 // Framing: Controls = 4-byte big-endian; Logger = 4-byte little-endian (TX sends LE length prefix)
-bool GlobalReceiver::tryPopFrame(quint16 port, QByteArray& buf, QByteArray& frame)
+quint32 GlobalReceiver::readLengthPrefix(StreamKind kind, const char* p) const
 {
-    if (buf.size() < 4) return false;
-    const StreamKind kind = m_portKinds.value(port, StreamKind::Controls);
-    quint32 len;
-    if (kind == StreamKind::Logger) {
-        len = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(buf.constData()));
-    } else {
-        len = qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(buf.constData()));
+    const uchar* head = reinterpret_cast<const uchar*>(p);
+    if (kind == StreamKind::Logger)
+        return qFromLittleEndian<quint32>(head);
+    return qFromBigEndian<quint32>(head);
+}
+
+// Could a frame start at p? Length must be within the stream's cap; on Controls the type byte must
+// also be known once it is visible. Used to find the next frame boundary after a corrupt prefix.
+bool GlobalReceiver::plausibleHeader(StreamKind kind, const char* p, qsizetype avail) const
+{
+    if (avail < 4) return true; // cannot tell yet
+    const quint32 len = readLengthPrefix(kind, p);
+    if (len > static_cast<quint32>(streamLimits(kind).maxFrameBytes))
+        return false;
+    if (kind == StreamKind::Controls) {
+        if (len < 1) return false;
+        if (avail >= 5) {
+            const quint8 type = static_cast<quint8>(p[4]);
+            return type >= 0x01 && type <= 0x03;
+        }
     }
-    if (buf.size() < 4 + static_cast<int>(len)) return false;
+    return true;
+}
 
-    frame = buf.mid(4, static_cast<int>(len));
-    buf.remove(0, 4 + static_cast<int>(len));
+void GlobalReceiver::resync(StreamKind kind, RxFrameBuffer& buf)
+{
+    // Slide one byte at a time until a plausible header (or too few bytes to judge) is at the front
+    RxStreamCounters& stats = statsFor(kind);
+    ++stats.resyncs;
+    qsizetype skipped = 1;
+    while (skipped < buf.size() && !plausibleHeader(kind, buf.data() + skipped, buf.size() - skipped))
+        ++skipped;
+    buf.consume(skipped);
+    stats.bytesDiscarded += static_cast<quint64>(skipped);
+    qWarning() << "[GlobalReceiver] Corrupt length prefix, discarded" << skipped << "bytes to resync";
+}
+
+bool GlobalReceiver::tryPopFrame(quint16 port, RxFrameBuffer& buf, const char*& frame, int& frameLen)
+{
+    const StreamKind kind = m_portKinds.value(port, StreamKind::Controls);
+    while (buf.size() >= 4 && !plausibleHeader(kind, buf.data(), buf.size()))
+        resync(kind, buf);
+    if (buf.size() < 4) return false;
+
+    const quint32 len = readLengthPrefix(kind, buf.data());
+    if (static_cast<quint64>(buf.size()) < 4ull + len) return false;
+
+    // View into the buffer; consume() only moves the cursor, so the bytes stay put for processFrame
+    frame = buf.data() + 4;
+    frameLen = static_cast<int>(len);
+    buf.consume(4 + static_cast<qsizetype>(len));
     return true;
 }
 
 bool GlobalReceiver::hasLoggerConnection() const
 {
+    for (const ShmState& s : m_shm) {
+        if (s.kind == StreamKind::Logger && s.ring->isOpen() && s.live)
+            return true;
+    }
     for (ConnState* st : m_conns.values()) {
         if (st && m_portKinds.value(st->port, StreamKind::Controls) == StreamKind::Logger)
             return true;
@@ -154,38 +738,67 @@ void GlobalReceiver::updateCanLoggerActive()
     }
 }
 
-void GlobalReceiver::processFrame(quint16 port, const QByteArray& payload)
+template <typename Msg>
+bool GlobalReceiver::parseTimed(Msg& msg, const char* data, int size, RxStreamCounters& stats)
+{
+    const qint64 t0 = m_clock.nsecsElapsed();
+    const bool ok = msg.ParseFromArray(data, size);
+    if (!ok) {
+        ++stats.parseFailures;
+        return false;
+    }
+    stats.parseNs.record(m_clock.nsecsElapsed() - t0);
+    return true;
+}
+
+void GlobalReceiver::noteDispatched(RxStreamCounters& stats)
+{
+    stats.dispatchNs.record(m_clock.nsecsElapsed() - m_readStartNs);
+}
+
+void GlobalReceiver::processFrame(StreamKind kind, const char* payload, int size)
 {
-    const auto kind = m_portKinds.value(port, StreamKind::Controls);
+    RxStreamCounters& stats = statsFor(kind);
+    ++stats.framesTotal;
+
+    if (m_capture.isOpen() && !m_replaying)
+        m_capture.append(m_readStartNs - m_captureStartNs, static_cast<quint8>(kind), stats.port, payload, size);
+    if (m_session && !m_replaying)
+        recordSessionFrame(kind, payload, size);
 
     switch (kind) {
     case StreamKind::Controls: {
-        emit controlsRaw(payload);
-        if (payload.size() < 1) return;
+        // Raw copy only when someone listens; the payload is a view into the receive buffer / shm ring
+        static const QMetaMethod rawSignal = QMetaMethod::fromSignal(&GlobalReceiver::controlsRaw);
+        if (isSignalConnected(rawSignal))
+            emit controlsRaw(QByteArray(payload, size));
+        if (size < 1) return;
 
         const quint8 type = static_cast<quint8>(payload[0]);
-        const QByteArray body = payload.mid(1);
+        const char* body = payload + 1;
+        const int bodySize = size - 1;
 
         if (type == 0x01) {
-            vehicle_msgs::Navigation nav;
-            if (!nav.ParseFromArray(body.constData(), body.size())) {
+            vehicle_msgs::Navigation& nav = m_navMsg;
+            if (!parseTimed(nav, body, bodySize, stats)) {
                 qWarning() << "[GlobalReceiver] Controls: failed to parse Navigation message";
                 return;
             }
             emit controlsMessage(nav);
+            noteDispatched(stats);
 
         } else if (type == 0x02) {
-            vehicle_msgs::CameraBatch batch;
-            if (!batch.ParseFromArray(body.constData(), body.size())) {
+            vehicle_msgs::CameraBatch& batch = m_cameraMsg;
+            if (!parseTimed(batch, body, bodySize, stats)) {
                 qWarning() << "[GlobalReceiver] Controls: failed to parse CameraBatch message";
-                qWarning() << "[GlobalReceiver] CameraBatch body size =" << body.size();
+                qWarning() << "[GlobalReceiver] CameraBatch body size =" << bodySize;
                 return;
             }
 
             qInfo() << "[GlobalReceiver] CameraBatch parsed:"
                     << "frames =" << batch.frames_size()
                     << "timestamp =" << batch.timestamp()
-                    << "body bytes =" << body.size();
+                    << "body bytes =" << bodySize;
 
             for (int i = 0; i < batch.frames_size(); ++i) {
                 const auto& f = batch.frames(i);
@@ -195,46 +808,107 @@ void GlobalReceiver::processFrame(quint16 port, const QByteArray& payload)
             }
 
             emit cameraBatchReceived(batch);
+            noteDispatched(stats);
 
         } else if (type == 0x03) {
-            vehicle_msgs::Controls ctl;
-            if (!ctl.ParseFromArray(body.constData(), body.size())) {
+            vehicle_msgs::Controls& ctl = m_controlsMsg;
+            if (!parseTimed(ctl, body, bodySize, stats)) {
                 qWarning() << "[GlobalReceiver] Controls: failed to parse Controls message";
                 return;
             }
             emit controlsStateReceived(ctl);
+            noteDispatched(stats);
 
         } else {
+            ++stats.parseFailures;
             qWarning() << "[GlobalReceiver] Controls: unknown message type" << type
-                       << "payload bytes =" << payload.size();
+                       << "payload bytes =" << size;
         }
         break;
     }
 
     case StreamKind::Logger: {
-        can_stream::CanBatch batch;
-        if (!batch.ParseFromArray(payload.constData(), payload.size())) {
+        can_stream::CanBatch& batch = m_canMsg;
+        if (!parseTimed(batch, payload, size, stats)) {
             qWarning() << "[GlobalReceiver] Logger: failed to parse CanBatch";
             return;
         }
         m_loggerHasData = true;
         updateCanLoggerActive();
         emit canBatchReceived(batch);
+        noteDispatched(stats);
         break;
     }
 
     case StreamKind::Perception: {
-        hmi::perception::v1::PerceptionFrame frame;
-        if (!frame.ParseFromArray(payload.constData(), payload.size())) {
+        hmi::perception::v1::PerceptionFrame& frame = m_perceptionMsg;
+        if (!parseTimed(frame, payload, size, stats)) {
             qWarning() << "[GlobalReceiver] Perception: failed to parse PerceptionFrame";
             return;
         }
         qDebug() << "[GlobalReceiver] Perception: received frame with" << frame.objects_size() << "objects";
         emit perceptionFrameReceived(frame);
+        noteDispatched(stats);
         break;
     }
 
     default:
         break;
     }
-}
\ No newline at end of file
+}
+
+void GlobalReceiver::publishMetrics()
+{
+    // Bounds what a crash can lose from an active capture to one interval (the session writer
+    // ends its chunks on its own thread)
+    m_capture.flush();
+    if (m_session)
+        emit sessionProgress(m_session->path(),
+                             static_cast<qint64>(m_session->writtenBytes()) + m_session->queuedBytes());
+
+    const qint64 now = m_clock.nsecsElapsed();
+    const double dt = qMax<qint64>(1, now - m_lastMetricsNs) / 1e9;
+    m_lastMetricsNs = now;
+
+    static const char* const kNames[] = { "controls", "logger", "perception" };
+    QVector<RxStreamMetrics> out;
+    for (size_t i = 0; i < m_stats.size(); ++i) {
+        RxStreamCounters& c = m_stats[i];
+        if (m_transports[i].isEmpty())
+            continue; // stream not configured
+
+        RxStreamMetrics m;
+        m.name = QString::fromLatin1(kNames[i]);
+        m.transport = m_transports[i];
+        m.port = c.port;
+        m.framesTotal = c.framesTotal;
+        m.bytesTotal = c.bytesTotal;
+        m.parseFailures = c.parseFailures;
+        m.resyncs = c.resyncs;
+        m.bytesDiscarded = c.bytesDiscarded;
+        m.datagramsLate = c.datagramsLate;
+        m.datagramsLost = c.datagramsLost;
+        m.framesPerSec = static_cast<double>(c.framesTotal - c.framesAtLastSnapshot) / dt;
+        m.bytesPerSec = static_cast<double>(c.bytesTotal - c.bytesAtLastSnapshot) / dt;
+        m.parseP50Us = c.parseNs.percentile(0.50) / 1000.0;
+        m.parseP99Us = c.parseNs.percentile(0.99) / 1000.0;
+        m.dispatchP50Us = c.dispatchNs.percentile(0.50) / 1000.0;
+        m.dispatchP99Us = c.dispatchNs.percentile(0.99) / 1000.0;
+        for (ConnState* st : std::as_const(m_conns)) {
+            if (st && st->port == c.port)
+                m.bufferedBytes += st->buffer.size();
+        }
+        for (const ShmState& s : m_shm) {
+            if (static_cast<size_t>(s.kind) == i)
+                m.bufferedBytes += static_cast<qint64>(s.ring->pendingBytes());
+        }
+        out.append(m);
+
+        // Rates and percentiles cover one interval; totals keep accumulating
+        c.framesAtLastSnapshot = c.framesTotal;
+        c.bytesAtLastSnapshot = c.bytesTotal;
+        c.parseNs.reset();
+        c.dispatchNs.reset();
+    }
+    emit metricsUpdated(out);
+}
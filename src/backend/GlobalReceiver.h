@@ -2,19 +2,45 @@
 #include <QObject>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QUdpSocket>
+#include <QHostAddress>
 #include <QHash>
 #include <QByteArray>
 #include <QPointer>
+#include <QMetaType>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QVector>
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "RxFrameBuffer.h"
+#include "RxMetrics.h"
+#include "RxCapture.h"
+#include "SessionContainer.h"
 
 #include "../proto/HMI_RX_CONTROLS.pb.h"   // Navigation
 #include "../proto/HMI_RX_CAN.pb.h"       // can_stream::CanBatch
 #include "../proto/HMI_RX_PERCEPTION.pb.h"  // hmi::perception::v1::PerceptionFrame
 
+class ShmRingConsumer;
+
+// Owns the RX servers/sockets, deframing and protobuf parsing. NavigationBackend moves it onto a
+// dedicated QThread, so all signals reach GUI-thread consumers as queued (copied) deliveries and the
+// listen*() calls must be invoked on that thread (QMetaObject::invokeMethod).
 class GlobalReceiver : public QObject
 {
     Q_OBJECT
 public:
     explicit GlobalReceiver(QObject* parent = nullptr);
+    ~GlobalReceiver() override;
+
+    // Which stream does a port represent?
+    enum class StreamKind { Controls, Logger, Perception };
+
+    // Register the typed message payloads for queued (cross-thread) signal delivery.
+    static void registerMetaTypes();
 
     // Add a listening port dedicated to the CONTROLS stream
     bool listenControls(quint16 port = 5001);
@@ -25,6 +51,64 @@ public:
     // Logger stream: CAN batches, 32-bit LE length prefix
     bool listenLogger(quint16 port = 6003);
 
+    // Datagram alternative for Controls / Perception. Each datagram carries a 4-byte big-endian
+    // sequence number followed by exactly one payload in the TCP frame format minus the length prefix
+    // (Controls keeps its type byte). A datagram whose sequence is not newer than the last accepted one
+    // is skipped, so a late packet never delays or overwrites a newer pose. One sender per stream;
+    // a new sender endpoint or kUdpIdleMs of silence restarts sequence tracking. A non-empty
+    // multicastGroup (IPv4) is joined on all interfaces. CameraBatch frames exceed a datagram, so
+    // camera streaming needs the TCP Controls port.
+    bool listenControlsUdp(quint16 port = 5001, const QString& multicastGroup = QString());
+    bool listenPerceptionUdp(quint16 port = 6002, const QString& multicastGroup = QString());
+    static constexpr int kUdpIdleMs = 2000;
+
+    // Same-host shared-memory ring (src/shmring/ShmRing.h), one per stream. Payloads are the TCP frame
+    // minus its length prefix and are parsed in place from the mapping, so nothing is copied on the
+    // way in. The producer creates the segment; until it exists the receiver retries every
+    // kShmAttachRetryMs. Rings are polled every kShmPollMs on the receiver thread. A ring whose
+    // producer has published nothing (not even a dropped frame) for kShmIdleMs counts as disconnected
+    // and is detached and attached again, which also picks up a segment the producer re-created.
+    // Returns false on platforms without POSIX shared memory.
+    bool listenControlsShm(const QString& name);
+    bool listenPerceptionShm(const QString& name);
+    bool listenLoggerShm(const QString& name);
+    static constexpr int kShmPollMs = 1;
+    static constexpr int kShmAttachRetryMs = 500;
+    static constexpr int kShmIdleMs = 2000;
+    // Records parsed per ring per poll, so one busy producer cannot starve the socket handlers
+    static constexpr int kShmPollBudget = 256;
+
+    // Capture writes every deframed payload (any transport) with its receive time to a .hmicap file
+    // (RxCapture.h). Replay feeds a capture back through the parser with the recorded spacing divided
+    // by speed (speed <= 0: as fast as possible), optionally looping; it runs alongside live traffic
+    // and replayed frames are not re-captured.
+    bool startCapture(const QString& path);
+    void stopCapture();
+    bool startReplay(const QString& path, double speed = 1.0, bool loop = false);
+    void stopReplay();
+    // Session recording writes the same payloads split per message type into a time-indexed
+    // .hmises container (SessionContainer.h) on its own writer thread; startReplay() also accepts
+    // those files. stopSession() returns at once (`discard` deletes the file instead of finishing
+    // it); sessionFinished() follows when the writer is done.
+    bool startSession(const QString& path);
+    void stopSession(bool discard = false);
+    // Most records handed to the parser per replay step, so a burst can't starve the thread
+    static constexpr int kReplayBatch = 512;
+
+    // Interval of metricsUpdated() snapshots
+    static constexpr int kMetricsIntervalMs = 1000;
+
+    // Memory bounds per stream kind. A length prefix above maxFrameBytes is treated as corrupt and
+    // the connection resynchronises on the next plausible header. Each connection buffer holds at
+    // most maxBufferedBytes and Qt's socket read buffer is capped to the same size, so a flooding
+    // sender is throttled by TCP backpressure instead of growing memory.
+    struct StreamLimits {
+        int maxFrameBytes = 4 * 1024 * 1024;
+        qint64 maxBufferedBytes = 8 * 1024 * 1024;
+    };
+    void setStreamLimits(StreamKind kind, const StreamLimits& limits);
+    StreamLimits streamLimits(StreamKind kind) const { return m_limits[static_cast<size_t>(kind)]; }
+
 signals:
     // Raw payloads (already deframed by length prefix)
     void controlsRaw(const QByteArray& payload);
@@ -44,15 +128,35 @@ signals:
     // Perception stream (port 6002, PerceptionFrame)
     void perceptionFrameReceived(const hmi::perception::v1::PerceptionFrame& frame);
 
+    // Ingest telemetry, one entry per listening stream, every kMetricsIntervalMs (see RxMetrics)
+    void metricsUpdated(const QVector<RxStreamMetrics>& streams);
+
+    // Replay reached the end of the capture (not emitted while looping)
+    void replayFinished();
+
+    // startSession() outcome, for callers that invoke it on the receiver thread
+    void sessionStarted(const QString& path);
+    void sessionFailed(const QString& path, const QString& error);
+    // Every kMetricsIntervalMs while recording: bytes written to the session file plus those queued
+    void sessionProgress(const QString& path, qint64 bytes);
+    // Session file complete (trailer written, renamed to `path`) after stopSession(); ok is false
+    // when it was discarded or a write failed.
+    void sessionFinished(const QString& path, bool ok);
+
 private slots:
     void onNewConnection();
     void onReadyRead();
     void onDisconnected();
+    void onDatagramsReady();
+    void onUdpIdle();
+    void pollShm();
+    void replayStep();
+    void publishMetrics();
 
 private:
     struct ConnState {
         QPointer<QTcpSocket> sock;
-        QByteArray buffer;
+        RxFrameBuffer buffer;
         quint16 port = 0;
     };
 
@@ -61,14 +165,103 @@ private:
     // Per-socket parse buffers
     QHash<QTcpSocket*, ConnState*> m_conns;
 
-    // Framing: Controls = 4-byte big-endian; Logger = 4-byte little-endian (per TX spec)
-    bool tryPopFrame(quint16 port, QByteArray& buf, QByteArray& frame);
+    // Framing: Controls = 4-byte big-endian; Logger = 4-byte little-endian (per TX spec).
+    // On success `frame`/`frameLen` view the payload inside `buf` (valid until the next socket read).
+    // Corrupt length prefixes are skipped here (resync), so a false return always means "need more".
+    bool tryPopFrame(quint16 port, RxFrameBuffer& buf, const char*& frame, int& frameLen);
+    quint32 readLengthPrefix(StreamKind kind, const char* p) const;
+    bool plausibleHeader(StreamKind kind, const char* p, qsizetype avail) const;
+    void resync(StreamKind kind, RxFrameBuffer& buf);
 
-    // Which stream does this port represent?
-    enum class StreamKind { Controls, Logger, Perception };
     QHash<quint16, StreamKind> m_portKinds;
+    // Controls carries CameraBatch JPEGs, so it gets more headroom than the other streams
+    std::array<StreamLimits, 3> m_limits{ StreamLimits{ 16 * 1024 * 1024, 32 * 1024 * 1024 },
+                                          StreamLimits{}, StreamLimits{} };
 
-    void processFrame(quint16 port, const QByteArray& payload);
+    bool listenTcp(quint16 port, StreamKind kind);
+    bool listenUdp(quint16 port, StreamKind kind, const QString& multicastGroup);
+    bool listenShm(const QString& name, StreamKind kind);
+    void startMetrics();
+
+    // Transport per stream kind ("tcp", "udp", "shm"); empty while the stream is not configured
+    std::array<QString, 3> m_transports;
+
+    struct UdpState {
+        QPointer<QUdpSocket> sock;
+        quint16 port = 0;
+        bool haveSeq = false;
+        quint32 lastSeq = 0;
+        QHostAddress sender;
+        quint16 senderPort = 0;
+    };
+    // One bound socket per UDP port
+    QHash<quint16, UdpState> m_udp;
+    // Receive buffer reused for every datagram (resize() keeps its capacity)
+    QByteArray m_datagram;
+    // Restarted by every accepted datagram; keeps LAN on and sequence state alive while UDP flows
+    QTimer* m_udpIdleTimer = nullptr;
+    bool acceptSequence(UdpState& st, quint32 seq, const QHostAddress& from, quint16 fromPort,
+                        RxStreamCounters& stats);
+
+    struct ShmState {
+        StreamKind kind = StreamKind::Controls;
+        QString name;
+        std::unique_ptr<ShmRingConsumer> ring;   // attached when ring->isOpen()
+        qint64 nextAttachNs = 0;
+        quint64 producerDropsSeen = 0;
+        quint64 corruptSeen = 0;
+        quint64 publishedSeen = 0;     // producer's written + dropped counters at the last poll
+        qint64 lastActivityNs = 0;     // 0 = never attached
+        bool live = false;             // producer published within kShmIdleMs
+    };
+    std::vector<ShmState> m_shm;
+    QTimer* m_shmTimer = nullptr;
+
+    void processFrame(StreamKind kind, const char* payload, int size);
+    void recordSessionFrame(StreamKind kind, const char* payload, int size);
+    void onSessionWriterFinished(SessionWriter* writer, const QString& path, bool ok);
+    bool nextReplayRecord();
+    void rewindReplay();
+
+    RxCaptureWriter m_capture;
+    qint64 m_captureStartNs = 0;
+
+    std::unique_ptr<SessionWriter> m_session;   // null when not recording a session
+    qint64 m_sessionStartNs = 0;
+    std::vector<std::unique_ptr<SessionWriter>> m_closingSessions;   // stopped, finishing on their threads
+
+    RxCaptureReader m_replay;
+    SessionReader m_sessionReplay;  // open instead of m_replay when replaying a .hmises file
+    QByteArray m_replayFrame;       // Controls frame rebuilt from a session record (type byte + payload)
+    RxCaptureRecord m_replayNext;
+    bool m_replayHaveNext = false;
+    bool m_replaying = false;       // inside replayStep(): keeps replayed frames out of the capture
+    double m_replaySpeed = 1.0;
+    bool m_replayLoop = false;
+    qint64 m_replayStartNs = 0;     // m_clock time the first record was replayed
+    qint64 m_replayBaseNs = 0;      // capture time of that record
+    QTimer* m_replayTimer = nullptr;
+
+    // Parse targets reused for every frame of their stream kind. ParseFromArray() clears them but
+    // keeps repeated-field elements and string capacity, so once warmed up parsing does not allocate.
+    // Signals pass them by const reference; queued consumers receive their own copy.
+    vehicle_msgs::Navigation m_navMsg;
+    vehicle_msgs::CameraBatch m_cameraMsg;
+    vehicle_msgs::Controls m_controlsMsg;
+    can_stream::CanBatch m_canMsg;
+    hmi::perception::v1::PerceptionFrame m_perceptionMsg;
+
+    // Telemetry: plain counters per stream kind, snapshotted by m_metricsTimer
+    std::array<RxStreamCounters, 3> m_stats;
+    QElapsedTimer m_clock;
+    QTimer* m_metricsTimer = nullptr;
+    qint64 m_lastMetricsNs = 0;
+    qint64 m_readStartNs = 0;   // when the current readyRead batch came off the socket
+
+    RxStreamCounters& statsFor(StreamKind kind) { return m_stats[static_cast<size_t>(kind)]; }
+    template <typename Msg>
+    bool parseTimed(Msg& msg, const char* data, int size, RxStreamCounters& stats);
+    void noteDispatched(RxStreamCounters& stats);
 
     bool hasLoggerConnection() const;
     void updateCanLoggerActive();
@@ -83,3 +276,9 @@ private:
         emit lanConnectedChanged(m_lanConnected);
     }
 };
+
+Q_DECLARE_METATYPE(vehicle_msgs::Navigation)
+Q_DECLARE_METATYPE(vehicle_msgs::CameraBatch)
+Q_DECLARE_METATYPE(vehicle_msgs::Controls)
+Q_DECLARE_METATYPE(can_stream::CanBatch)
+Q_DECLARE_METATYPE(hmi::perception::v1::PerceptionFrame)
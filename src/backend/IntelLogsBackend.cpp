@@ -1,11 +1,12 @@
 #include "IntelLogsBackend.h"
+#include "LogStorageBackend.h"
 
 #include <QCoreApplication>
+#include <QDebug>
 #include <QDir>
 #include <QFile>
 #include <QHostAddress>
-#include <QTextStream>
-#include <algorithm>
+#include <QSaveFile>
 
 // ---- IntelLogsModel ----
 
@@ -96,13 +97,23 @@ IntelLogsBackend::IntelLogsBackend(QObject* parent)
 {
     m_logsDir = resolveLogsDir();
     emit logsDirChanged();
-    refreshLogList();
+    m_logIndex = new LogDirectoryIndex(m_logsDir, { "*.log" }, &IntelLogsBackend::readLogMetadata, this);
+    connect(m_logIndex, &LogDirectoryIndex::filesChanged, this, &IntelLogsBackend::logFileNamesChanged);
 
     // Listen on all interfaces, port 6969.
     m_sock.bind(QHostAddress::AnyIPv4, 6969, QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint);
     connect(&m_sock, &QUdpSocket::readyRead, this, &IntelLogsBackend::onReadyRead);
 }
 
+void IntelLogsBackend::setStorageBackend(LogStorageBackend* storage)
+{
+    m_storage = storage;
+    if (!m_storage) return;
+    m_storage->setRoot(LogStorageBackend::IntelRoot, m_logsDir);
+    m_logIndex->setStorageBackend(m_storage);
+    connect(m_storage, &LogStorageBackend::filesDeleted, this, &IntelLogsBackend::refreshLogList);
+}
+
 QString IntelLogsBackend::resolveLogsDir() const
 {
     const QDir appDir(QCoreApplication::applicationDirPath());
@@ -134,8 +145,10 @@ QString IntelLogsBackend::resolveLogsDir() const
 QString IntelLogsBackend::currentLogPath() const
 {
     QDir dir(m_logsDir);
-    if (!dir.exists())
+    if (!dir.exists()) {
         dir.mkpath(".");
+        m_logIndex->rescan();   // starts watching the new directory
+    }
     // Requested: MM-DD-YYYY_HH_MM_SS
     const QString fileName = QDateTime::currentDateTime().toString("MM-dd-yyyy_HH_mm_ss") + ".log";
     return dir.absoluteFilePath(fileName);
@@ -146,41 +159,62 @@ void IntelLogsBackend::clearLogs()
     m_model.clear();
 }
 
+void IntelLogsBackend::setLastSaveError(const QString& error)
+{
+    if (m_lastSaveError == error) return;
+    m_lastSaveError = error;
+    emit lastSaveErrorChanged();
+}
+
 QString IntelLogsBackend::saveLogs()
 {
-    const QString path = currentLogPath();
-    QFile f(path);
-    if (!f.open(QIODevice::WriteOnly | QIODevice::Text))
+    const QByteArray text = m_model.dumpText().toUtf8();
+    QString error;
+    if (m_storage && !m_storage->reserve(LogStorageBackend::IntelRoot, text.size(), &error)) {
+        setLastSaveError(error);
         return QString();
+    }
 
-    QTextStream out(&f);
-    out << m_model.dumpText();
-    f.flush();
-    f.close();
-
-    refreshLogList();
-    return path;
+    // QSaveFile: a write that fails half-way (disk full) leaves no truncated log behind
+    const QString path = currentLogPath();
+    QSaveFile f(path);
+    if (f.open(QIODevice::WriteOnly | QIODevice::Text) && f.write(text) == text.size() && f.commit()) {
+        setLastSaveError(QString());
+        if (m_storage)
+            m_storage->fileAdded(path);
+        refreshLogList();
+        return path;
+    }
+    qWarning() << "IntelLogsBackend: failed to save" << path << f.errorString();
+    setLastSaveError(tr("Could not save log: %1").arg(f.errorString()));
+    return QString();
 }
 
 void IntelLogsBackend::refreshLogList()
 {
-    QDir dir(m_logsDir);
-    if (!dir.exists()) {
-        if (!m_logFileNames.isEmpty()) {
-            m_logFileNames.clear();
-            emit logFileNamesChanged();
-        }
-        return;
-    }
-
-    QStringList entries = dir.entryList(QStringList() << "*.log", QDir::Files, QDir::Name);
-    // Sort descending so newest first
-    std::sort(entries.begin(), entries.end(), std::greater<QString>());
+    // The index follows the directory by itself; this only covers changes the watcher cannot see
+    m_logIndex->rescan();
+}
 
-    if (entries != m_logFileNames) {
-        m_logFileNames = entries;
-        emit logFileNamesChanged();
+void IntelLogsBackend::readLogMetadata(const QString& path, LogDirectoryIndex::Entry& entry)
+{
+    // Runs on the index thread. Saved logs are dumpText() output: one "[HH:mm] message" per line,
+    // at most a model's worth, so reading them whole is cheap.
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return;
+    qint64 lines = 0;
+    int firstMin = -1, lastMin = -1;
+    while (!f.atEnd()) {
+        const QByteArray line = f.readLine();
+        if (line.size() < 7 || line[0] != '[' || line[3] != ':' || line[6] != ']') continue;
+        const int minutes = line.mid(1, 2).toInt() * 60 + line.mid(4, 2).toInt();
+        if (firstMin < 0) firstMin = minutes;
+        lastMin = minutes;
+        ++lines;
     }
+    entry.events = lines;
+    if (firstMin >= 0)
+        entry.durationMs = static_cast<qint64>((lastMin - firstMin + 24 * 60) % (24 * 60)) * 60 * 1000;   // past midnight
 }
 
 void IntelLogsBackend::onReadyRead()
@@ -5,6 +5,9 @@
 #include <QUdpSocket>
 #include <QDateTime>
 #include <QStringList>
+#include "LogDirectoryIndex.h"
+
+class LogStorageBackend;
 
 class IntelLogsModel final : public QAbstractListModel
 {
@@ -40,14 +43,21 @@ class IntelLogsBackend final : public QObject
     Q_OBJECT
     Q_PROPERTY(QObject* model READ model CONSTANT)
     Q_PROPERTY(QStringList logFileNames READ logFileNames NOTIFY logFileNamesChanged)
+    // Saved logs with size, duration, line count and backed-up flag (LogDirectoryIndex roles)
+    Q_PROPERTY(QObject* logFiles READ logFiles CONSTANT)
     Q_PROPERTY(QString logsDir READ logsDir NOTIFY logsDirChanged)
+    // Why the last saveLogs() failed (disk full, quota, write error); empty after a good save
+    Q_PROPERTY(QString lastSaveError READ lastSaveError NOTIFY lastSaveErrorChanged)
 
 public:
     explicit IntelLogsBackend(QObject* parent = nullptr);
 
     QObject* model() { return &m_model; }
-    QStringList logFileNames() const { return m_logFileNames; }
+    QStringList logFileNames() const { return m_logIndex->fileNames(); }
+    QObject* logFiles() { return m_logIndex; }
     QString logsDir() const { return m_logsDir; }
+    QString lastSaveError() const { return m_lastSaveError; }
+    void setStorageBackend(LogStorageBackend* storage);
 
     Q_INVOKABLE void clearLogs();
     Q_INVOKABLE QString saveLogs();
@@ -59,14 +69,19 @@ private slots:
 signals:
     void logFileNamesChanged();
     void logsDirChanged();
+    void lastSaveErrorChanged();
 
 private:
     QString resolveLogsDir() const;
     QString currentLogPath() const;
+    void setLastSaveError(const QString& error);
+    static void readLogMetadata(const QString& path, LogDirectoryIndex::Entry& entry);
 
     IntelLogsModel m_model;
     QUdpSocket m_sock;
     QString m_logsDir;
-    QStringList m_logFileNames;
+    LogDirectoryIndex* m_logIndex = nullptr;
+    QString m_lastSaveError;
+    LogStorageBackend* m_storage = nullptr;
 };
 
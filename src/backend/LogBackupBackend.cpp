@@ -45,10 +45,12 @@ QStringList LogBackupBackend::collectFilesRecursive(const QString& dirPath, cons
     const auto entries = dir.entryList(QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot);
     for (const QString& name : entries) {
         const QString fullPath = dir.absoluteFilePath(name);
+        if (name.startsWith(QLatin1Char('.')))   // bookkeeping such as .backup_ledger
+            continue;
         const QString relPath = prefix.isEmpty() ? name : (prefix + QLatin1Char('/') + name);
         if (QFileInfo(fullPath).isDir())
             out.append(collectFilesRecursive(fullPath, relPath));
-        else
+        else if (!name.endsWith(QLatin1String(".partial")))   // recording segment still being written
             out.append(relPath);
     }
     return out;
@@ -151,6 +153,14 @@ void LogBackupBackend::startBackupImpl(const QString& localRootPath, const QStri
     m_password = m_settings->webdavPassword();
 
     m_pendingFiles = collectFilesRecursive(m_logsRootPath, QString());
+    // Files of the recording in progress (manifest, session container) still change; they are
+    // uploaded by the backup that follows the save
+    const QString active = m_logger ? m_logger->activeSessionName() : QString();
+    if (!active.isEmpty()) {
+        m_pendingFiles.erase(std::remove_if(m_pendingFiles.begin(), m_pendingFiles.end(),
+                                            [&active](const QString& rel) { return rel.section(QLatin1Char('/'), -1).startsWith(active); }),
+                             m_pendingFiles.end());
+    }
     if (m_pendingFiles.isEmpty()) {
         m_lastBackupMessage = tr("No log files to upload.");
         emit lastBackupMessageChanged();
@@ -182,6 +192,8 @@ void LogBackupBackend::onRequestFinished()
 
     QNetworkReply* reply = m_currentReply;
     m_currentReply = nullptr;
+    const QString localPath = m_currentLocalPath;
+    m_currentLocalPath.clear();
 
     const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
     const QByteArray body = reply->readAll();
@@ -213,6 +225,8 @@ void LogBackupBackend::onRequestFinished()
         return;
     }
 
+    if (!localPath.isEmpty())
+        emit fileBackedUp(localPath, m_currentSize, m_currentMtimeMs);
     processNext();
 }
 
@@ -238,6 +252,8 @@ void LogBackupBackend::processNext()
         m_nextFileIndex++;
         const QString remotePath = m_remoteRootPath + QLatin1Char('/') + relPath;
         const QString localPath = QDir(m_logsRootPath).absoluteFilePath(relPath);
+        // Stamped before reading: a file that changes during the read no longer matches the ledger
+        const qint64 mtimeMs = QFileInfo(localPath).lastModified().toMSecsSinceEpoch();
         QFile file(localPath);
         if (!file.open(QIODevice::ReadOnly)) {
             m_backupInProgress = false;
@@ -257,6 +273,9 @@ void LogBackupBackend::processNext()
         req.setRawHeader("Authorization", basicAuthHeader(m_username, m_password));
         req.setHeader(QNetworkRequest::ContentLengthHeader, data.size());
         req.setHeader(QNetworkRequest::ContentTypeHeader, QByteArrayLiteral("application/octet-stream"));
+        m_currentLocalPath = localPath;
+        m_currentSize = data.size();
+        m_currentMtimeMs = mtimeMs;
         m_currentReply = m_nam->put(req, data);
         connect(m_currentReply, &QNetworkReply::finished, this, &LogBackupBackend::onRequestFinished);
         return;
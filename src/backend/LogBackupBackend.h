@@ -33,6 +33,9 @@ signals:
     void backupInProgressChanged();
     void lastBackupMessageChanged();
     void backupFinished(bool success, const QString& message);
+    // A local file was uploaded (LogStorageBackend may now delete it when space runs low);
+    // size and mtimeMs describe the file as it was read for the upload.
+    void fileBackedUp(const QString& localPath, qint64 size, qint64 mtimeMs);
 
 private slots:
     void onRequestFinished();
@@ -60,6 +63,9 @@ private:
     QString m_remoteRootPath; // e.g. "logs" or "logs/Intel"
     QString m_username;
     QString m_password;
+    QString m_currentLocalPath;   // file of the PUT in flight; empty for MKCOL
+    qint64 m_currentSize = 0;     // ...and its size / mtime when it was read
+    qint64 m_currentMtimeMs = 0;
     int m_nextDirIndex = 0;
     int m_nextFileIndex = 0;
 };
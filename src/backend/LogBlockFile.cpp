@@ -0,0 +1,113 @@
+#include "LogBlockFile.h"
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+namespace LogBlock {
+
+QByteArray makeHeader()
+{
+    QByteArray h(kHeaderBytes, '\0');
+    uchar* p = reinterpret_cast<uchar*>(h.data());
+    std::memcpy(p, kMagic, sizeof(kMagic));
+    qToLittleEndian<quint16>(kVersion, p + 8);
+    qToLittleEndian<quint16>(kHeaderBytes, p + 10);
+    return h;
+}
+
+void appendBlock(QByteArray& out, const char* raw, qsizetype rawBytes, int level)
+{
+    const QByteArray packed = qCompress(reinterpret_cast<const uchar*>(raw), rawBytes, qBound(1, level, 9));
+    const qsizetype at = out.size();
+    out.resize(at + kBlockHeaderBytes);
+    uchar* p = reinterpret_cast<uchar*>(out.data() + at);
+    std::memcpy(p, kBlockMagic, sizeof(kBlockMagic));
+    qToLittleEndian<quint32>(static_cast<quint32>(rawBytes), p + 4);
+    qToLittleEndian<quint32>(static_cast<quint32>(packed.size()), p + 8);
+    out.append(packed);
+}
+
+} // namespace LogBlock
+
+bool LogBlockReader::open(const QString& path)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    uchar header[LogBlock::kHeaderBytes];
+    if (m_file.read(reinterpret_cast<char*>(header), sizeof(header)) != sizeof(header)
+        || std::memcmp(header, LogBlock::kMagic, sizeof(LogBlock::kMagic)) != 0) {
+        m_error = QStringLiteral("not a block-compressed log");
+        close();
+        return false;
+    }
+    const quint16 headerBytes = qFromLittleEndian<quint16>(header + 10);
+    if (headerBytes < LogBlock::kHeaderBytes) {
+        m_error = QStringLiteral("unsupported block log header");
+        close();
+        return false;
+    }
+
+    // Walk the block headers only; stop at the first incomplete or foreign one (crash tail)
+    const qint64 size = m_file.size();
+    qint64 offset = headerBytes;
+    uchar bh[LogBlock::kBlockHeaderBytes];
+    while (offset + LogBlock::kBlockHeaderBytes <= size) {
+        if (!m_file.seek(offset)
+            || m_file.read(reinterpret_cast<char*>(bh), sizeof(bh)) != sizeof(bh)
+            || std::memcmp(bh, LogBlock::kBlockMagic, sizeof(LogBlock::kBlockMagic)) != 0)
+            break;
+        Block b;
+        b.offset = offset;
+        b.rawOffset = m_rawSize;
+        b.rawBytes = qFromLittleEndian<quint32>(bh + 4);
+        b.packedBytes = qFromLittleEndian<quint32>(bh + 8);
+        const qint64 end = offset + LogBlock::kBlockHeaderBytes + b.packedBytes;
+        if (end > size)
+            break;
+        m_blocks.append(b);
+        m_rawSize += b.rawBytes;
+        offset = end;
+    }
+    m_error.clear();
+    return true;
+}
+
+void LogBlockReader::close()
+{
+    if (m_file.isOpen())
+        m_file.close();
+    m_blocks.clear();
+    m_rawSize = 0;
+}
+
+bool LogBlockReader::readBlock(int index, QByteArray& raw)
+{
+    if (!isOpen() || index < 0 || index >= m_blocks.size())
+        return false;
+    const Block& b = m_blocks.at(index);
+    if (!m_file.seek(b.offset + LogBlock::kBlockHeaderBytes))
+        return false;
+    const QByteArray packed = m_file.read(b.packedBytes);
+    if (packed.size() != static_cast<qsizetype>(b.packedBytes))
+        return false;
+    raw = qUncompress(packed);
+    if (raw.size() != static_cast<qsizetype>(b.rawBytes)) {
+        m_error = QStringLiteral("damaged block %1").arg(index);
+        raw.clear();
+        return false;
+    }
+    return true;
+}
+
+int LogBlockReader::blockForRawOffset(qint64 rawOffset) const
+{
+    if (rawOffset < 0 || rawOffset >= m_rawSize)
+        return -1;
+    const auto it = std::upper_bound(m_blocks.cbegin(), m_blocks.cend(), rawOffset,
+                                     [](qint64 off, const Block& b) { return off < b.rawOffset; });
+    return static_cast<int>(it - m_blocks.cbegin()) - 1;
+}
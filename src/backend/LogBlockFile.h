@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+// Block-compressed log container (*.<inner suffix>.hbz, e.g. 05-01-2025_10-00-00.csv.hbz): the inner
+// recording (CSV or .canb) cut into independently decodable zlib blocks, so a crash loses at most
+// the block being filled and a reader can jump to any block without inflating the ones before it.
+//
+//   header  "HMIBLKZ1" | u16 version | u16 headerBytes | u32 reserved             (16 bytes)
+//   block   "HBLK" | u32 rawBytes | u32 packedBytes | packed                      (12 + packedBytes)
+//
+// Little-endian; `packed` is qCompress() output (big-endian raw length + zlib stream with its
+// Adler-32), so a damaged block fails to inflate instead of yielding garbage.
+namespace LogBlock {
+
+constexpr char kMagic[8] = { 'H', 'M', 'I', 'B', 'L', 'K', 'Z', '1' };
+constexpr char kBlockMagic[4] = { 'H', 'B', 'L', 'K' };
+constexpr quint16 kVersion = 1;
+constexpr int kHeaderBytes = 16;
+constexpr int kBlockHeaderBytes = 12;
+inline QString fileSuffix() { return QStringLiteral("hbz"); }
+
+QByteArray makeHeader();
+// Compresses `raw` at zlib `level` (1..9) and appends the framed block to `out`.
+void appendBlock(QByteArray& out, const char* raw, qsizetype rawBytes, int level);
+
+} // namespace LogBlock
+
+// Random-access reader: open() indexes the block headers (no inflating); a truncated or damaged
+// tail is ignored.
+class LogBlockReader
+{
+public:
+    struct Block
+    {
+        qint64 offset = 0;     // of the block header in the file
+        qint64 rawOffset = 0;  // of the block's first byte in the decompressed stream
+        quint32 rawBytes = 0;
+        quint32 packedBytes = 0;
+    };
+
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString errorString() const { return m_error; }
+
+    const QVector<Block>& blocks() const { return m_blocks; }
+    qint64 rawSize() const { return m_rawSize; }
+    // Inflates block `index` into `raw`; false if the block is damaged.
+    bool readBlock(int index, QByteArray& raw);
+    // Index of the block holding decompressed offset `rawOffset`, or -1.
+    int blockForRawOffset(qint64 rawOffset) const;
+
+private:
+    QFile m_file;
+    QVector<Block> m_blocks;
+    qint64 m_rawSize = 0;
+    QString m_error;
+};
@@ -0,0 +1,263 @@
+#include "LogDirectoryIndex.h"
+#include "LogStorageBackend.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QLocale>
+#include <QSet>
+#include <QTimer>
+#include <algorithm>
+
+// Lives on the index thread: owns the watcher and the metadata cache
+class LogDirectoryScanner : public QObject
+{
+public:
+    LogDirectoryScanner(const QString& dirPath, const QStringList& nameFilters,
+                        const LogDirectoryIndex::MetadataReader& reader, LogDirectoryIndex* index)
+        : m_dirPath(dirPath), m_nameFilters(nameFilters), m_reader(reader), m_index(index)
+    {
+    }
+
+    void start()
+    {
+        m_watcher = new QFileSystemWatcher(this);
+        m_scanTimer = new QTimer(this);
+        // A burst of changes (segment rename, sidecar, manifest) becomes one scan
+        m_scanTimer->setSingleShot(true);
+        m_scanTimer->setInterval(kCoalesceMs);
+        connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, [this]() {
+            if (!m_scanTimer->isActive())
+                m_scanTimer->start();
+        });
+        connect(m_scanTimer, &QTimer::timeout, this, &LogDirectoryScanner::scan);
+        scan();
+    }
+
+    void scan()
+    {
+        QVector<LogDirectoryIndex::Entry> upserts;
+        QStringList removed;
+        QSet<QString> seen;
+
+        const QDir dir(m_dirPath);
+        if (dir.exists()) {
+            // Created after start-up (first recording): watch it from now on
+            if (m_watcher && !m_watcher->directories().contains(m_dirPath))
+                m_watcher->addPath(m_dirPath);
+            const QFileInfoList infos = dir.entryInfoList(m_nameFilters, QDir::Files);
+            for (const QFileInfo& fi : infos) {
+                const QString name = fi.fileName();
+                seen.insert(name);
+                const qint64 size = fi.size();
+                const qint64 mtimeMs = fi.lastModified().toMSecsSinceEpoch();
+                const auto cached = m_cache.constFind(name);
+                if (cached != m_cache.cend() && cached->size == size && cached->mtimeMs == mtimeMs)
+                    continue;
+                LogDirectoryIndex::Entry e;
+                e.name = name;
+                e.size = size;
+                e.mtimeMs = mtimeMs;
+                if (m_reader)
+                    m_reader(fi.absoluteFilePath(), e);
+                m_cache.insert(name, e);
+                upserts.append(e);
+            }
+        }
+        for (auto it = m_cache.begin(); it != m_cache.end();) {
+            if (seen.contains(it.key())) {
+                ++it;
+            } else {
+                removed.append(it.key());
+                it = m_cache.erase(it);
+            }
+        }
+
+        if (upserts.isEmpty() && removed.isEmpty()) return;
+        LogDirectoryIndex* index = m_index;
+        QMetaObject::invokeMethod(index, [index, upserts, removed]() { index->apply(upserts, removed); },
+                                  Qt::QueuedConnection);
+    }
+
+private:
+    static constexpr int kCoalesceMs = 300;
+
+    QString m_dirPath;
+    QStringList m_nameFilters;
+    LogDirectoryIndex::MetadataReader m_reader;
+    LogDirectoryIndex* m_index;               // GUI thread; only used as the target of queued calls
+    QFileSystemWatcher* m_watcher = nullptr;
+    QTimer* m_scanTimer = nullptr;
+    QHash<QString, LogDirectoryIndex::Entry> m_cache;
+};
+
+LogDirectoryIndex::LogDirectoryIndex(const QString& dirPath, const QStringList& nameFilters,
+                                     const MetadataReader& reader, QObject* parent)
+    : QAbstractListModel(parent)
+    , m_dirPath(QDir(dirPath).absolutePath())
+{
+    // No parent: moveToThread() requires it; deleted on the index thread when it finishes.
+    m_scanner = new LogDirectoryScanner(m_dirPath, nameFilters, reader, this);
+    m_scanner->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_scanner, &QObject::deleteLater);
+    connect(&m_thread, &QThread::started, m_scanner, [scanner = m_scanner]() { scanner->start(); });
+    m_thread.setObjectName(QStringLiteral("HMI-LogIndex"));
+    m_thread.start(QThread::LowPriority);
+}
+
+LogDirectoryIndex::~LogDirectoryIndex()
+{
+    m_thread.quit();
+    m_thread.wait();
+    m_scanner = nullptr;
+}
+
+int LogDirectoryIndex::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_rows.size();
+}
+
+QVariant LogDirectoryIndex::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_rows.size())
+        return {};
+
+    const Entry& e = m_rows.at(index.row());
+    switch (role) {
+    case FileNameRole:
+        return e.name;
+    case SizeRole:
+        return e.size;
+    case SizeTextRole:
+        return QLocale::system().formattedDataSize(e.size, 1, QLocale::DataSizeTraditionalFormat);
+    case DurationMsRole:
+        return e.durationMs;
+    case DurationTextRole: {
+        if (e.durationMs < 0)
+            return QString();
+        const qint64 secs = e.durationMs / 1000;
+        if (secs >= 3600)
+            return QStringLiteral("%1:%2:%3").arg(secs / 3600).arg(secs / 60 % 60, 2, 10, QLatin1Char('0'))
+                                            .arg(secs % 60, 2, 10, QLatin1Char('0'));
+        return QStringLiteral("%1:%2").arg(secs / 60).arg(secs % 60, 2, 10, QLatin1Char('0'));
+    }
+    case EventsRole:
+        return e.events;
+    case BackedUpRole:
+        return e.backedUp;
+    case ModifiedMsRole:
+        return e.mtimeMs;
+    default:
+        return {};
+    }
+}
+
+QHash<int, QByteArray> LogDirectoryIndex::roleNames() const
+{
+    return {
+        { FileNameRole, "fileName" },
+        { SizeRole, "sizeBytes" },
+        { SizeTextRole, "sizeText" },
+        { DurationMsRole, "durationMs" },
+        { DurationTextRole, "durationText" },
+        { EventsRole, "events" },
+        { BackedUpRole, "backedUp" },
+        { ModifiedMsRole, "modifiedMs" },
+    };
+}
+
+QStringList LogDirectoryIndex::fileNames() const
+{
+    QStringList names;
+    names.reserve(m_rows.size());
+    for (const Entry& e : m_rows)
+        names.append(e.name);
+    return names;
+}
+
+void LogDirectoryIndex::setStorageBackend(LogStorageBackend* storage)
+{
+    m_storage = storage;
+    if (!m_storage) return;
+    connect(m_storage, &LogStorageBackend::backedUpChanged, this, &LogDirectoryIndex::onBackedUp);
+    for (Entry& e : m_rows)
+        e.backedUp = m_storage->isFileBackedUp(m_dirPath + "/" + e.name);
+    if (!m_rows.isEmpty())
+        emit dataChanged(index(0), index(m_rows.size() - 1), { BackedUpRole });
+}
+
+void LogDirectoryIndex::rescan()
+{
+    LogDirectoryScanner* scanner = m_scanner;
+    QMetaObject::invokeMethod(scanner, [scanner]() { scanner->scan(); }, Qt::QueuedConnection);
+}
+
+int LogDirectoryIndex::insertPosition(const QString& name) const
+{
+    // Rows are in descending name order
+    const auto it = std::lower_bound(m_rows.cbegin(), m_rows.cend(), name,
+                                     [](const Entry& e, const QString& n) { return e.name > n; });
+    return static_cast<int>(it - m_rows.cbegin());
+}
+
+int LogDirectoryIndex::find(const QString& name) const
+{
+    const int row = insertPosition(name);
+    return row < m_rows.size() && m_rows.at(row).name == name ? row : -1;
+}
+
+void LogDirectoryIndex::apply(const QVector<Entry>& upserts, const QStringList& removed)
+{
+    const int before = m_rows.size();
+    const auto backedUp = [this](const QString& name) {
+        return m_storage && m_storage->isFileBackedUp(m_dirPath + "/" + name);
+    };
+
+    if (m_rows.isEmpty()) {
+        // First listing: one reset instead of a row insert per file
+        beginResetModel();
+        m_rows = upserts;
+        for (Entry& e : m_rows)
+            e.backedUp = backedUp(e.name);
+        std::sort(m_rows.begin(), m_rows.end(), [](const Entry& a, const Entry& b) { return a.name > b.name; });
+        endResetModel();
+    } else {
+        for (const QString& name : removed) {
+            const int row = find(name);
+            if (row < 0) continue;
+            beginRemoveRows(QModelIndex(), row, row);
+            m_rows.remove(row);
+            endRemoveRows();
+        }
+        for (const Entry& e : upserts) {
+            const int row = find(e.name);
+            if (row >= 0) {
+                m_rows[row] = e;
+                m_rows[row].backedUp = backedUp(e.name);
+                emit dataChanged(index(row), index(row));
+                continue;
+            }
+            const int pos = insertPosition(e.name);
+            beginInsertRows(QModelIndex(), pos, pos);
+            m_rows.insert(pos, e);
+            m_rows[pos].backedUp = backedUp(e.name);
+            endInsertRows();
+        }
+    }
+
+    if (m_rows.size() != before)
+        emit countChanged();
+    emit filesChanged();
+}
+
+void LogDirectoryIndex::onBackedUp(const QString& path)
+{
+    const QFileInfo fi(path);
+    if (fi.absolutePath() != m_dirPath) return;
+    const int row = find(fi.fileName());
+    if (row < 0 || m_rows.at(row).backedUp) return;
+    m_rows[row].backedUp = true;
+    emit dataChanged(index(row), index(row), { BackedUpRole });
+}
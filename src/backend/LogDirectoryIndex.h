@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+#include <functional>
+
+class LogStorageBackend;
+class LogDirectoryScanner;
+
+// Cached listing of one log directory for QML, newest first (file names start with their
+// timestamp). A scanner on its own thread watches the directory with QFileSystemWatcher, lists it
+// when it changes and reads metadata only for files that are new or whose size or mtime changed;
+// the GUI thread receives the difference and applies it as row inserts, removals and
+// dataChanged, so views keep their position and nothing on the GUI thread touches the disk.
+class LogDirectoryIndex final : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles {
+        FileNameRole = Qt::UserRole + 1,
+        SizeRole,           // bytes on disk
+        SizeTextRole,       // "12.3 MB"
+        DurationMsRole,     // -1 = unknown
+        DurationTextRole,   // "m:ss", empty when unknown
+        EventsRole,         // -1 = unknown
+        BackedUpRole,
+        ModifiedMsRole
+    };
+
+    struct Entry
+    {
+        QString name;
+        qint64 size = 0;
+        qint64 mtimeMs = 0;
+        qint64 durationMs = -1;
+        qint64 events = -1;
+        bool backedUp = false;   // filled in on the GUI thread
+    };
+    // Fills durationMs / events of `entry` from the file at `path`; runs on the scanner thread, so
+    // it must not touch any QObject.
+    using MetadataReader = std::function<void(const QString& path, Entry& entry)>;
+
+    LogDirectoryIndex(const QString& dirPath, const QStringList& nameFilters, const MetadataReader& reader,
+                      QObject* parent = nullptr);
+    ~LogDirectoryIndex() override;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const { return m_rows.size(); }
+    QString dirPath() const { return m_dirPath; }
+    QStringList fileNames() const;
+    // Backed-up flags come from the storage backend's ledger
+    void setStorageBackend(LogStorageBackend* storage);
+
+    // Lists the directory again in the background (e.g. after creating it); returns immediately.
+    Q_INVOKABLE void rescan();
+
+signals:
+    void countChanged();
+    // Any row added, removed or changed
+    void filesChanged();
+
+private:
+    friend class LogDirectoryScanner;
+    void apply(const QVector<Entry>& upserts, const QStringList& removed);
+    void onBackedUp(const QString& path);
+    int find(const QString& name) const;          // row, or -1
+    int insertPosition(const QString& name) const;
+
+    QString m_dirPath;
+    QVector<Entry> m_rows;                        // by name, descending
+    LogStorageBackend* m_storage = nullptr;
+    QThread m_thread;
+    LogDirectoryScanner* m_scanner = nullptr;     // lives on m_thread
+};
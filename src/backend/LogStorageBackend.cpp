@@ -0,0 +1,409 @@
+#include "LogStorageBackend.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStorageInfo>
+#include <algorithm>
+
+static const char kStorageGroup[] = "storage";
+static const char kLedgerName[] = ".backup_ledger";
+
+static QString megabytes(qint64 bytes)
+{
+    return QString::number(qMax<qint64>(0, bytes) / (1024 * 1024));
+}
+
+LogStorageBackend::LogStorageBackend(QObject* parent)
+    : QObject(parent)
+{
+    loadSettings();
+    connect(&m_checkTimer, &QTimer::timeout, this, &LogStorageBackend::check);
+    m_checkTimer.start();
+}
+
+void LogStorageBackend::loadSettings()
+{
+    QSettings s(QStringLiteral("OSU"), QStringLiteral("HMI_Mk1"));
+    s.beginGroup(kStorageGroup);
+    const qint64 mb = 1024 * 1024;
+    m_reserveFreeBytes = s.value("reserveFreeMB", 256).toLongLong() * mb;
+    m_warnFreeBytes = qMax(m_reserveFreeBytes, s.value("warnFreeMB", 1024).toLongLong() * mb);
+    m_roots[CanRoot].quotaBytes = qMax<qint64>(0, s.value("canQuotaMB", 0).toLongLong()) * mb;
+    m_roots[IntelRoot].quotaBytes = qMax<qint64>(0, s.value("intelQuotaMB", 0).toLongLong()) * mb;
+    m_checkTimer.setInterval(qMax(250, s.value("checkIntervalMs", 2000).toInt()));
+    s.endGroup();
+}
+
+const char* LogStorageBackend::rootName(int root)
+{
+    return root == CanRoot ? "CAN" : "Intel";
+}
+
+qint64 LogStorageBackend::usedBytes() const
+{
+    qint64 total = 0;
+    for (const RootState& r : m_roots)
+        total += r.bytes + r.pendingBytes;
+    return total;
+}
+
+QString LogStorageBackend::level() const
+{
+    switch (m_level) {
+    case Low: return QStringLiteral("low");
+    case Full: return QStringLiteral("full");
+    default: return QStringLiteral("ok");
+    }
+}
+
+void LogStorageBackend::setRoot(Root root, const QString& dirPath, const QStringList& sidecarSuffixes)
+{
+    RootState& r = m_roots[root];
+    r.dir = QDir(dirPath).absolutePath();
+    r.sidecarSuffixes = sidecarSuffixes;
+    scanRoot(r);
+    loadLedger(r);
+    check();
+}
+
+void LogStorageBackend::scanRoot(RootState& r)
+{
+    r.files.clear();
+    r.bytes = 0;
+    if (r.dir.isEmpty()) return;
+    const QFileInfoList entries = QDir(r.dir).entryInfoList(QDir::Files);   // no hidden files: skips the ledger
+    for (const QFileInfo& fi : entries) {
+        r.files.insert(fi.fileName(), FileStamp{ fi.size(), fi.lastModified().toMSecsSinceEpoch() });
+        r.bytes += fi.size();
+    }
+}
+
+void LogStorageBackend::loadLedger(RootState& r)
+{
+    r.backedUp.clear();
+    QFile f(r.dir + "/" + kLedgerName);
+    if (!f.open(QIODevice::ReadOnly)) return;
+    int lines = 0;
+    while (!f.atEnd()) {
+        // name \t size \t mtimeMs; later lines replace earlier ones
+        const QList<QByteArray> fields = f.readLine().trimmed().split('\t');
+        if (fields.size() != 3) continue;
+        r.backedUp.insert(QString::fromUtf8(fields[0]), FileStamp{ fields[1].toLongLong(), fields[2].toLongLong() });
+        ++lines;
+    }
+    f.close();
+    // Every backup run uploads everything again, so the ledger keeps growing: compact it here
+    if (lines > 2 * r.backedUp.size() + 64)
+        saveLedger(r);
+}
+
+void LogStorageBackend::saveLedger(const RootState& r) const
+{
+    QSaveFile f(r.dir + "/" + kLedgerName);
+    if (!f.open(QIODevice::WriteOnly)) {
+        qWarning() << "LogStorageBackend: cannot write" << f.fileName() << f.errorString();
+        return;
+    }
+    for (auto it = r.backedUp.cbegin(); it != r.backedUp.cend(); ++it) {
+        if (!r.files.contains(it.key())) continue;   // deleted since
+        f.write(it.key().toUtf8() + '\t' + QByteArray::number(it->size) + '\t' + QByteArray::number(it->mtimeMs) + '\n');
+    }
+    if (!f.commit())
+        qWarning() << "LogStorageBackend: cannot write" << f.fileName() << f.errorString();
+}
+
+void LogStorageBackend::saveLedgers() const
+{
+    for (const RootState& r : m_roots) {
+        if (!r.dir.isEmpty())
+            saveLedger(r);
+    }
+}
+
+int LogStorageBackend::rootOf(const QString& path, QString* name) const
+{
+    const QFileInfo fi(path);
+    const QString dir = fi.absolutePath();
+    for (int i = 0; i < RootCount; ++i) {
+        if (!m_roots[i].dir.isEmpty() && dir == m_roots[i].dir) {
+            if (name) *name = fi.fileName();
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool LogStorageBackend::isBackedUp(const RootState& r, const QString& name) const
+{
+    const auto file = r.files.constFind(name);
+    const auto backup = r.backedUp.constFind(name);
+    return file != r.files.cend() && backup != r.backedUp.cend()
+           && file->size == backup->size && file->mtimeMs == backup->mtimeMs;
+}
+
+bool LogStorageBackend::isFileBackedUp(const QString& path) const
+{
+    QString name;
+    const int root = rootOf(path, &name);
+    return root >= 0 && isBackedUp(m_roots[root], name);
+}
+
+bool LogStorageBackend::isSidecar(const RootState& r, const QString& name) const
+{
+    for (const QString& suffix : r.sidecarSuffixes) {
+        if (name.endsWith(suffix))
+            return true;
+    }
+    return false;
+}
+
+void LogStorageBackend::fileAdded(const QString& path)
+{
+    QString name;
+    const int root = rootOf(path, &name);
+    if (root < 0) return;
+    RootState& r = m_roots[root];
+    const QFileInfo fi(path);
+    if (!fi.exists()) return;
+    r.bytes -= r.files.value(name).size;
+    r.files.insert(name, FileStamp{ fi.size(), fi.lastModified().toMSecsSinceEpoch() });
+    r.bytes += fi.size();
+    emit statsChanged();
+    updateLevel();
+}
+
+void LogStorageBackend::fileRemoved(const QString& path)
+{
+    QString name;
+    const int root = rootOf(path, &name);
+    if (root < 0) return;
+    RootState& r = m_roots[root];
+    const auto it = r.files.find(name);
+    if (it == r.files.end()) return;
+    r.bytes -= it->size;
+    r.files.erase(it);
+    emit statsChanged();
+    updateLevel();
+}
+
+void LogStorageBackend::setPendingBytes(Root root, qint64 bytes)
+{
+    m_roots[root].pendingBytes = qMax<qint64>(0, bytes);
+}
+
+void LogStorageBackend::setProtectedPrefix(Root root, const QString& prefix)
+{
+    m_roots[root].protectedPrefix = prefix;
+}
+
+void LogStorageBackend::markBackedUp(const QString& path, qint64 size, qint64 mtimeMs)
+{
+    QString name;
+    const int root = rootOf(path, &name);
+    if (root < 0) return;
+    RootState& r = m_roots[root];
+    const QFileInfo fi(path);
+    if (!fi.exists()) return;
+    // The stamp of the uploaded copy: if the file has grown since, it no longer matches
+    const FileStamp stamp{ size, mtimeMs };
+    r.backedUp.insert(name, stamp);
+    // Uploaded before this backend heard of it (e.g. written since the start-up scan)
+    if (!r.files.contains(name)) {
+        r.files.insert(name, FileStamp{ fi.size(), fi.lastModified().toMSecsSinceEpoch() });
+        r.bytes += fi.size();
+    }
+    emit backedUpChanged(path);
+
+    QFile f(r.dir + "/" + kLedgerName);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "LogStorageBackend: cannot update" << f.fileName() << f.errorString();
+        return;
+    }
+    f.write(name.toUtf8() + '\t' + QByteArray::number(stamp.size) + '\t' + QByteArray::number(stamp.mtimeMs) + '\n');
+}
+
+qint64 LogStorageBackend::freeUp(RootState& r, qint64 needBytes, QStringList& deleted)
+{
+    if (needBytes <= 0) return 0;
+
+    // Oldest first; sidecars go with their file, files in use and not yet backed up are kept
+    QStringList candidates;
+    for (auto it = r.files.cbegin(); it != r.files.cend(); ++it) {
+        const QString& name = it.key();
+        if (isSidecar(r, name) || !isBackedUp(r, name)) continue;
+        if (!r.protectedPrefix.isEmpty() && name.startsWith(r.protectedPrefix)) continue;
+        candidates.append(name);
+    }
+    std::sort(candidates.begin(), candidates.end(), [&r](const QString& a, const QString& b) {
+        const qint64 ta = r.files.value(a).mtimeMs, tb = r.files.value(b).mtimeMs;
+        return ta != tb ? ta < tb : a < b;
+    });
+
+    qint64 freed = 0;
+    for (const QString& name : candidates) {
+        if (freed >= needBytes) break;
+        QStringList group{ name };
+        for (const QString& suffix : r.sidecarSuffixes) {
+            if (r.files.contains(name + suffix))
+                group.append(name + suffix);
+        }
+        for (const QString& file : group) {
+            const QString path = r.dir + "/" + file;
+            if (!QFile::remove(path)) {
+                qWarning() << "LogStorageBackend: could not delete" << path;
+                continue;
+            }
+            const qint64 size = r.files.value(file).size;
+            r.files.remove(file);
+            r.backedUp.remove(file);
+            r.bytes -= size;
+            freed += size;
+            deleted.append(path);
+        }
+    }
+    return freed;
+}
+
+void LogStorageBackend::freeUpAll(qint64 needBytes, QStringList& deleted)
+{
+    for (RootState& r : m_roots) {
+        if (needBytes <= 0) break;
+        needBytes -= freeUp(r, needBytes, deleted);
+    }
+}
+
+void LogStorageBackend::refreshFreeSpace()
+{
+    m_freeBytes = -1;
+    for (RootState& r : m_roots) {
+        r.freeBytes = -1;
+        if (r.dir.isEmpty()) continue;
+        // The directory may not exist until the first recording; its parent is on the same disk
+        QString dir = r.dir;
+        while (!QFileInfo::exists(dir)) {
+            const QString up = QDir::cleanPath(dir + "/..");
+            if (up == dir) break;
+            dir = up;
+        }
+        const QStorageInfo info(dir);
+        if (!info.isValid() || !info.isReady()) continue;
+        r.freeBytes = info.bytesAvailable();
+        if (m_freeBytes < 0 || r.freeBytes < m_freeBytes)
+            m_freeBytes = r.freeBytes;
+    }
+}
+
+bool LogStorageBackend::reserve(Root root, qint64 bytes, QString* error)
+{
+    RootState& r = m_roots[root];
+    refreshFreeSpace();
+    QStringList deleted;
+    if (r.quotaBytes > 0)
+        freeUp(r, r.bytes + r.pendingBytes + bytes - r.quotaBytes, deleted);
+    if (r.freeBytes >= 0)
+        freeUpAll(m_reserveFreeBytes + bytes - r.freeBytes, deleted);
+    if (!deleted.isEmpty()) {
+        qInfo() << "LogStorageBackend: deleted" << deleted.size() << "backed-up files to make room";
+        saveLedgers();
+        refreshFreeSpace();
+        emit filesDeleted(deleted);
+        emit statsChanged();
+    }
+    updateLevel();
+
+    QString message;
+    if (r.freeBytes >= 0 && r.freeBytes - bytes < m_reserveFreeBytes)
+        message = tr("Not enough disk space (%1 MB free). Back up logs so old ones can be deleted.").arg(megabytes(r.freeBytes));
+    else if (r.quotaBytes > 0 && r.bytes + r.pendingBytes + bytes > r.quotaBytes)
+        message = tr("%1 logs are at their %2 MB quota. Back up logs so old ones can be deleted.")
+                      .arg(QLatin1String(rootName(root)), megabytes(r.quotaBytes));
+    if (message.isEmpty())
+        return true;
+    qWarning() << "LogStorageBackend:" << message;
+    if (error) *error = message;
+    return false;
+}
+
+void LogStorageBackend::enforce()
+{
+    refreshFreeSpace();
+    QStringList deleted;
+    // Quotas, then keep the disk above the warning level while there is backed-up data to drop
+    for (RootState& r : m_roots) {
+        if (r.quotaBytes > 0)
+            freeUp(r, r.bytes + r.pendingBytes - r.quotaBytes, deleted);
+    }
+    if (m_freeBytes >= 0)
+        freeUpAll(m_warnFreeBytes - m_freeBytes, deleted);
+    if (deleted.isEmpty()) return;
+
+    qInfo() << "LogStorageBackend: retention deleted" << deleted.size() << "backed-up files";
+    saveLedgers();
+    refreshFreeSpace();
+    emit filesDeleted(deleted);
+    emit statsChanged();
+}
+
+void LogStorageBackend::rescan()
+{
+    for (RootState& r : m_roots)
+        scanRoot(r);
+    saveLedgers();
+    check();
+}
+
+void LogStorageBackend::updateLevel()
+{
+    Level level = Ok;
+    QString warning;
+    if (m_freeBytes >= 0 && m_freeBytes < m_reserveFreeBytes) {
+        level = Full;
+        warning = tr("Disk full: %1 MB free. Recording is stopped; back up logs to free space.").arg(megabytes(m_freeBytes));
+    }
+    for (int i = 0; i < RootCount && level != Full; ++i) {
+        const RootState& r = m_roots[i];
+        if (r.quotaBytes > 0 && r.bytes + r.pendingBytes >= r.quotaBytes) {
+            level = Full;
+            warning = tr("%1 logs are at their %2 MB quota; back up logs to free space.")
+                          .arg(QLatin1String(rootName(i)), megabytes(r.quotaBytes));
+        }
+    }
+    if (level == Ok && m_freeBytes >= 0 && m_freeBytes < m_warnFreeBytes) {
+        level = Low;
+        warning = tr("Disk space low: %1 MB free.").arg(megabytes(m_freeBytes));
+    }
+    for (int i = 0; i < RootCount && level == Ok; ++i) {
+        const RootState& r = m_roots[i];
+        if (r.quotaBytes > 0 && (r.bytes + r.pendingBytes) * 10 > r.quotaBytes * 9) {
+            level = Low;
+            warning = tr("%1 logs use %2 of %3 MB.")
+                          .arg(QLatin1String(rootName(i)), megabytes(r.bytes + r.pendingBytes), megabytes(r.quotaBytes));
+        }
+    }
+
+    const Level previous = m_level;
+    if (level == m_level && warning == m_warning) return;
+    m_level = level;
+    m_warning = warning;
+    emit levelChanged();
+    if (level != previous) {
+        if (level == Ok)
+            qInfo() << "LogStorageBackend: storage ok";
+        else
+            qWarning() << "LogStorageBackend:" << warning;
+    }
+    if (level == Full && previous != Full)
+        emit spaceCritical();
+}
+
+void LogStorageBackend::check()
+{
+    const qint64 freeBefore = m_freeBytes;
+    enforce();
+    if (m_freeBytes != freeBefore)
+        emit statsChanged();
+    updateLevel();
+}
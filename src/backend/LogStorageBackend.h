@@ -0,0 +1,120 @@
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+// Disk budget for the log directories (src/logs/CAN, src/logs/intel). Keeps the size of each
+// directory and the free space of its filesystem up to date incrementally (one scan at start-up,
+// then the writers report the files they add), enforces a quota per directory and a free-space
+// reserve by deleting the oldest files that are already backed up, and reports when space runs
+// low so writers stop cleanly before the filesystem starts failing them.
+//
+// Backed-up files are recorded in a hidden "<dir>/.backup_ledger" (name, size, mtime); a file
+// that changed since its upload counts as not backed up. Files that are not backed up are never
+// deleted: when only those are left the level stays "low" / "full" and writes are refused.
+//
+// QSettings group "storage": reserveFreeMB (256, below it the level is "full"), warnFreeMB (1024),
+// canQuotaMB (0 = no quota), intelQuotaMB (0), checkIntervalMs (2000).
+class LogStorageBackend : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(qint64 freeBytes READ freeBytes NOTIFY statsChanged)
+    Q_PROPERTY(qint64 usedBytes READ usedBytes NOTIFY statsChanged)
+    // "ok", "low" (below warnFreeMB, or a directory over 90 % of its quota) or "full" (below
+    // reserveFreeMB, or a directory at its quota; new recordings and saves are refused)
+    Q_PROPERTY(QString level READ level NOTIFY levelChanged)
+    Q_PROPERTY(QString warning READ warning NOTIFY levelChanged)
+
+public:
+    enum Level { Ok, Low, Full };
+    enum Root { CanRoot, IntelRoot, RootCount };
+
+    explicit LogStorageBackend(QObject* parent = nullptr);
+
+    qint64 freeBytes() const { return m_freeBytes; }
+    qint64 usedBytes() const;
+    QString level() const;
+    QString warning() const { return m_warning; }
+    Level levelValue() const { return m_level; }
+
+    // Files ending in one of `sidecarSuffixes` (e.g. ".idx") belong to the file they extend and are
+    // deleted with it. Scans the directory once.
+    void setRoot(Root root, const QString& dirPath, const QStringList& sidecarSuffixes = QStringList());
+
+    // Makes room for `bytes` more under `root` (deleting backed-up files if needed); false if that
+    // would still cross the reserve or the quota. `error` gets a message for the user.
+    bool reserve(Root root, qint64 bytes, QString* error = nullptr);
+    // Writers report what they add and remove; paths outside the roots are ignored.
+    void fileAdded(const QString& path);
+    void fileRemoved(const QString& path);
+    // Bytes of a file still being written under `root` (counts against its quota)
+    void setPendingBytes(Root root, qint64 bytes);
+    // Files whose name starts with `prefix` are in use and never deleted; empty clears it.
+    void setProtectedPrefix(Root root, const QString& prefix);
+    // Uploaded and unchanged since
+    bool isFileBackedUp(const QString& path) const;
+
+    Q_INVOKABLE void rescan();
+    Q_INVOKABLE void enforce();
+
+public slots:
+    // From LogBackupBackend after a file was uploaded; size and mtimeMs as it was read for upload
+    void markBackedUp(const QString& path, qint64 size, qint64 mtimeMs);
+
+signals:
+    void statsChanged();
+    void levelChanged();
+    // Free space fell below the reserve, or a quota was reached with nothing left to delete;
+    // writers should finish what they have open now.
+    void spaceCritical();
+    // Files removed by the retention policy
+    void filesDeleted(const QStringList& paths);
+    void backedUpChanged(const QString& path);
+
+private:
+    struct FileStamp
+    {
+        qint64 size = 0;
+        qint64 mtimeMs = 0;
+    };
+    struct RootState
+    {
+        QString dir;
+        QStringList sidecarSuffixes;
+        qint64 quotaBytes = 0;        // 0 = none
+        qint64 bytes = 0;             // files in `files`
+        qint64 pendingBytes = 0;
+        qint64 freeBytes = -1;        // of its filesystem; -1 = unknown
+        QString protectedPrefix;
+        QHash<QString, FileStamp> files;       // by file name
+        QHash<QString, FileStamp> backedUp;    // ledger: as uploaded, by file name
+    };
+
+    void loadSettings();
+    void scanRoot(RootState& r);
+    void loadLedger(RootState& r);
+    void saveLedger(const RootState& r) const;
+    void saveLedgers() const;
+    int rootOf(const QString& path, QString* name) const;
+    static const char* rootName(int root);
+    bool isBackedUp(const RootState& r, const QString& name) const;
+    bool isSidecar(const RootState& r, const QString& name) const;
+    // Deletes backed-up files, oldest first, until `needBytes` are freed; returns the bytes freed
+    qint64 freeUp(RootState& r, qint64 needBytes, QStringList& deleted);
+    // Free-space shortfall: backed-up files of every root, the CAN recordings first
+    void freeUpAll(qint64 needBytes, QStringList& deleted);
+    void refreshFreeSpace();
+    void updateLevel();
+    void check();
+
+    RootState m_roots[RootCount];
+    qint64 m_reserveFreeBytes = 0;
+    qint64 m_warnFreeBytes = 0;
+    qint64 m_freeBytes = -1;       // lowest of the roots' filesystems
+    Level m_level = Ok;
+    QString m_warning;
+    QTimer m_checkTimer;
+};
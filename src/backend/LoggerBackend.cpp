@@ -1,14 +1,28 @@
 #include "LoggerBackend.h"
+#include "CanLogFormat.h"
+#include "CanLogWriter.h"
+#include "LogBlockFile.h"
+#include "LogStorageBackend.h"
+#include "SessionContainer.h"
 #include <QDir>
 #include <QCoreApplication>
 #include <QDebug>
 #include <QDateTime>
 #include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
 #include <QSettings>
-#include <QTextStream>
-#include <algorithm>
 
 static const char kLoggerGroup[] = "logger";
+static const char kManifestSuffix[] = ".session.json";
+
+static QString sessionSegmentPath(const QString& dir, const QString& session, const QString& suffix, int index)
+{
+    return dir + "/" + session + QStringLiteral("_%1").arg(index, 3, 10, QLatin1Char('0')) + suffix;
+}
 
 void LoggerBackend::loadBusSelection()
 {
@@ -18,7 +32,38 @@ void LoggerBackend::loadBusSelection()
     m_canCE = s.value("canCE", true).toBool();
     m_canSC = s.value("canSC", true).toBool();
     m_canLS = s.value("canLS", true).toBool();
+    m_idFilterText = s.value("idFilter").toString();
+    if (!m_idFilter.compile(m_idFilterText, &m_idFilterError)) {
+        qWarning() << "LoggerBackend: ignoring saved ID filter:" << m_idFilterError;
+        m_idFilterText.clear();
+    }
+    m_recordFormat = s.value("recordFormat", "csv").toString();
+    if (m_recordFormat != QLatin1String("binary"))
+        m_recordFormat = QStringLiteral("csv");
+    m_compressRecordings = s.value("compressRecordings", false).toBool();
+    m_recordAllStreams = s.value("recordAllStreams", false).toBool();
+    m_preTriggerSeconds = qBound(0, s.value("preTriggerSeconds", 10).toInt(), 600);
+    s.endGroup();
+}
+
+static CanLogWriter::Config loadWriterConfig(bool compress)
+{
+    // QSettings-only tuning for slow or fast media; defaults suit an SD card
+    CanLogWriter::Config c;
+    QSettings s(QStringLiteral("OSU"), QStringLiteral("HMI_Mk1"));
+    s.beginGroup(kLoggerGroup);
+    c.flushIntervalMs = s.value("writerFlushIntervalMs", c.flushIntervalMs).toInt();
+    c.flushBytes = s.value("writerFlushBytes", static_cast<qint64>(c.flushBytes)).toLongLong();
+    c.syncIntervalMs = s.value("writerSyncIntervalMs", c.syncIntervalMs).toInt();
+    c.maxQueuedBytes = s.value("writerMaxQueuedBytes", static_cast<qint64>(c.maxQueuedBytes)).toLongLong();
+    c.compressLevel = compress ? s.value("compressLevel", 1).toInt() : 0;
+    c.blockBytes = s.value("compressBlockBytes", static_cast<qint64>(c.blockBytes)).toLongLong();
+    c.blockMaxAgeMs = s.value("compressBlockMaxAgeMs", c.blockMaxAgeMs).toInt();
+    // Segment rollover; 0 disables a limit
+    c.segmentMaxBytes = s.value("segmentMaxBytes", Q_INT64_C(256) * 1024 * 1024).toLongLong();
+    c.segmentMaxMs = s.value("segmentMaxMinutes", 10).toLongLong() * 60 * 1000;
     s.endGroup();
+    return c;
 }
 
 void LoggerBackend::saveBusSelection() const
@@ -29,6 +74,11 @@ void LoggerBackend::saveBusSelection() const
     s.setValue("canCE", m_canCE);
     s.setValue("canSC", m_canSC);
     s.setValue("canLS", m_canLS);
+    s.setValue("idFilter", m_idFilterText);
+    s.setValue("recordFormat", m_recordFormat);
+    s.setValue("compressRecordings", m_compressRecordings);
+    s.setValue("recordAllStreams", m_recordAllStreams);
+    s.setValue("preTriggerSeconds", m_preTriggerSeconds);
     s.endGroup();
     s.sync();
 }
@@ -37,7 +87,76 @@ LoggerBackend::LoggerBackend(QObject* parent)
     : QObject(parent)
 {
     loadBusSelection();
-    refreshLogList();
+    configurePreTrigger();
+    recoverInterruptedSessions();
+    const QString z = "." + LogBlock::fileSuffix();
+    m_logIndex = new LogDirectoryIndex(resolveLogsDir(),
+                                       { "*.csv", "*." + CanLog::fileSuffix(), "*.csv" + z, "*." + CanLog::fileSuffix() + z },
+                                       &LoggerBackend::readLogMetadata, this);
+    connect(m_logIndex, &LogDirectoryIndex::filesChanged, this, &LoggerBackend::logFileNamesChanged);
+    m_writerStatsTimer.setInterval(500);
+    connect(&m_writerStatsTimer, &QTimer::timeout, this, &LoggerBackend::writerStatsChanged);
+    connect(&m_writerStatsTimer, &QTimer::timeout, this, &LoggerBackend::updateStorageUsage);
+
+    // No parent: moveToThread() requires it; deleted on the query thread when it finishes.
+    m_queryWorker = new QObject;
+    m_queryWorker->moveToThread(&m_queryThread);
+    connect(&m_queryThread, &QThread::finished, m_queryWorker, &QObject::deleteLater);
+    m_queryThread.setObjectName(QStringLiteral("HMI-LogQuery"));
+    m_queryThread.start(QThread::LowPriority);
+}
+
+void LoggerBackend::setStorageBackend(LogStorageBackend* storage)
+{
+    m_storage = storage;
+    if (!m_storage) return;
+    m_storage->setRoot(LogStorageBackend::CanRoot, resolveLogsDir(), { "." + CanLogIndex::fileSuffix() });
+    m_logIndex->setStorageBackend(m_storage);
+    connect(m_storage, &LogStorageBackend::spaceCritical, this, &LoggerBackend::onSpaceCritical);
+    connect(m_storage, &LogStorageBackend::filesDeleted, this, &LoggerBackend::refreshLogList);
+}
+
+void LoggerBackend::updateStorageUsage()
+{
+    if (!m_storage || !m_writer || !m_recording) return;
+    // Bytes of the open segment (finalised segments are reported to the storage backend as files)
+    // and of the session container, which grows fastest when it carries camera frames
+    qint64 closed = 0;
+    for (const CanLogWriter::Segment& seg : m_segments)
+        closed += seg.bytes;
+    m_storage->setPendingBytes(LogStorageBackend::CanRoot,
+                               static_cast<qint64>(m_writer->writtenBytes()) - closed + m_containerBytes);
+}
+
+void LoggerBackend::onSpaceCritical()
+{
+    if (!m_recording || !m_storage) return;
+    // The disk is about to fill: close the recording cleanly rather than let the writes fail
+    QString error;
+    if (m_storage->reserve(LogStorageBackend::CanRoot, 0, &error)) return;
+    qWarning() << "LoggerBackend: saving recording" << m_sessionName << "early:" << error;
+    saveRecording();
+}
+
+LoggerBackend::~LoggerBackend()
+{
+    m_queryAbort.store(true, std::memory_order_relaxed);
+    m_queryThread.quit();
+    m_queryThread.wait();
+    m_queryWorker = nullptr;
+
+    // A recording still open at shutdown is kept, not discarded. Its session is finished here
+    // rather than in the queued onWriterFinished(), which would never run.
+    if (m_recording)
+        stopWriter();
+    if (m_writerClosing) {
+        m_writer->wait();
+        m_segments = m_writer->segments();
+        if (m_discardOnClose)
+            removeSessionFiles();
+        else
+            writeManifest(QStringLiteral("complete"));
+    }
 }
 
 QString LoggerBackend::resolveLogsDir() const
@@ -76,52 +195,280 @@ QString LoggerBackend::logsRootPath() const
     return d.absolutePath();
 }
 
-QString LoggerBackend::currentRecordingPath() const
+QString LoggerBackend::manifestPath() const
 {
-    const QString dirPath = resolveLogsDir();
-    QDir dir(dirPath);
-    if (!dir.exists())
-        dir.mkpath(".");
-    const QString fileName = QDateTime::currentDateTime().toString("MM-dd-yyyy_HH-mm-ss") + ".csv";
-    return dir.absoluteFilePath(fileName);
+    return m_sessionDir + "/" + m_sessionName + kManifestSuffix;
+}
+
+void LoggerBackend::writeManifest(const QString& state) const
+{
+    QJsonArray segments;
+    for (const CanLogWriter::Segment& seg : m_segments) {
+        QJsonObject o;
+        o["index"] = seg.index;
+        o["file"] = QFileInfo(seg.path).fileName();
+        o["bytes"] = seg.bytes;
+        o["events"] = static_cast<qint64>(seg.events);
+        o["startEpochMs"] = seg.startEpochMs;
+        o["endEpochMs"] = seg.endEpochMs;
+        segments.append(o);
+    }
+    QJsonObject root;
+    root["session"] = m_sessionName;
+    root["format"] = m_fileBinary ? QStringLiteral("binary") : QStringLiteral("csv");
+    root["compressed"] = m_sessionSuffix.endsWith("." + LogBlock::fileSuffix());
+    root["state"] = state;   // recording | complete | recovered
+    if (!m_containerPath.isEmpty())
+        root["container"] = QFileInfo(m_containerPath).fileName();
+    root["segments"] = segments;
+
+    QSaveFile f(manifestPath());
+    if (!f.open(QIODevice::WriteOnly)) {
+        qWarning() << "LoggerBackend: failed to write manifest" << f.fileName() << f.errorString();
+        return;
+    }
+    f.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    if (!f.commit())
+        qWarning() << "LoggerBackend: failed to commit manifest" << f.fileName() << f.errorString();
+}
+
+void LoggerBackend::onSegmentClosed(const QString& session, const CanLogWriter::Segment& segment)
+{
+    // Queued from the writer thread; the final segment of a session is recorded by onWriterFinished()
+    if (!m_recording || session != m_sessionName) return;
+    m_segments.append(segment);
+    writeManifest(QStringLiteral("recording"));
+    if (m_storage) {
+        m_storage->fileAdded(segment.path);
+        m_storage->fileAdded(segment.path + "." + CanLogIndex::fileSuffix());
+    }
+    refreshLogList();
+    emit segmentClosed(segment.path);
+}
+
+void LoggerBackend::recoverInterruptedSessions()
+{
+    // After a crash: keep whatever of the open segment reached the disk, and mark its session
+    QDir dir(resolveLogsDir());
+    if (!dir.exists()) return;
+    const QStringList partials = dir.entryList(QStringList() << "*" + CanLogWriter::partialSuffix(), QDir::Files);
+    for (const QString& name : partials) {
+        const QString finalName = name.chopped(CanLogWriter::partialSuffix().size());
+        if (dir.exists(finalName) || !dir.rename(name, finalName))
+            qWarning() << "LoggerBackend: could not recover" << dir.absoluteFilePath(name);
+        else
+            qInfo() << "LoggerBackend: recovered interrupted segment" << finalName;
+    }
+
+    const QStringList manifests = dir.entryList(QStringList() << QString("*") + kManifestSuffix, QDir::Files);
+    for (const QString& name : manifests) {
+        QFile f(dir.absoluteFilePath(name));
+        if (!f.open(QIODevice::ReadOnly)) continue;
+        QJsonObject root = QJsonDocument::fromJson(f.readAll()).object();
+        f.close();
+        if (root.value("state").toString() != QLatin1String("recording")) continue;
+
+        // Rebuild the segment list from disk; the interrupted segment has no counters
+        const QString session = root.value("session").toString();
+        QHash<QString, QJsonObject> known;
+        for (const QJsonValue& v : root.value("segments").toArray())
+            known.insert(v.toObject().value("file").toString(), v.toObject());
+        QStringList files = dir.entryList(QStringList() << session + "_*", QDir::Files, QDir::Name);
+        QJsonArray segments;
+        for (const QString& file : files) {
+            if (file.endsWith(kManifestSuffix) || file.endsWith("." + CanLogIndex::fileSuffix())) continue;
+            QJsonObject o = known.value(file);
+            if (o.isEmpty()) {
+                o["index"] = file.mid(session.size() + 1, 3).toInt();
+                o["file"] = file;
+                o["recovered"] = true;
+            }
+            o["bytes"] = QFileInfo(dir.absoluteFilePath(file)).size();
+            segments.append(o);
+        }
+        root["segments"] = segments;
+        root["state"] = QStringLiteral("recovered");
+
+        QSaveFile out(dir.absoluteFilePath(name));
+        if (out.open(QIODevice::WriteOnly)) {
+            out.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+            out.commit();
+        }
+    }
+}
+
+void LoggerBackend::removeSessionFiles()
+{
+    QStringList paths;
+    for (const CanLogWriter::Segment& seg : m_segments)
+        paths << seg.path << seg.path + "." + CanLogIndex::fileSuffix();
+    paths << manifestPath();   // the session container is deleted by its writer (stopWriter(true))
+    for (const QString& path : paths) {
+        QFile::remove(path);
+        if (m_storage)
+            m_storage->fileRemoved(path);
+    }
+    m_segments.clear();
+}
+
+void LoggerBackend::reportSessionFiles() const
+{
+    if (!m_storage) return;
+    for (const CanLogWriter::Segment& seg : m_segments) {
+        m_storage->fileAdded(seg.path);
+        m_storage->fileAdded(seg.path + "." + CanLogIndex::fileSuffix());
+    }
+    m_storage->fileAdded(manifestPath());   // the container follows in onSessionContainerFinished()
+    m_storage->setPendingBytes(LogStorageBackend::CanRoot, 0);
+    m_storage->setProtectedPrefix(LogStorageBackend::CanRoot, QString());
 }
 
-QString LoggerBackend::dataToHex(const std::string& data)
+void LoggerBackend::stopWriter(bool discard)
 {
-    if (data.empty()) return QString();
-    QByteArray ba(data.data(), static_cast<int>(data.size()));
-    return QString::fromLatin1(ba.toHex(' ').constData());
+    m_writerStatsTimer.stop();
+    // Also while the open is still in flight: the receiver handles start and stop in order
+    if (!m_containerRequest.isEmpty()) {
+        m_closingContainer = discard ? QString() : m_containerRequest;
+        m_containerRequest.clear();
+        emit allStreamsRecordingStopped(discard);
+    }
+    if (!m_writer) return;
+    // Returns at once; the writer drains its queue and syncs the last segment on its own thread
+    m_writer->stop();
+    m_writerClosing = true;
+    m_discardOnClose = discard;
 }
 
-void LoggerBackend::closeAndRemoveCurrentFile()
+void LoggerBackend::onWriterFinished(const QString& session, const QVector<CanLogWriter::Segment>& segments)
 {
-    if (m_logFile) {
-        m_logFile->close();
-        m_logFile->deleteLater();
-        m_logFile = nullptr;
+    // Queued from the writer thread once the last segment is on disk
+    if (!m_writerClosing || session != m_sessionName) return;
+    m_writer->wait();   // run() has returned; only the thread exit is left
+    m_writerClosing = false;
+    if (m_writer->droppedEvents() > 0 || m_writer->writeErrors() > 0)
+        qWarning() << "LoggerBackend: recording" << m_sessionName << "dropped"
+                   << m_writer->droppedEvents() << "events," << m_writer->writeErrors() << "write errors";
+    if (m_writer->compressing() && m_writer->packedBytes() > 0)
+        qInfo() << "LoggerBackend: compressed" << m_writer->rawBytes() << "->" << m_writer->packedBytes()
+                << "bytes, ratio" << compressionRatio() << "at" << compressionMBps() << "MB/s";
+
+    m_segments = segments;
+    if (m_discardOnClose) {
+        removeSessionFiles();
+        if (m_storage) {
+            m_storage->setPendingBytes(LogStorageBackend::CanRoot, 0);
+            m_storage->setProtectedPrefix(LogStorageBackend::CanRoot, QString());
+        }
+        m_sessionName.clear();
+    } else {
+        writeManifest(QStringLiteral("complete"));
+        reportSessionFiles();
+        if (!m_segments.isEmpty())
+            emit segmentClosed(m_segments.constLast().path);
+        m_sessionName.clear();
+        refreshLogList();
+        if (m_closingContainer.isEmpty())
+            emit recordingSaved();   // otherwise once the container is complete
     }
-    if (!m_currentLogPath.isEmpty()) {
-        QFile::remove(m_currentLogPath);
-        m_currentLogPath.clear();
+
+    if (m_startPending) {
+        m_startPending = false;
+        startRecording();
     }
 }
 
+qint64 LoggerBackend::writerQueuedBytes() const
+{
+    return m_writer ? m_writer->queuedBytes() : 0;
+}
+
+qint64 LoggerBackend::writerDroppedEvents() const
+{
+    return m_writer ? static_cast<qint64>(m_writer->droppedEvents()) : 0;
+}
+
+double LoggerBackend::compressionRatio() const
+{
+    if (!m_writer || m_writer->packedBytes() == 0) return 0.0;
+    return static_cast<double>(m_writer->rawBytes()) / static_cast<double>(m_writer->packedBytes());
+}
+
+double LoggerBackend::compressionMBps() const
+{
+    if (!m_writer || m_writer->compressNs() <= 0) return 0.0;
+    return static_cast<double>(m_writer->rawBytes()) * 1e3 / static_cast<double>(m_writer->compressNs());
+}
+
 void LoggerBackend::startRecording()
 {
     if (m_recording) return;
-    closeAndRemoveCurrentFile();
-    m_currentLogPath = currentRecordingPath();
-    m_logFile = new QFile(m_currentLogPath, this);
-    if (!m_logFile->open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qWarning() << "LoggerBackend: failed to open" << m_currentLogPath << m_logFile->errorString();
-        m_logFile->deleteLater();
-        m_logFile = nullptr;
-        m_currentLogPath.clear();
+    if (m_writerClosing) {
+        // The writer is reused, so the new session opens once the last one is on disk
+        m_startPending = true;
+        return;
+    }
+    QString storageError;
+    if (m_storage && !m_storage->reserve(LogStorageBackend::CanRoot, 0, &storageError)) {
+        qWarning() << "LoggerBackend: not recording:" << storageError;
         return;
     }
-    QTextStream out(m_logFile);
-    out << "bus_id,can_id,is_extended,is_rtr,ts_ns,dlc,data_hex\n";
-    m_logFile->flush();
+    QDir dir(resolveLogsDir());
+    if (!dir.exists()) {
+        dir.mkpath(".");
+        m_logIndex->rescan();   // starts watching the new directory
+    }
+    m_sessionDir = dir.absolutePath();
+    m_sessionName = QDateTime::currentDateTime().toString("MM-dd-yyyy_HH-mm-ss");
+    m_fileBinary = binaryRecording();
+    m_sessionSuffix = "." + (m_fileBinary ? CanLog::fileSuffix() : QStringLiteral("csv"));
+    if (m_compressRecordings)
+        m_sessionSuffix += "." + LogBlock::fileSuffix();
+    m_segments.clear();
+
+    CanLogWriter::Target target;
+    // Runs on the writer thread, so it captures copies rather than touching members
+    target.segmentPath = [dir = m_sessionDir, session = m_sessionName, suffix = m_sessionSuffix](int index) {
+        return sessionSegmentPath(dir, session, suffix, index);
+    };
+    if (m_fileBinary)
+        target.header = []() { return CanLog::makeHeader(QDateTime::currentMSecsSinceEpoch()); };
+    else
+        target.header = []() { return CanLog::csvHeader(); };
+    target.binary = m_fileBinary;
+    const QString session = m_sessionName;
+    auto onClosed = [this, session](const CanLogWriter::Segment& seg) {
+        QMetaObject::invokeMethod(this, [this, session, seg]() { onSegmentClosed(session, seg); }, Qt::QueuedConnection);
+    };
+    auto onFinished = [this, session](const QVector<CanLogWriter::Segment>& segs) {
+        QMetaObject::invokeMethod(this, [this, session, segs]() { onWriterFinished(session, segs); }, Qt::QueuedConnection);
+    };
+
+    if (!m_writer)
+        m_writer = std::make_unique<CanLogWriter>();
+    CanLogWriter::Config config = loadWriterConfig(m_compressRecordings);
+    // The pre-trigger history is queued in one go at the start; let it in on top of the normal
+    // backlog (worst-case CSV line is 63 bytes) rather than dropping it
+    config.maxQueuedBytes += m_preTrigger.count() * (m_fileBinary ? CanLog::kRecordBytes : 64);
+    QString error;
+    if (!m_writer->start(target, config, onClosed, onFinished, &error)) {
+        qWarning() << "LoggerBackend: failed to open" << sessionSegmentPath(m_sessionDir, m_sessionName, m_sessionSuffix, 1) << error;
+        m_sessionName.clear();
+        return;
+    }
+    // Listed in the manifest only once the receiver confirms it (onSessionContainerStarted)
+    m_containerRequest.clear();
+    m_containerPath.clear();
+    m_containerBytes = 0;
+    if (m_recordAllStreams) {
+        m_containerRequest = m_sessionDir + "/" + m_sessionName + "." + SessionContainer::fileSuffix();
+        emit allStreamsRecordingStarted(m_containerRequest);
+    }
+    writeManifest(QStringLiteral("recording"));
+    if (m_storage)
+        m_storage->setProtectedPrefix(LogStorageBackend::CanRoot, m_sessionName);
+    flushPreTrigger();
+    m_writerStatsTimer.start();
+    emit writerStatsChanged();
     m_recording = true;
     m_paused = false;
     emit isRecordingChanged();
@@ -145,7 +492,7 @@ void LoggerBackend::resumeRecording()
 void LoggerBackend::discardRecording()
 {
     if (!m_recording) return;
-    closeAndRemoveCurrentFile();
+    stopWriter(true);   // the files are removed in onWriterFinished()
     m_recording = false;
     m_paused = false;
     emit isRecordingChanged();
@@ -155,18 +502,50 @@ void LoggerBackend::discardRecording()
 void LoggerBackend::saveRecording()
 {
     if (!m_recording) return;
-    if (m_logFile) {
-        m_logFile->close();
-        m_logFile->deleteLater();
-        m_logFile = nullptr;
-    }
-    m_currentLogPath.clear();
+    stopWriter();   // the manifest and storage accounting follow in onWriterFinished()
     m_recording = false;
     m_paused = false;
     emit isRecordingChanged();
     emit isPausedChanged();
-    refreshLogList();
-    emit recordingSaved();
+}
+
+void LoggerBackend::onSessionContainerStarted(const QString& path)
+{
+    if (!m_recording || path != m_containerRequest) return;
+    m_containerPath = path;
+    writeManifest(QStringLiteral("recording"));
+}
+
+void LoggerBackend::onSessionContainerFailed(const QString& path, const QString& error)
+{
+    qWarning() << "LoggerBackend: recording without session container" << path << error;
+    if (path == m_containerRequest)
+        m_containerRequest.clear();
+    if (path == m_closingContainer) {
+        // Saved before the failure arrived; only the CAN segments may be left to wait for
+        m_closingContainer.clear();
+        if (!m_writerClosing)
+            emit recordingSaved();
+    }
+}
+
+void LoggerBackend::onSessionContainerProgress(const QString& path, qint64 bytes)
+{
+    if (m_recording && path == m_containerPath)
+        m_containerBytes = bytes;
+}
+
+void LoggerBackend::onSessionContainerFinished(const QString& path, bool ok)
+{
+    // Queued from the RX thread; a discarded container was deleted by its writer
+    if (path != m_closingContainer) return;
+    m_closingContainer.clear();
+    if (!ok)
+        qWarning() << "LoggerBackend: session container" << path << "is incomplete";
+    else if (m_storage)
+        m_storage->fileAdded(path);
+    if (!m_writerClosing)
+        emit recordingSaved();   // otherwise once the last segment is on disk (onWriterFinished)
 }
 
 bool LoggerBackend::shouldLogBusId(quint32 busId) const
@@ -185,45 +564,226 @@ void LoggerBackend::setCanCE(bool v) { if (m_canCE == v) return; m_canCE = v; sa
 void LoggerBackend::setCanSC(bool v) { if (m_canSC == v) return; m_canSC = v; saveBusSelection(); emit canSCChanged(); }
 void LoggerBackend::setCanLS(bool v) { if (m_canLS == v) return; m_canLS = v; saveBusSelection(); emit canLSChanged(); }
 
+void LoggerBackend::setIdFilter(const QString& expression)
+{
+    const QString text = expression.trimmed();
+    if (text == m_idFilterText && m_idFilterError.isEmpty()) return;
+    QString error;
+    if (!m_idFilter.compile(text, &error)) {
+        // Keep filtering with the last good expression
+        m_idFilterError = error;
+        emit idFilterChanged();
+        return;
+    }
+    m_idFilterText = text;
+    m_idFilterError.clear();
+    saveBusSelection();
+    emit idFilterChanged();
+}
+
+void LoggerBackend::setRecordFormat(const QString& format)
+{
+    const QString f = format.trimmed().toLower();
+    if (f != QLatin1String("csv") && f != QLatin1String("binary")) {
+        qWarning() << "LoggerBackend: unknown record format" << format;
+        return;
+    }
+    if (m_recordFormat == f) return;
+    m_recordFormat = f;
+    saveBusSelection();
+    emit recordFormatChanged();
+}
+
+void LoggerBackend::setCompressRecordings(bool v)
+{
+    if (m_compressRecordings == v) return;
+    m_compressRecordings = v;
+    saveBusSelection();
+    emit compressRecordingsChanged();
+}
+
 void LoggerBackend::onCanBatch(const can_stream::CanBatch& batch)
 {
-    if (!m_recording || m_paused || !m_logFile || !m_logFile->isOpen()) return;
-    QTextStream out(m_logFile);
+    if (!m_recording) {
+        // Nothing goes to disk: keep the events as pre-trigger history instead
+        if (m_preTrigger.isEnabled()) {
+            for (int i = 0; i < batch.events_size(); ++i)
+                m_preTrigger.push(batch.events(i));
+        }
+        return;
+    }
+    if (m_paused || !m_writer || !m_writer->isRunning()) return;
+
+    // Encode here, write on the writer thread; the GUI thread never touches the disk
+    m_batchBuffer.resize(0);
+    m_batchSpan.clear();
+    int events = 0;
+    if (m_fileBinary) {
+        // Records are fixed-size, so no formatting per event
+        m_batchBuffer.reserve(static_cast<qsizetype>(batch.events_size()) * CanLog::kRecordBytes);
+        for (int i = 0; i < batch.events_size(); ++i) {
+            const can_stream::CanEvent& e = batch.events(i);
+            if (!shouldLogBusId(static_cast<quint32>(e.bus_id()))
+                || !m_idFilter.accepts(e.bus_id(), e.can_id(), e.is_extended()))
+                continue;
+            CanLog::appendRecord(m_batchBuffer, e);
+            m_batchSpan.add(e.can_id(), e.is_extended(), e.ts_ns());
+            ++events;
+        }
+        m_writer->submit(m_batchBuffer, events, &m_batchSpan);
+        return;
+    }
+
     for (int i = 0; i < batch.events_size(); ++i) {
         const can_stream::CanEvent& e = batch.events(i);
-        if (!shouldLogBusId(static_cast<quint32>(e.bus_id())))
+        if (!shouldLogBusId(static_cast<quint32>(e.bus_id()))
+            || !m_idFilter.accepts(e.bus_id(), e.can_id(), e.is_extended()))
             continue;
-        out << e.bus_id() << ","
-            << e.can_id() << ","
-            << (e.is_extended() ? "1" : "0") << ","
-            << (e.is_rtr() ? "1" : "0") << ","
-            << e.ts_ns() << ","
-            << e.dlc() << ","
-            << dataToHex(e.data()) << "\n";
+        CanLog::appendCsvLine(m_batchBuffer, e);
+        m_batchSpan.add(e.can_id(), e.is_extended(), e.ts_ns());
+        ++events;
     }
-    m_logFile->flush();
+    m_writer->submit(m_batchBuffer, events, &m_batchSpan);
 }
 
-void LoggerBackend::refreshLogList()
+void LoggerBackend::setRecordAllStreams(bool v)
 {
-    const QString dirPath = resolveLogsDir();
-    QDir dir(dirPath);
-    if (!dir.exists()) {
-        qDebug() << "LoggerBackend: logs dir does not exist:" << dirPath;
-        if (!m_logFileNames.isEmpty()) {
-            m_logFileNames.clear();
-            emit logFileNamesChanged();
+    if (m_recordAllStreams == v) return;
+    m_recordAllStreams = v;
+    saveBusSelection();
+    emit recordAllStreamsChanged();
+}
+
+void LoggerBackend::setPreTriggerSeconds(int seconds)
+{
+    seconds = qBound(0, seconds, 600);
+    if (m_preTriggerSeconds == seconds) return;
+    m_preTriggerSeconds = seconds;
+    saveBusSelection();
+    configurePreTrigger();
+    emit preTriggerSecondsChanged();
+}
+
+void LoggerBackend::configurePreTrigger()
+{
+    QSettings s(QStringLiteral("OSU"), QStringLiteral("HMI_Mk1"));
+    s.beginGroup(kLoggerGroup);
+    const qint64 maxBytes = s.value("preTriggerMaxMB", 16).toLongLong() * 1024 * 1024;
+    s.endGroup();
+    m_preTrigger.configure(m_preTriggerSeconds > 0 ? maxBytes : 0);
+}
+
+void LoggerBackend::flushPreTrigger()
+{
+    if (!m_preTrigger.isEnabled() || m_preTrigger.count() == 0) return;
+
+    // Only the configured window before the newest event; older slots are left over from a quiet bus
+    const quint64 windowNs = static_cast<quint64>(m_preTriggerSeconds) * 1000000000ULL;
+    const quint64 newest = m_preTrigger.newestTsNs();
+    const quint64 fromNs = newest > windowNs ? newest - windowNs : 0;
+    constexpr int kChunkEvents = 4096;   // keeps index chunks and submits batch-sized
+
+    CanLog::Record r;
+    int events = 0;
+    qint64 total = 0;
+    m_batchBuffer.resize(0);
+    m_batchSpan.clear();
+    for (qint64 i = 0; i < m_preTrigger.count(); ++i) {
+        const uchar* p = m_preTrigger.record(i);
+        CanLog::decodeRecord(p, r);
+        const bool extended = r.flags & CanLog::kFlagExtended;
+        if (r.tsNs < fromNs || !shouldLogBusId(r.busId) || !m_idFilter.accepts(r.busId, r.canId, extended))
+            continue;
+        if (m_fileBinary) {
+            m_batchBuffer.append(reinterpret_cast<const char*>(p), CanLog::kRecordBytes);
+        } else {
+            m_preTriggerEvent.set_bus_id(r.busId);
+            m_preTriggerEvent.set_can_id(r.canId);
+            m_preTriggerEvent.set_is_extended(extended);
+            m_preTriggerEvent.set_is_rtr(r.flags & CanLog::kFlagRtr);
+            m_preTriggerEvent.set_ts_ns(r.tsNs);
+            m_preTriggerEvent.set_dlc(r.dlc);
+            m_preTriggerEvent.set_data(reinterpret_cast<const char*>(r.data), qMin<quint8>(r.dlc, 8));
+            CanLog::appendCsvLine(m_batchBuffer, m_preTriggerEvent);
+        }
+        m_batchSpan.add(r.canId, extended, r.tsNs);
+        if (++events == kChunkEvents) {
+            m_writer->submit(m_batchBuffer, events, &m_batchSpan);
+            total += events;
+            events = 0;
+            m_batchBuffer.resize(0);
+            m_batchSpan.clear();
         }
-        return;
     }
+    if (events > 0)
+        m_writer->submit(m_batchBuffer, events, &m_batchSpan);
+    total += events;
+    qInfo() << "LoggerBackend: wrote" << total << "pre-trigger events";
+    m_preTrigger.clear();
+}
+
+bool LoggerBackend::browseLog(const QString& fileName)
+{
+    return m_browser.open(QDir(resolveLogsDir()).absoluteFilePath(QFileInfo(fileName).fileName()));
+}
 
-    QStringList entries = dir.entryList(QStringList() << "*.csv", QDir::Files, QDir::Name);
-    qDebug() << "LoggerBackend: resolved dir" << dirPath << "found" << entries.size() << "csv files";
-    // Sort descending so most recent first (MM-DD-YYYY_HH-MM-SS.csv sorts lexicographically = chronological)
-    std::sort(entries.begin(), entries.end(), std::greater<QString>());
+int LoggerBackend::queryLog(const QString& fileName, qint64 fromNs, qint64 toNs,
+                            const QVariantList& canIds, int maxEvents)
+{
+    const int requestId = ++m_lastQueryId;
+    const QString path = QDir(resolveLogsDir()).absoluteFilePath(QFileInfo(fileName).fileName());
+    CanLogIndex::Query q;
+    q.fromNs = static_cast<quint64>(qMax<qint64>(0, fromNs));
+    q.toNs = toNs < 0 ? ~quint64(0) : static_cast<quint64>(toNs);
+    for (const QVariant& id : canIds)
+        q.canIds.insert(id.toUInt());
+
+    // Runs on the query thread; `this` is only the target of the queued result
+    QMetaObject::invokeMethod(m_queryWorker, [this, requestId, path, q, maxEvents]() {
+        QVariantList out;
+        QString error;
+        const bool ok = CanLogIndex::query(path, q, [this, &out, maxEvents](const CanLog::Record& r) {
+            QVariantMap m;
+            m["busId"] = r.busId;
+            m["canId"] = r.canId;
+            m["extended"] = (r.flags & CanLog::kFlagExtended) != 0;
+            m["rtr"] = (r.flags & CanLog::kFlagRtr) != 0;
+            m["tsNs"] = static_cast<qint64>(r.tsNs);
+            m["dlc"] = r.dlc;
+            m["dataHex"] = QString::fromLatin1(QByteArray(reinterpret_cast<const char*>(r.data), qMin<int>(r.dlc, 8)).toHex(' '));
+            out.append(m);
+            return out.size() < maxEvents && !m_queryAbort.load(std::memory_order_relaxed);
+        }, &error);
+        if (!ok)
+            qWarning() << "LoggerBackend: cannot query" << path << error;
+        QMetaObject::invokeMethod(this, [this, requestId, out, error]() { emit logQueryFinished(requestId, out, error); },
+                                  Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+    return requestId;
+}
 
-    if (entries != m_logFileNames) {
-        m_logFileNames = entries;
-        emit logFileNamesChanged();
+void LoggerBackend::refreshLogList()
+{
+    // The index follows the directory by itself; this only covers changes the watcher cannot see
+    m_logIndex->rescan();
+}
+
+void LoggerBackend::readLogMetadata(const QString& path, LogDirectoryIndex::Entry& entry)
+{
+    // Runs on the index thread. Every finished segment has its .idx sidecar (written before the
+    // rename), which has the totals without reading the recording.
+    quint64 events = 0, minTsNs = 0, maxTsNs = 0;
+    if (CanLogIndex::summarize(path + "." + CanLogIndex::fileSuffix(), events, minTsNs, maxTsNs)) {
+        entry.events = static_cast<qint64>(events);
+        entry.durationMs = static_cast<qint64>((maxTsNs - minTsNs) / 1000000);
+        return;
     }
+    // Recovered .canb segment without a sidecar: fixed-size records are counted, not read
+    if (!path.endsWith("." + CanLog::fileSuffix())) return;
+    CanLogReader reader;
+    if (!reader.open(path)) return;
+    entry.events = reader.count();
+    CanLog::Record first, last;
+    if (reader.count() > 0 && reader.record(0, first) && reader.record(reader.count() - 1, last) && last.tsNs >= first.tsNs)
+        entry.durationMs = static_cast<qint64>((last.tsNs - first.tsNs) / 1000000);
 }
@@ -2,14 +2,27 @@
 
 #include <QObject>
 #include <QStringList>
+#include <QThread>
+#include <QTimer>
+#include <QVariant>
+#include <atomic>
+#include <memory>
+#include "CanIdFilter.h"
+#include "CanLogBrowserModel.h"
+#include "CanLogWriter.h"
+#include "CanPreTriggerRing.h"
+#include "LogDirectoryIndex.h"
 #include "../proto/HMI_RX_CAN.pb.h"
 
-class QFile;
+class LogStorageBackend;
 
 class LoggerBackend : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(QStringList logFileNames READ logFileNames NOTIFY logFileNamesChanged)
+    // Saved recordings with size, duration, event count and backed-up flag (LogDirectoryIndex roles),
+    // newest first; kept up to date in the background.
+    Q_PROPERTY(QObject* logFiles READ logFiles CONSTANT)
     Q_PROPERTY(bool isRecording READ isRecording NOTIFY isRecordingChanged)
     Q_PROPERTY(bool isPaused READ isPaused NOTIFY isPausedChanged)
     // Bus filter: bus_id 0=HS, 1=CE, 2=SC, 3=LS; when set, only those buses are logged
@@ -17,12 +30,40 @@ class LoggerBackend : public QObject
     Q_PROPERTY(bool canCE READ canCE WRITE setCanCE NOTIFY canCEChanged)
     Q_PROPERTY(bool canSC READ canSC WRITE setCanSC NOTIFY canSCChanged)
     Q_PROPERTY(bool canLS READ canLS WRITE setCanLS NOTIFY canLSChanged)
+    // CAN-ID filter expression applied on top of the bus toggles (syntax in CanIdFilter.h); an
+    // invalid expression is rejected and reported in idFilterError.
+    Q_PROPERTY(QString idFilter READ idFilter WRITE setIdFilter NOTIFY idFilterChanged)
+    Q_PROPERTY(QString idFilterError READ idFilterError NOTIFY idFilterChanged)
+    // Recording file format: "csv" (text, one line per event) or "binary" (.canb, see CanLogFormat.h).
+    // Applies to the next recording.
+    Q_PROPERTY(QString recordFormat READ recordFormat WRITE setRecordFormat NOTIFY recordFormatChanged)
+    // Background writer health while recording: bytes waiting for the disk, and events dropped
+    // because the queue was full (the disk could not keep up).
+    Q_PROPERTY(qint64 writerQueuedBytes READ writerQueuedBytes NOTIFY writerStatsChanged)
+    Q_PROPERTY(qint64 writerDroppedEvents READ writerDroppedEvents NOTIFY writerStatsChanged)
+    // Block-compress recordings (*.csv.hbz / *.canb.hbz, see LogBlockFile.h); applies to the next one.
+    Q_PROPERTY(bool compressRecordings READ compressRecordings WRITE setCompressRecordings NOTIFY compressRecordingsChanged)
+    // Current recording: raw/compressed size (0 when not compressing) and deflate throughput in MB/s.
+    Q_PROPERTY(double compressionRatio READ compressionRatio NOTIFY writerStatsChanged)
+    Q_PROPERTY(double compressionMBps READ compressionMBps NOTIFY writerStatsChanged)
+    // Seconds of CAN history kept while not recording and written at the start of the next
+    // recording; 0 disables. Memory is fixed by the QSettings key logger/preTriggerMaxMB (16).
+    Q_PROPERTY(int preTriggerSeconds READ preTriggerSeconds WRITE setPreTriggerSeconds NOTIFY preTriggerSecondsChanged)
+    // Also record every RX stream (Navigation, Camera, Controls, CAN, Perception) into
+    // "<session>.hmises" next to the CAN segments (SessionContainer.h); applies to the next recording.
+    Q_PROPERTY(bool recordAllStreams READ recordAllStreams WRITE setRecordAllStreams NOTIFY recordAllStreamsChanged)
+    // Recording opened for inspection with browseLog()
+    Q_PROPERTY(QObject* browser READ browser CONSTANT)
 
 public:
     explicit LoggerBackend(QObject* parent = nullptr);
+    ~LoggerBackend() override;
 
-    QStringList logFileNames() const { return m_logFileNames; }
+    QStringList logFileNames() const { return m_logIndex->fileNames(); }
+    QObject* logFiles() { return m_logIndex; }
     bool isRecording() const { return m_recording; }
+    // Name prefix of every file of the recording in progress, or of one still being closed; empty otherwise
+    QString activeSessionName() const { return m_sessionName; }
     bool isPaused() const { return m_paused; }
     bool canHS() const { return m_canHS; }
     void setCanHS(bool v);
@@ -32,44 +73,134 @@ public:
     void setCanSC(bool v);
     bool canLS() const { return m_canLS; }
     void setCanLS(bool v);
+    QString idFilter() const { return m_idFilterText; }
+    void setIdFilter(const QString& expression);
+    QString idFilterError() const { return m_idFilterError; }
+    QString recordFormat() const { return m_recordFormat; }
+    void setRecordFormat(const QString& format);
+    qint64 writerQueuedBytes() const;
+    qint64 writerDroppedEvents() const;
+    bool compressRecordings() const { return m_compressRecordings; }
+    void setCompressRecordings(bool v);
+    double compressionRatio() const;
+    double compressionMBps() const;
+    bool recordAllStreams() const { return m_recordAllStreams; }
+    void setRecordAllStreams(bool v);
+    int preTriggerSeconds() const { return m_preTriggerSeconds; }
+    void setPreTriggerSeconds(int seconds);
+    QObject* browser() { return &m_browser; }
+    // Quota / free-space bookkeeping for the CAN directory; recordings are refused, or saved early,
+    // when it reports the disk full.
+    void setStorageBackend(LogStorageBackend* storage);
 
     Q_INVOKABLE QString logsRootPath() const;
+    // Asks the directory index to rescan; the list updates asynchronously.
     Q_INVOKABLE void refreshLogList();
     Q_INVOKABLE void startRecording();
     Q_INVOKABLE void pauseRecording();
     Q_INVOKABLE void resumeRecording();
     Q_INVOKABLE void discardRecording();
     Q_INVOKABLE void saveRecording();
+    // Opens recording `fileName` (a name from logFileNames) in the browser model.
+    Q_INVOKABLE bool browseLog(const QString& fileName);
+    // Events of recording `fileName` (a name from logFileNames) with ts_ns in [fromNs, toNs] and,
+    // if `canIds` is non-empty, one of those IDs; at most `maxEvents`, as maps with busId, canId,
+    // extended, rtr, tsNs, dlc and dataHex. Seeks through the .idx sidecar when there is one, and
+    // scans the whole file otherwise, so it runs on a background thread: returns a request id at
+    // once and delivers the events through logQueryFinished().
+    Q_INVOKABLE int queryLog(const QString& fileName, qint64 fromNs, qint64 toNs,
+                             const QVariantList& canIds = QVariantList(), int maxEvents = 10000);
 
 public slots:
     void onCanBatch(const can_stream::CanBatch& batch);
+    // GlobalReceiver::sessionStarted / sessionFailed / sessionFinished for the session container
+    void onSessionContainerStarted(const QString& path);
+    void onSessionContainerFailed(const QString& path, const QString& error);
+    void onSessionContainerProgress(const QString& path, qint64 bytes);
+    void onSessionContainerFinished(const QString& path, bool ok);
 
 signals:
     void logFileNamesChanged();
     void isRecordingChanged();
+    // Every file of the saved recording is complete, its session container included
     void recordingSaved();
     void isPausedChanged();
     void canHSChanged();
     void canCEChanged();
     void canSCChanged();
     void canLSChanged();
+    void idFilterChanged();
+    void recordFormatChanged();
+    void writerStatsChanged();
+    void compressRecordingsChanged();
+    void preTriggerSecondsChanged();
+    void recordAllStreamsChanged();
+    // Session container to open / close alongside the CAN recording (wired to NavigationBackend).
+    // Closing is asynchronous and reported through onSessionContainerFinished(); `discard` deletes it.
+    void allStreamsRecordingStarted(const QString& path);
+    void allStreamsRecordingStopped(bool discard);
+    // A recording segment was finalised (synced and renamed) and can be uploaded.
+    void segmentClosed(const QString& path);
+    // Result of queryLog() `requestId`; `error` is empty unless the file could not be read.
+    void logQueryFinished(int requestId, const QVariantList& events, const QString& error);
 
 private:
     void loadBusSelection();
     void saveBusSelection() const;
     bool shouldLogBusId(quint32 busId) const;
     QString resolveLogsDir() const;
-    QString currentRecordingPath() const;
-    void closeAndRemoveCurrentFile();
-    static QString dataToHex(const std::string& data);
+    // Recording sessions: segments "<session>_NNN.<ext>" plus a "<session>.session.json" manifest
+    QString manifestPath() const;
+    void writeManifest(const QString& state) const;
+    void onSegmentClosed(const QString& session, const CanLogWriter::Segment& segment);
+    void onWriterFinished(const QString& session, const QVector<CanLogWriter::Segment>& segments);
+    void recoverInterruptedSessions();
+    void removeSessionFiles();
+    void reportSessionFiles() const;   // to the storage backend, once the session is closed
+    void stopWriter(bool discard = false);
+    void configurePreTrigger();
+    void flushPreTrigger();
+    void updateStorageUsage();
+    void onSpaceCritical();
+    static void readLogMetadata(const QString& path, LogDirectoryIndex::Entry& entry);
+    bool binaryRecording() const { return m_recordFormat == QLatin1String("binary"); }
 
-    QStringList m_logFileNames;
+    LogStorageBackend* m_storage = nullptr;
+    LogDirectoryIndex* m_logIndex = nullptr;
     bool m_recording = false;
     bool m_paused = false;
-    QFile* m_logFile = nullptr;
-    QString m_currentLogPath;
+    std::unique_ptr<CanLogWriter> m_writer;   // owns the open recording file and its thread
+    QTimer m_writerStatsTimer;
+    bool m_writerClosing = false;    // stopped; the session is finished in onWriterFinished()
+    bool m_discardOnClose = false;   // ...by deleting its files
+    bool m_startPending = false;     // startRecording() while the previous session was closing
+    QString m_sessionName;       // empty when not recording and no session is closing
+    QString m_sessionDir;
+    QString m_sessionSuffix;     // ".csv", ".canb", plus ".hbz" when compressed
+    QVector<CanLogWriter::Segment> m_segments;   // finalised segments of the session
     bool m_canHS = true;
     bool m_canCE = true;
     bool m_canSC = true;
     bool m_canLS = true;
+    QString m_idFilterText;
+    QString m_idFilterError;
+    CanIdFilter m_idFilter;
+    QString m_recordFormat = QStringLiteral("csv");
+    bool m_compressRecordings = false;
+    bool m_recordAllStreams = false;
+    QString m_containerRequest;  // session container requested for the current recording
+    QString m_containerPath;     // ...once GlobalReceiver has opened it; listed in the manifest
+    QString m_closingContainer;  // container of the saved recording, until its writer has finished
+    qint64 m_containerBytes = 0; // size of the open container (sessionProgress)
+    bool m_fileBinary = false;   // format of the file currently open (fixed at startRecording)
+    QByteArray m_batchBuffer;    // encoded events of one batch, reused
+    CanLogIndex::Span m_batchSpan;
+    CanLogBrowserModel m_browser;
+    QThread m_queryThread;
+    QObject* m_queryWorker = nullptr;         // lives on m_queryThread; context of queryLog() jobs
+    std::atomic<bool> m_queryAbort{false};    // set at shutdown so a running scan stops early
+    int m_lastQueryId = 0;
+    int m_preTriggerSeconds = 10;
+    CanPreTriggerRing m_preTrigger;
+    can_stream::CanEvent m_preTriggerEvent;   // decode scratch for CSV output, reused
 };
@@ -1,5 +1,7 @@
 #include "NavigationBackend.h"
 #include "GlobalReceiver.h"
+#include "RxMetrics.h"
+#include "RxConflator.h"
 
 // Qt Positioning header (install Qt Positioning if missing)
 #include <QGeoCoordinate>
@@ -8,10 +10,23 @@
 NavigationBackend::NavigationBackend(QObject* parent)
     : QObject(parent)
 {
-    m_rx = new GlobalReceiver(this);
-    // Listeners started via applyRxPorts() from SettingsBackend::applyNetworkSettings()
-
-    connect(m_rx, &GlobalReceiver::controlsMessage,
+    // Receiver runs on its own event loop so socket reads and ParseFromArray never block QML rendering.
+    // No parent: moveToThread() requires it; deleted on the RX thread when it finishes.
+    m_rx = new GlobalReceiver();
+    m_rx->moveToThread(&m_rxThread);
+    connect(&m_rxThread, &QThread::finished, m_rx, &QObject::deleteLater);
+    m_rxThread.setObjectName(QStringLiteral("HMI-RX"));
+    m_rxThread.start();
+    // Listeners started via applyRxEndpoints() from SettingsBackend::applyNetworkSettings()
+
+    m_rxMetrics = new RxMetrics(this);
+    connect(m_rx, &GlobalReceiver::metricsUpdated,
+            m_rxMetrics, &RxMetrics::onMetricsUpdated);
+
+    // Navigation goes through the conflator so a lagging GUI can skip straight to the newest pose
+    m_conflator = new RxConflator(this);
+    m_conflator->attach(m_rx);
+    connect(m_conflator, &RxConflator::controlsMessage,
             this, &NavigationBackend::onControlsMessage);
     connect(m_rx, &GlobalReceiver::controlsStateReceived,
             this, &NavigationBackend::onControlsState);
@@ -44,6 +59,13 @@ NavigationBackend::NavigationBackend(QObject* parent)
             this, &NavigationBackend::onControlsStackTimeout);
 }
 
+NavigationBackend::~NavigationBackend()
+{
+    m_rxThread.quit();
+    m_rxThread.wait();
+    m_rx = nullptr;
+}
+
 namespace {
 QString maneuverTypeFromInstruction(const std::string& raw)
 {
@@ -165,13 +187,89 @@ void NavigationBackend::onControlsMessage(const vehicle_msgs::Navigation& msg)
     emit waypointsUpdated();
 }
 
-void NavigationBackend::applyRxPorts(int controlsPort, int perceptionPort, int loggerPort)
+void NavigationBackend::applyRxEndpoints(const RxEndpoints& ep)
 {
-    if (m_rx) {
-        m_rx->listenControls(static_cast<quint16>(controlsPort));
-        m_rx->listenPerception(static_cast<quint16>(perceptionPort));
-        m_rx->listenLogger(static_cast<quint16>(loggerPort));
-    }
+    if (!m_rx) return;
+    // Servers, sockets and rings must be created on the receiver's thread
+    GlobalReceiver* rx = m_rx;
+    QMetaObject::invokeMethod(rx, [rx, ep]() {
+        const auto controlsPort = static_cast<quint16>(ep.controlsPort);
+        const auto perceptionPort = static_cast<quint16>(ep.perceptionPort);
+        if (ep.controlsTransport == QLatin1String("udp"))
+            rx->listenControlsUdp(controlsPort, ep.multicastGroup);
+        else if (ep.controlsTransport == QLatin1String("shm"))
+            rx->listenControlsShm(ep.controlsShm);
+        else
+            rx->listenControls(controlsPort);
+
+        if (ep.perceptionTransport == QLatin1String("udp"))
+            rx->listenPerceptionUdp(perceptionPort, ep.multicastGroup);
+        else if (ep.perceptionTransport == QLatin1String("shm"))
+            rx->listenPerceptionShm(ep.perceptionShm);
+        else
+            rx->listenPerception(perceptionPort);
+
+        if (ep.loggerTransport == QLatin1String("shm"))
+            rx->listenLoggerShm(ep.loggerShm);
+        else
+            rx->listenLogger(static_cast<quint16>(ep.loggerPort));
+    }, Qt::QueuedConnection);
+}
+
+void NavigationBackend::startRxCapture(const QString& path)
+{
+    if (!m_rx) return;
+    GlobalReceiver* rx = m_rx;
+    QMetaObject::invokeMethod(rx, [rx, path]() { rx->startCapture(path); }, Qt::QueuedConnection);
+}
+
+void NavigationBackend::stopRxCapture()
+{
+    if (!m_rx) return;
+    GlobalReceiver* rx = m_rx;
+    QMetaObject::invokeMethod(rx, [rx]() { rx->stopCapture(); }, Qt::QueuedConnection);
+}
+
+void NavigationBackend::startRxReplay(const QString& path, double speed, bool loop)
+{
+    if (!m_rx) return;
+    GlobalReceiver* rx = m_rx;
+    QMetaObject::invokeMethod(rx, [rx, path, speed, loop]() { rx->startReplay(path, speed, loop); },
+                              Qt::QueuedConnection);
+}
+
+void NavigationBackend::stopRxReplay()
+{
+    if (!m_rx) return;
+    GlobalReceiver* rx = m_rx;
+    QMetaObject::invokeMethod(rx, [rx]() { rx->stopReplay(); }, Qt::QueuedConnection);
+}
+
+void NavigationBackend::startSessionRecording(const QString& path)
+{
+    if (!m_rx) return;
+    GlobalReceiver* rx = m_rx;
+    QMetaObject::invokeMethod(rx, [rx, path]() { rx->startSession(path); }, Qt::QueuedConnection);
+}
+
+void NavigationBackend::stopSessionRecording(bool discard)
+{
+    if (!m_rx) return;
+    GlobalReceiver* rx = m_rx;
+    QMetaObject::invokeMethod(rx, [rx, discard]() { rx->stopSession(discard); }, Qt::QueuedConnection);
+}
+
+void NavigationBackend::applyRxStreamLimits(int kind, int maxFrameBytes, qint64 maxBufferedBytes)
+{
+    if (!m_rx) return;
+    GlobalReceiver* rx = m_rx;
+    GlobalReceiver::StreamLimits limits;
+    limits.maxFrameBytes = maxFrameBytes;
+    limits.maxBufferedBytes = maxBufferedBytes;
+    const auto streamKind = static_cast<GlobalReceiver::StreamKind>(kind);
+    QMetaObject::invokeMethod(rx, [rx, streamKind, limits]() {
+        rx->setStreamLimits(streamKind, limits);
+    }, Qt::QueuedConnection);
 }
 
 void NavigationBackend::onCanLoggerActiveChanged(bool active)
@@ -6,10 +6,13 @@
 #include <QVariant>
 #include <QString>
 #include <QTimer>
+#include <QThread>
 
 #include "HMI_RX_CONTROLS.pb.h"   // Navigation
 
 class GlobalReceiver;
+class RxMetrics;
+class RxConflator;
 
 class NavigationBackend : public QObject {
     Q_OBJECT
@@ -37,6 +40,7 @@ class NavigationBackend : public QObject {
 
 public:
     explicit NavigationBackend(QObject* parent = nullptr);
+    ~NavigationBackend() override;
 
     double currentLat() const { return m_currentLat; }
     double currentLon() const { return m_currentLon; }
@@ -62,9 +66,40 @@ public:
 
     Q_INVOKABLE QVariantList waypointPath() const;
 
-    // So that main can connect canBatchReceived and settings can apply RX ports
+    // So that main can connect canBatchReceived and settings can apply RX ports.
+    // The receiver lives on m_rxThread: connect with AutoConnection (queued) and never call it directly.
     GlobalReceiver* globalReceiver() const { return m_rx; }
-    void applyRxPorts(int controlsPort, int perceptionPort, int loggerPort);
+    // GUI-thread view of the receiver's ingest telemetry (exposed to QML as RxMetrics)
+    RxMetrics* rxMetrics() const { return m_rxMetrics; }
+    // Navigation / Perception delivery path (optional latest-value conflation); connect consumers here
+    RxConflator* rxConflator() const { return m_conflator; }
+    // RX listener setup. Transport per stream: "tcp", "udp" (Controls / Perception only) or "shm"
+    // (same-host shared-memory ring named by the *Shm field).
+    struct RxEndpoints {
+        int controlsPort = 5001;
+        int perceptionPort = 6002;
+        int loggerPort = 6003;
+        QString controlsTransport = QStringLiteral("tcp");
+        QString perceptionTransport = QStringLiteral("tcp");
+        QString loggerTransport = QStringLiteral("tcp");
+        QString multicastGroup;   // UDP streams; empty means unicast
+        QString controlsShm;
+        QString perceptionShm;
+        QString loggerShm;
+    };
+    void applyRxEndpoints(const RxEndpoints& ep);
+    // Raw RX capture / replay (GlobalReceiver::startCapture / startReplay), run on the RX thread.
+    // speed <= 0 replays as fast as possible.
+    Q_INVOKABLE void startRxCapture(const QString& path);
+    Q_INVOKABLE void stopRxCapture();
+    Q_INVOKABLE void startRxReplay(const QString& path, double speed = 1.0, bool loop = false);
+    Q_INVOKABLE void stopRxReplay();
+    // All-stream session container (GlobalReceiver::startSession). Stopping returns at once; the
+    // file is complete when GlobalReceiver::sessionFinished() arrives. `discard` deletes it instead.
+    Q_INVOKABLE void startSessionRecording(const QString& path);
+    Q_INVOKABLE void stopSessionRecording(bool discard = false);
+    // Per-stream frame/buffer caps (GlobalReceiver::setStreamLimits), applied on the RX thread
+    void applyRxStreamLimits(int kind, int maxFrameBytes, qint64 maxBufferedBytes);
 
 signals:
     void updated();
@@ -97,6 +132,9 @@ private:
     void setAutoOn(bool v) { if (m_autoOn==v) return; m_autoOn=v; emit autoOnChanged(); }
 
     GlobalReceiver* m_rx = nullptr;
+    QThread m_rxThread;  // ingest thread: sockets, deframing and protobuf parsing
+    RxMetrics* m_rxMetrics = nullptr;
+    RxConflator* m_conflator = nullptr;
 
     double m_currentLat = 0.0;
     double m_currentLon = 0.0;
@@ -0,0 +1,129 @@
+#include "RxCapture.h"
+#include <QtEndian>
+#include <cstring>
+#include <limits>
+
+namespace {
+constexpr char kMagic[8] = { 'H', 'M', 'I', 'R', 'X', 'C', 'A', 'P' };
+constexpr qint64 kFileHeaderBytes = 16;
+constexpr qint64 kRecordHeaderBytes = 16;
+}
+
+// ---- RxCaptureWriter ----
+
+bool RxCaptureWriter::open(const QString& path)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    uchar header[kFileHeaderBytes] = {};
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    qToLittleEndian<quint32>(kVersion, header + 8);
+    m_stage.reserve(kStageBytes + 64 * 1024);
+    m_stage.append(reinterpret_cast<const char*>(header), kFileHeaderBytes);
+    m_records = 0;
+    return true;
+}
+
+void RxCaptureWriter::close()
+{
+    if (!m_file.isOpen()) return;
+    flush();
+    m_file.close();
+}
+
+void RxCaptureWriter::append(qint64 tNs, quint8 kind, quint16 port, const char* payload, int size)
+{
+    if (!m_file.isOpen() || size < 0) return;
+
+    uchar rec[kRecordHeaderBytes] = {};
+    qToLittleEndian<quint64>(static_cast<quint64>(tNs), rec);
+    rec[8] = kind;
+    qToLittleEndian<quint16>(port, rec + 10);
+    qToLittleEndian<quint32>(static_cast<quint32>(size), rec + 12);
+    m_stage.append(reinterpret_cast<const char*>(rec), kRecordHeaderBytes);
+    m_stage.append(payload, size);
+    ++m_records;
+
+    if (m_stage.size() >= kStageBytes)
+        flush();
+}
+
+void RxCaptureWriter::flush()
+{
+    if (!m_file.isOpen() || m_stage.isEmpty()) return;
+    m_file.write(m_stage);
+    m_file.flush();
+    m_stage.resize(0);  // keeps capacity
+}
+
+// ---- RxCaptureReader ----
+
+bool RxCaptureReader::open(const QString& path)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_size = m_file.size();
+    if (m_size < kFileHeaderBytes) {
+        m_error = QStringLiteral("not a capture file (too short)");
+        m_file.close();
+        return false;
+    }
+    m_map = m_file.map(0, m_size);
+    if (!m_map) {
+        m_error = m_file.errorString();
+        m_file.close();
+        return false;
+    }
+    if (std::memcmp(m_map, kMagic, sizeof(kMagic)) != 0
+        || qFromLittleEndian<quint32>(m_map + 8) != static_cast<quint32>(RxCaptureWriter::kVersion)) {
+        m_error = QStringLiteral("not a capture file or unsupported version");
+        close();
+        return false;
+    }
+    m_pos = kFileHeaderBytes;
+    m_error.clear();
+    return true;
+}
+
+void RxCaptureReader::close()
+{
+    if (m_map)
+        m_file.unmap(const_cast<uchar*>(m_map));
+    m_map = nullptr;
+    m_size = 0;
+    m_pos = 0;
+    if (m_file.isOpen())
+        m_file.close();
+}
+
+bool RxCaptureReader::next(RxCaptureRecord& rec)
+{
+    if (!m_map || m_size - m_pos < kRecordHeaderBytes)
+        return false;
+    const uchar* p = m_map + m_pos;
+    const quint32 len = qFromLittleEndian<quint32>(p + 12);
+    if (len > static_cast<quint32>(std::numeric_limits<int>::max()))
+        return false;
+    if (static_cast<quint64>(m_size - m_pos - kRecordHeaderBytes) < len)
+        return false; // capture cut off mid-record
+    rec.tNs = static_cast<qint64>(qFromLittleEndian<quint64>(p));
+    rec.kind = p[8];
+    rec.port = qFromLittleEndian<quint16>(p + 10);
+    rec.payload = reinterpret_cast<const char*>(p + kRecordHeaderBytes);
+    rec.size = static_cast<int>(len);
+    m_pos += kRecordHeaderBytes + len;
+    return true;
+}
+
+void RxCaptureReader::rewind()
+{
+    if (m_map)
+        m_pos = kFileHeaderBytes;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QtGlobal>
+
+// Raw RX capture file (*.hmicap): every deframed payload GlobalReceiver parsed, with the monotonic
+// time it came off the wire, so field traffic can be replayed deterministically.
+//
+//   header  "HMIRXCAP" | u32 version | u32 reserved                       (16 bytes)
+//   record  u64 tNs | u8 kind | u8 reserved | u16 port | u32 len | payload (16 + len bytes)
+//
+// Integers are little-endian; tNs counts from the start of the capture; kind is
+// GlobalReceiver::StreamKind; the payload is the frame without its length prefix (Controls keeps
+// its type byte), so a record can be handed straight back to the parser.
+struct RxCaptureRecord
+{
+    qint64 tNs = 0;
+    quint8 kind = 0;
+    quint16 port = 0;
+    const char* payload = nullptr;  // view into the reader's mapping
+    int size = 0;
+};
+
+class RxCaptureWriter
+{
+public:
+    static constexpr int kVersion = 1;
+
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString errorString() const { return m_file.errorString(); }
+
+    // Staged in memory and written in large blocks; flush() pushes the stage to the file.
+    void append(qint64 tNs, quint8 kind, quint16 port, const char* payload, int size);
+    void flush();
+
+    quint64 records() const { return m_records; }
+
+private:
+    static constexpr qsizetype kStageBytes = 1024 * 1024;
+    QFile m_file;
+    QByteArray m_stage;
+    quint64 m_records = 0;
+};
+
+// Sequential reader over a memory-mapped capture; records are views into the mapping.
+class RxCaptureReader
+{
+public:
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return m_map != nullptr; }
+    QString errorString() const { return m_error; }
+
+    // False at end of file or on a truncated trailing record.
+    bool next(RxCaptureRecord& rec);
+    void rewind();
+
+private:
+    QFile m_file;
+    const uchar* m_map = nullptr;
+    qint64 m_size = 0;
+    qint64 m_pos = 0;
+    QString m_error;
+};
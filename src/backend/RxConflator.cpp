@@ -0,0 +1,97 @@
+#include "RxConflator.h"
+#include "GlobalReceiver.h"
+
+RxConflator::RxConflator(QObject* parent)
+    : QObject(parent)
+{
+}
+
+void RxConflator::attach(GlobalReceiver* rx)
+{
+    if (!rx) return;
+    connect(rx, &GlobalReceiver::controlsMessage,
+            this, &RxConflator::offerNavigation, Qt::DirectConnection);
+    connect(rx, &GlobalReceiver::perceptionFrameReceived,
+            this, &RxConflator::offerPerception, Qt::DirectConnection);
+}
+
+void RxConflator::setConflateNavigation(bool on)
+{
+    if (m_nav.conflate.exchange(on) == on) return;
+    emit conflationChanged();
+}
+
+void RxConflator::setConflatePerception(bool on)
+{
+    if (m_perception.conflate.exchange(on) == on) return;
+    emit conflationChanged();
+}
+
+template <typename Msg>
+bool RxConflator::store(Slot<Msg>& slot, const Msg& msg)
+{
+    QMutexLocker lock(&slot.mutex);
+    slot.pending.CopyFrom(msg);
+    if (slot.hasPending) {
+        // GUI has not consumed the previous one yet: overwrite it, no second delivery
+        slot.dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    slot.hasPending = true;
+    return true;
+}
+
+template <typename Msg>
+bool RxConflator::take(Slot<Msg>& slot)
+{
+    QMutexLocker lock(&slot.mutex);
+    if (!slot.hasPending)
+        return false;
+    slot.delivering.Swap(&slot.pending);
+    slot.hasPending = false;
+    return true;
+}
+
+void RxConflator::offerNavigation(const vehicle_msgs::Navigation& msg)
+{
+    if (!conflateNavigation()) {
+        QMetaObject::invokeMethod(this, [this, msg]() { emit controlsMessage(msg); }, Qt::QueuedConnection);
+        return;
+    }
+    if (store(m_nav, msg))
+        QMetaObject::invokeMethod(this, &RxConflator::flushNavigation, Qt::QueuedConnection);
+}
+
+void RxConflator::offerPerception(const hmi::perception::v1::PerceptionFrame& frame)
+{
+    if (!conflatePerception()) {
+        QMetaObject::invokeMethod(this, [this, frame]() { emit perceptionFrameReceived(frame); }, Qt::QueuedConnection);
+        return;
+    }
+    if (store(m_perception, frame))
+        QMetaObject::invokeMethod(this, &RxConflator::flushPerception, Qt::QueuedConnection);
+}
+
+void RxConflator::flushNavigation()
+{
+    if (!take(m_nav)) return;
+    emit controlsMessage(m_nav.delivering);
+
+    const quint64 dropped = navigationDropped();
+    if (dropped != m_nav.droppedReported) {
+        m_nav.droppedReported = dropped;
+        emit droppedChanged();
+    }
+}
+
+void RxConflator::flushPerception()
+{
+    if (!take(m_perception)) return;
+    emit perceptionFrameReceived(m_perception.delivering);
+
+    const quint64 dropped = perceptionDropped();
+    if (dropped != m_perception.droppedReported) {
+        m_perception.droppedReported = dropped;
+        emit droppedChanged();
+    }
+}
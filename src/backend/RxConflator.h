@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QObject>
+#include <QMutex>
+#include <atomic>
+
+#include "../proto/HMI_RX_CONTROLS.pb.h"    // Navigation
+#include "../proto/HMI_RX_PERCEPTION.pb.h"  // PerceptionFrame
+
+class GlobalReceiver;
+
+// GUI-thread relay between GlobalReceiver (RX thread) and the Navigation / Perception consumers.
+// Pass-through mode forwards every message as a queued copy, exactly like connecting to the
+// receiver directly. Conflated mode keeps only the newest not-yet-consumed message per stream:
+// while the GUI thread is behind, newer messages overwrite the pending one (counted as dropped)
+// and at most one delivery per stream is queued, so the UI is never more than one frame stale.
+class RxConflator : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool conflateNavigation READ conflateNavigation WRITE setConflateNavigation NOTIFY conflationChanged)
+    Q_PROPERTY(bool conflatePerception READ conflatePerception WRITE setConflatePerception NOTIFY conflationChanged)
+    Q_PROPERTY(quint64 navigationDropped READ navigationDropped NOTIFY droppedChanged)
+    Q_PROPERTY(quint64 perceptionDropped READ perceptionDropped NOTIFY droppedChanged)
+
+public:
+    explicit RxConflator(QObject* parent = nullptr);
+
+    // Subscribe to the receiver's Navigation / Perception signals (direct: offer*() run on the RX thread)
+    void attach(GlobalReceiver* rx);
+
+    bool conflateNavigation() const { return m_nav.conflate.load(std::memory_order_relaxed); }
+    void setConflateNavigation(bool on);
+    bool conflatePerception() const { return m_perception.conflate.load(std::memory_order_relaxed); }
+    void setConflatePerception(bool on);
+
+    quint64 navigationDropped() const { return m_nav.dropped.load(std::memory_order_relaxed); }
+    quint64 perceptionDropped() const { return m_perception.dropped.load(std::memory_order_relaxed); }
+
+    // Thread-safe; called on the receiver thread
+    void offerNavigation(const vehicle_msgs::Navigation& msg);
+    void offerPerception(const hmi::perception::v1::PerceptionFrame& frame);
+
+signals:
+    // Same signatures as GlobalReceiver; emitted on the GUI thread
+    void controlsMessage(const vehicle_msgs::Navigation& msg);
+    void perceptionFrameReceived(const hmi::perception::v1::PerceptionFrame& frame);
+
+    void conflationChanged();
+    void droppedChanged();
+
+private:
+    // Latest-value slot. `pending` is written by the RX thread under `mutex`; the GUI thread swaps
+    // it into `delivering` (internal pointer swap, no copy) and emits from there. Both messages keep
+    // their capacity, so the steady state copies into warm storage without allocating.
+    template <typename Msg>
+    struct Slot {
+        QMutex mutex;
+        Msg pending;
+        Msg delivering;
+        bool hasPending = false;
+        std::atomic<bool> conflate{false};
+        std::atomic<quint64> dropped{0};
+        quint64 droppedReported = 0;  // GUI thread only
+    };
+
+    template <typename Msg>
+    bool store(Slot<Msg>& slot, const Msg& msg);
+    template <typename Msg>
+    bool take(Slot<Msg>& slot);
+
+    void flushNavigation();
+    void flushPerception();
+
+    Slot<vehicle_msgs::Navigation> m_nav;
+    Slot<hmi::perception::v1::PerceptionFrame> m_perception;
+};
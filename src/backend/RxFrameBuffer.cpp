@@ -0,0 +1,53 @@
+#include "RxFrameBuffer.h"
+#include <cstring>
+
+RxFrameBuffer::RxFrameBuffer(qsizetype initialCapacity)
+{
+    m_data.resize(qMax<qsizetype>(initialCapacity, 16));
+}
+
+char* RxFrameBuffer::prepareWrite(qsizetype n)
+{
+    if (m_data.size() - m_write >= n)
+        return m_data.data() + m_write;
+
+    const qsizetype unread = size();
+    if (unread + n > m_data.size()) {
+        // Grow geometrically so a large frame arriving in small reads costs amortised O(1) per byte
+        qsizetype cap = m_data.size();
+        while (cap < unread + n)
+            cap *= 2;
+        m_data.resize(cap);
+    }
+    // Compact: only the partial (unread) tail moves, never consumed frames
+    if (m_read > 0) {
+        if (unread > 0)
+            std::memmove(m_data.data(), m_data.constData() + m_read, static_cast<size_t>(unread));
+        m_read = 0;
+        m_write = unread;
+    }
+    return m_data.data() + m_write;
+}
+
+void RxFrameBuffer::commitWrite(qsizetype n)
+{
+    Q_ASSERT(n >= 0 && m_write + n <= m_data.size());
+    m_write += n;
+}
+
+void RxFrameBuffer::consume(qsizetype n)
+{
+    Q_ASSERT(n >= 0 && n <= size());
+    m_read += n;
+    if (m_read == m_write) {
+        // Empty: rewind for free so the next read lands at the front without a memmove
+        m_read = 0;
+        m_write = 0;
+    }
+}
+
+void RxFrameBuffer::clear()
+{
+    m_read = 0;
+    m_write = 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QByteArray>
+#include <QtGlobal>
+
+// Per-connection receive buffer for GlobalReceiver: one contiguous block with read/write cursors.
+// Socket data is read straight into the tail (prepareWrite/commitWrite) and complete frames are
+// handed out as pointer+length views into the block, so deframing never copies payloads and never
+// shifts the whole buffer per frame. Unread bytes are moved to the front only when the tail runs
+// out of room, which keeps the total cost linear in bytes received.
+class RxFrameBuffer
+{
+public:
+    explicit RxFrameBuffer(qsizetype initialCapacity = 64 * 1024);
+
+    // Writable region of at least n bytes after the write cursor (compacts or grows as needed).
+    // Invalidates pointers previously returned by data().
+    char* prepareWrite(qsizetype n);
+    void commitWrite(qsizetype n);
+
+    const char* data() const { return m_data.constData() + m_read; }
+    qsizetype size() const { return m_write - m_read; }
+    qsizetype capacity() const { return m_data.size(); }
+
+    // Advance the read cursor; views into already-consumed bytes stay valid until prepareWrite().
+    void consume(qsizetype n);
+    void clear();
+
+private:
+    QByteArray m_data;
+    qsizetype m_read = 0;
+    qsizetype m_write = 0;
+};
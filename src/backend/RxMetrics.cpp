@@ -0,0 +1,135 @@
+#include "RxMetrics.h"
+#include <QtCore/qalgorithms.h>
+#include <cmath>
+
+// ---- RxLatencyHistogram ----
+
+int RxLatencyHistogram::bucketFor(quint64 ns)
+{
+    // Values below 2^kSubBits get exact buckets; above, bucket = octave * 4 + top two mantissa bits
+    if (ns < (1u << kSubBits))
+        return static_cast<int>(ns);
+    const int msb = 63 - static_cast<int>(qCountLeadingZeroBits(ns));
+    const int sub = static_cast<int>((ns >> (msb - kSubBits)) & ((1u << kSubBits) - 1));
+    const int bucket = ((msb - kSubBits + 1) << kSubBits) + sub;
+    return bucket < kBuckets ? bucket : kBuckets - 1;
+}
+
+quint64 RxLatencyHistogram::bucketUpperBound(int bucket)
+{
+    if (bucket < (1 << kSubBits))
+        return static_cast<quint64>(bucket);
+    const int msb = (bucket >> kSubBits) + kSubBits - 1;
+    const quint64 sub = static_cast<quint64>(bucket & ((1 << kSubBits) - 1));
+    const quint64 base = 1ull << msb;
+    const quint64 step = 1ull << (msb - kSubBits);
+    return base + (sub + 1) * step - 1;
+}
+
+void RxLatencyHistogram::record(qint64 ns)
+{
+    ++m_buckets[static_cast<size_t>(bucketFor(ns > 0 ? static_cast<quint64>(ns) : 0))];
+    ++m_count;
+}
+
+qint64 RxLatencyHistogram::percentile(double p) const
+{
+    if (m_count == 0)
+        return 0;
+    const quint64 rank = qMax<quint64>(1, static_cast<quint64>(std::ceil(p * static_cast<double>(m_count))));
+    quint64 seen = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        seen += m_buckets[static_cast<size_t>(i)];
+        if (seen >= rank)
+            return static_cast<qint64>(bucketUpperBound(i));
+    }
+    return static_cast<qint64>(bucketUpperBound(kBuckets - 1));
+}
+
+void RxLatencyHistogram::reset()
+{
+    m_buckets.fill(0);
+    m_count = 0;
+}
+
+// ---- RxStreamMetrics ----
+
+QVariantMap RxStreamMetrics::toVariantMap() const
+{
+    QVariantMap m;
+    m.insert("name", name);
+    m.insert("transport", transport);
+    m.insert("port", port);
+    m.insert("framesPerSec", framesPerSec);
+    m.insert("bytesPerSec", bytesPerSec);
+    m.insert("framesTotal", static_cast<double>(framesTotal));
+    m.insert("bytesTotal", static_cast<double>(bytesTotal));
+    m.insert("parseFailures", static_cast<double>(parseFailures));
+    m.insert("resyncs", static_cast<double>(resyncs));
+    m.insert("bytesDiscarded", static_cast<double>(bytesDiscarded));
+    m.insert("datagramsLate", static_cast<double>(datagramsLate));
+    m.insert("datagramsLost", static_cast<double>(datagramsLost));
+    m.insert("bufferedBytes", static_cast<double>(bufferedBytes));
+    m.insert("parseP50Us", parseP50Us);
+    m.insert("parseP99Us", parseP99Us);
+    m.insert("dispatchP50Us", dispatchP50Us);
+    m.insert("dispatchP99Us", dispatchP99Us);
+    return m;
+}
+
+// ---- RxMetrics ----
+
+RxMetrics::RxMetrics(QObject* parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<RxStreamMetrics>();
+    qRegisterMetaType<QVector<RxStreamMetrics>>();
+}
+
+RxStreamMetrics RxMetrics::stream(quint16 port) const
+{
+    for (const RxStreamMetrics& s : m_streams) {
+        if (s.port == port)
+            return s;
+    }
+    return RxStreamMetrics();
+}
+
+QVariantList RxMetrics::streams() const
+{
+    QVariantList out;
+    out.reserve(m_streams.size());
+    for (const RxStreamMetrics& s : m_streams)
+        out.append(s.toVariantMap());
+    return out;
+}
+
+double RxMetrics::totalFramesPerSec() const
+{
+    double sum = 0.0;
+    for (const RxStreamMetrics& s : m_streams)
+        sum += s.framesPerSec;
+    return sum;
+}
+
+double RxMetrics::totalBytesPerSec() const
+{
+    double sum = 0.0;
+    for (const RxStreamMetrics& s : m_streams)
+        sum += s.bytesPerSec;
+    return sum;
+}
+
+quint64 RxMetrics::totalParseFailures() const
+{
+    quint64 sum = 0;
+    for (const RxStreamMetrics& s : m_streams)
+        sum += s.parseFailures;
+    return sum;
+}
+
+void RxMetrics::onMetricsUpdated(const QVector<RxStreamMetrics>& streams)
+{
+    m_streams = streams;
+    emit updated();
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <QObject>
+#include <QMetaType>
+#include <QString>
+#include <QVariantList>
+#include <QVector>
+#include <array>
+
+// Log-linear latency histogram (4 sub-buckets per power of two, ~19% worst-case resolution).
+// Recording is a couple of bit operations and one increment, cheap enough for every frame.
+class RxLatencyHistogram
+{
+public:
+    void record(qint64 ns);
+    // Upper bound (ns) of the bucket holding the p-quantile (0..1) of recorded samples; 0 if empty.
+    qint64 percentile(double p) const;
+    quint64 count() const { return m_count; }
+    void reset();
+
+private:
+    static constexpr int kSubBits = 2;
+    static constexpr int kBuckets = 64 << kSubBits;
+    static int bucketFor(quint64 ns);
+    static quint64 bucketUpperBound(int bucket);
+
+    std::array<quint32, kBuckets> m_buckets{};
+    quint64 m_count = 0;
+};
+
+// Per-stream counters owned by GlobalReceiver (receiver thread only, no locking).
+struct RxStreamCounters
+{
+    quint16 port = 0;
+    quint64 framesTotal = 0;
+    quint64 bytesTotal = 0;
+    quint64 parseFailures = 0;
+    quint64 resyncs = 0;            // corrupt length prefixes skipped
+    quint64 bytesDiscarded = 0;     // bytes thrown away while resynchronising
+    quint64 datagramsLate = 0;      // UDP: out-of-order / duplicate sequence numbers skipped
+    quint64 datagramsLost = 0;      // UDP sequence gaps, or shm frames the producer dropped on a full ring
+    quint64 framesAtLastSnapshot = 0;
+    quint64 bytesAtLastSnapshot = 0;
+    RxLatencyHistogram parseNs;     // ParseFromArray only
+    RxLatencyHistogram dispatchNs;  // socket read -> signal emitted (buffer wait + parse + emit)
+};
+
+// Snapshot of one RX stream over the last metrics interval; published from the receiver thread.
+struct RxStreamMetrics
+{
+    QString name;                  // "controls", "perception", "logger"
+    QString transport;             // "tcp", "udp", "shm" (port 0) or "replay"
+    quint16 port = 0;
+    double framesPerSec = 0.0;
+    double bytesPerSec = 0.0;
+    quint64 framesTotal = 0;
+    quint64 bytesTotal = 0;
+    quint64 parseFailures = 0;
+    quint64 resyncs = 0;
+    quint64 bytesDiscarded = 0;
+    quint64 datagramsLate = 0;
+    quint64 datagramsLost = 0;
+    qint64 bufferedBytes = 0;      // bytes waiting in connection buffers (partial frames)
+    double parseP50Us = 0.0;
+    double parseP99Us = 0.0;
+    double dispatchP50Us = 0.0;
+    double dispatchP99Us = 0.0;
+
+    QVariantMap toVariantMap() const;
+};
+Q_DECLARE_METATYPE(RxStreamMetrics)
+
+// GUI-side view of GlobalReceiver's ingest telemetry. Receives a snapshot every interval
+// (GlobalReceiver::metricsUpdated, queued) and exposes it to QML and C++.
+class RxMetrics : public QObject
+{
+    Q_OBJECT
+    /// One map per stream: name, transport, port, framesPerSec, bytesPerSec, framesTotal, bytesTotal,
+    /// parseFailures, resyncs, bytesDiscarded, datagramsLate, datagramsLost, bufferedBytes, parseP50Us, parseP99Us, dispatchP50Us, dispatchP99Us
+    Q_PROPERTY(QVariantList streams READ streams NOTIFY updated)
+    Q_PROPERTY(double totalFramesPerSec READ totalFramesPerSec NOTIFY updated)
+    Q_PROPERTY(double totalBytesPerSec READ totalBytesPerSec NOTIFY updated)
+    Q_PROPERTY(quint64 totalParseFailures READ totalParseFailures NOTIFY updated)
+
+public:
+    explicit RxMetrics(QObject* parent = nullptr);
+
+    // C++ API
+    QVector<RxStreamMetrics> snapshot() const { return m_streams; }
+    // Metrics for the stream on `port`; default-constructed (port 0) when unknown.
+    RxStreamMetrics stream(quint16 port) const;
+
+    QVariantList streams() const;
+    double totalFramesPerSec() const;
+    double totalBytesPerSec() const;
+    quint64 totalParseFailures() const;
+
+public slots:
+    void onMetricsUpdated(const QVector<RxStreamMetrics>& streams);
+
+signals:
+    void updated();
+
+private:
+    QVector<RxStreamMetrics> m_streams;
+};
@@ -0,0 +1,430 @@
+#include "SessionContainer.h"
+#include "CanLogWriter.h"
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QThread>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+constexpr char kMagic[8] = { 'H', 'M', 'I', 'S', 'E', 'S', 'S', '1' };
+constexpr char kEndMagic[8] = { 'H', 'M', 'I', 'S', 'E', 'N', 'D', '1' };
+constexpr char kChunkMagic[4] = { 'H', 'C', 'H', 'K' };
+constexpr char kChannelMagic[4] = { 'H', 'C', 'H', 'N' };
+constexpr char kIndexMagic[4] = { 'H', 'I', 'D', 'X' };
+constexpr qint64 kHeaderBytes = 32;
+constexpr qint64 kChunkHeaderBytes = 32;
+constexpr qint64 kRecordHeaderBytes = 16;
+constexpr qint64 kIndexEntryBytes = 32;
+constexpr qint64 kFooterBytes = 24;
+
+void appendLe16(QByteArray& out, quint16 v) { uchar b[2]; qToLittleEndian(v, b); out.append(reinterpret_cast<const char*>(b), 2); }
+void appendLe32(QByteArray& out, quint32 v) { uchar b[4]; qToLittleEndian(v, b); out.append(reinterpret_cast<const char*>(b), 4); }
+void appendLe64(QByteArray& out, quint64 v) { uchar b[8]; qToLittleEndian(v, b); out.append(reinterpret_cast<const char*>(b), 8); }
+}
+
+namespace SessionContainer {
+
+const char* channelName(quint16 channel)
+{
+    static const char* const names[ChannelCount] = { "navigation", "camera", "controls", "can", "perception" };
+    return channel < ChannelCount ? names[channel] : "unknown";
+}
+
+const char* channelType(quint16 channel)
+{
+    static const char* const types[ChannelCount] = {
+        "vehicle_msgs.Navigation", "vehicle_msgs.CameraBatch", "vehicle_msgs.Controls",
+        "can_stream.CanBatch", "hmi.perception.v1.PerceptionFrame"
+    };
+    return channel < ChannelCount ? types[channel] : "";
+}
+
+} // namespace SessionContainer
+
+// ---- SessionWriter ----
+
+SessionWriter::~SessionWriter()
+{
+    stop();
+    wait();
+}
+
+bool SessionWriter::start(const QString& path, qint64 startEpochMs, const Config& config, const Finished& onFinished,
+                          QString* error)
+{
+    stop();
+    wait();
+    m_config = config;
+    m_config.flushIntervalMs = qMax(1, m_config.flushIntervalMs);
+    m_config.chunkMaxAgeMs = qMax(m_config.flushIntervalMs, m_config.chunkMaxAgeMs);
+    m_config.maxQueuedBytes = qMax(kChunkBytes, m_config.maxQueuedBytes);
+    m_path = path;
+    m_onFinished = onFinished;
+
+    m_file.setFileName(path + CanLogWriter::partialSuffix());
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = m_file.errorString();
+        return false;
+    }
+
+    m_chunk.reserve(kChunkBytes + 64 * 1024);
+    m_chunk.resize(0);
+    m_index.clear();
+    m_current = SessionContainer::ChunkInfo();
+    m_failed = false;
+    m_front.clear();
+    m_stopRequested = false;
+    m_discard = false;
+    m_records.store(0, std::memory_order_relaxed);
+    m_droppedRecords.store(0, std::memory_order_relaxed);
+    m_queuedBytes.store(0, std::memory_order_relaxed);
+    m_writtenBytes.store(0, std::memory_order_relaxed);
+
+    uchar header[kHeaderBytes] = {};
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    qToLittleEndian<quint16>(kVersion, header + 8);
+    qToLittleEndian<quint16>(kHeaderBytes, header + 10);
+    qToLittleEndian<qint64>(startEpochMs, header + 16);
+    writeOut(QByteArray(reinterpret_cast<const char*>(header), kHeaderBytes));
+
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->setObjectName(QStringLiteral("SessionWriter"));
+    m_thread->start(QThread::LowPriority);
+    return true;
+}
+
+void SessionWriter::stop(bool discard)
+{
+    if (!m_thread) return;
+    {
+        QMutexLocker lock(&m_mutex);
+        if (m_stopRequested) return;
+        m_stopRequested = true;
+        m_discard = discard;
+    }
+    m_wake.wakeOne();
+}
+
+void SessionWriter::wait()
+{
+    if (!m_thread) return;
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+}
+
+bool SessionWriter::append(quint64 tNs, quint16 channel, const char* payload, int size)
+{
+    if (!m_thread || size < 0) return false;
+    const qsizetype bytes = kRecordHeaderBytes + size;
+    if (m_queuedBytes.load(std::memory_order_relaxed) + bytes > m_config.maxQueuedBytes) {
+        m_droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    uchar rec[kRecordHeaderBytes] = {};
+    qToLittleEndian<quint64>(tNs, rec);
+    qToLittleEndian<quint16>(channel, rec + 8);
+    qToLittleEndian<quint32>(static_cast<quint32>(size), rec + 12);
+    bool wake = false;
+    {
+        QMutexLocker lock(&m_mutex);
+        if (m_stopRequested) return false;
+        m_front.append(reinterpret_cast<const char*>(rec), kRecordHeaderBytes);
+        m_front.append(payload, size);
+        m_queuedBytes.fetch_add(bytes, std::memory_order_relaxed);
+        wake = m_front.size() >= kChunkBytes;
+    }
+    m_records.fetch_add(1, std::memory_order_relaxed);
+    if (wake)
+        m_wake.wakeOne();
+    return true;
+}
+
+void SessionWriter::run()
+{
+    QByteArray back;
+    bool discard = false;
+    for (;;) {
+        bool stopping = false;
+        {
+            QMutexLocker lock(&m_mutex);
+            QDeadlineTimer deadline(m_config.flushIntervalMs);
+            while (!m_stopRequested && m_front.size() < kChunkBytes && !deadline.hasExpired())
+                m_wake.wait(&m_mutex, deadline);
+            back.swap(m_front);
+            stopping = m_stopRequested;
+            discard = m_discard;
+        }
+
+        if (!back.isEmpty()) {
+            if (!discard)
+                addRecords(back);
+            m_queuedBytes.fetch_sub(back.size(), std::memory_order_relaxed);
+            // A burst of camera frames can leave a buffer far larger than a chunk: give it back
+            if (back.capacity() > 4 * kChunkBytes)
+                back = QByteArray();
+            else
+                back.resize(0);   // keeps capacity for the next swap
+        }
+        if (!m_chunk.isEmpty() && m_chunkAge.elapsed() >= m_config.chunkMaxAgeMs)
+            writeChunk();
+
+        if (stopping) {
+            QMutexLocker lock(&m_mutex);
+            if (m_front.isEmpty())
+                break;
+        }
+    }
+
+    // Only a complete, synced file gets its final name
+    const QString partial = m_file.fileName();
+    bool ok = false;
+    if (discard) {
+        m_file.close();
+        QFile::remove(partial);
+    } else {
+        writeChunk();
+        writeTrailer();
+        CanLogWriter::syncToDisk(m_file);
+        m_file.close();
+        QFile::remove(m_path);
+        if (QFile::rename(partial, m_path))
+            ok = !m_failed;
+        else
+            qWarning() << "SessionWriter: failed to finalise" << partial;
+    }
+    if (m_onFinished)
+        m_onFinished(m_path, ok);
+}
+
+void SessionWriter::addRecords(const QByteArray& records)
+{
+    const char* p = records.constData();
+    const char* const end = p + records.size();
+    while (p + kRecordHeaderBytes <= end) {
+        const uchar* h = reinterpret_cast<const uchar*>(p);
+        const quint64 tNs = qFromLittleEndian<quint64>(h);
+        const quint16 channel = qFromLittleEndian<quint16>(h + 8);
+        const qsizetype bytes = kRecordHeaderBytes + qFromLittleEndian<quint32>(h + 12);
+
+        if (m_chunk.isEmpty()) {
+            m_chunk.resize(kChunkHeaderBytes);   // filled in by writeChunk()
+            m_current = SessionContainer::ChunkInfo();
+            m_current.firstTNs = tNs;
+            m_chunkAge.start();
+        }
+        m_chunk.append(p, bytes);
+        m_current.lastTNs = qMax(m_current.lastTNs, tNs);
+        ++m_current.records;
+        if (channel < 32)
+            m_current.channelMask |= 1u << channel;
+        if (m_chunk.size() >= kChunkBytes)
+            writeChunk();
+        p += bytes;
+    }
+}
+
+void SessionWriter::writeChunk()
+{
+    if (!m_file.isOpen() || m_chunk.isEmpty()) return;
+
+    m_current.offset = m_file.pos();
+    m_current.bodyBytes = static_cast<quint32>(m_chunk.size() - kChunkHeaderBytes);
+    uchar* h = reinterpret_cast<uchar*>(m_chunk.data());
+    std::memcpy(h, kChunkMagic, 4);
+    qToLittleEndian<quint32>(m_current.bodyBytes, h + 4);
+    qToLittleEndian<quint32>(m_current.records, h + 8);
+    qToLittleEndian<quint32>(m_current.channelMask, h + 12);
+    qToLittleEndian<quint64>(m_current.firstTNs, h + 16);
+    qToLittleEndian<quint64>(m_current.lastTNs, h + 24);
+    writeOut(m_chunk);
+    m_index.append(m_current);
+    m_chunk.resize(0);  // keeps capacity
+}
+
+void SessionWriter::writeTrailer()
+{
+    QByteArray trailer;
+    const qint64 channelOffset = m_file.pos();
+    trailer.append(kChannelMagic, 4);
+    appendLe32(trailer, SessionContainer::ChannelCount);
+    for (quint16 c = 0; c < SessionContainer::ChannelCount; ++c) {
+        const QByteArray name(SessionContainer::channelName(c));
+        const QByteArray type(SessionContainer::channelType(c));
+        appendLe16(trailer, c);
+        appendLe16(trailer, static_cast<quint16>(name.size()));
+        appendLe16(trailer, static_cast<quint16>(type.size()));
+        appendLe16(trailer, 0);
+        trailer.append(name);
+        trailer.append(type);
+    }
+    const qint64 indexOffset = channelOffset + trailer.size();
+    trailer.append(kIndexMagic, 4);
+    appendLe32(trailer, static_cast<quint32>(m_index.size()));
+    for (const SessionContainer::ChunkInfo& c : m_index) {
+        appendLe64(trailer, static_cast<quint64>(c.offset));
+        appendLe64(trailer, c.firstTNs);
+        appendLe64(trailer, c.lastTNs);
+        appendLe32(trailer, c.records);
+        appendLe32(trailer, c.channelMask);
+    }
+    appendLe64(trailer, static_cast<quint64>(channelOffset));
+    appendLe64(trailer, static_cast<quint64>(indexOffset));
+    trailer.append(kEndMagic, 8);
+    writeOut(trailer);
+}
+
+void SessionWriter::writeOut(const QByteArray& bytes)
+{
+    const qint64 n = m_file.write(bytes);
+    if (n != bytes.size() && !m_failed) {
+        qWarning() << "SessionWriter: write failed on" << m_file.fileName() << m_file.errorString();
+        m_failed = true;
+    }
+    m_file.flush();
+    if (n > 0)
+        m_writtenBytes.fetch_add(static_cast<quint64>(n), std::memory_order_relaxed);
+}
+
+// ---- SessionReader ----
+
+bool SessionReader::open(const QString& path)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_size = m_file.size();
+    if (m_size < kHeaderBytes) {
+        m_error = QStringLiteral("not a session file (too short)");
+        m_file.close();
+        return false;
+    }
+    m_map = m_file.map(0, m_size);
+    if (!m_map) {
+        m_error = m_file.errorString();
+        m_file.close();
+        return false;
+    }
+    if (std::memcmp(m_map, kMagic, sizeof(kMagic)) != 0) {
+        m_error = QStringLiteral("not a session file (bad magic)");
+        close();
+        return false;
+    }
+    m_startEpochMs = qFromLittleEndian<qint64>(m_map + 16);
+    m_complete = readTrailer();
+    if (!m_complete)
+        scanChunks();
+    rewind();
+    return true;
+}
+
+void SessionReader::close()
+{
+    if (m_map) {
+        m_file.unmap(const_cast<uchar*>(m_map));
+        m_map = nullptr;
+    }
+    m_file.close();
+    m_chunks.clear();
+    m_chunk = 0;
+    m_pos = 0;
+}
+
+bool SessionReader::readTrailer()
+{
+    if (m_size < kHeaderBytes + kFooterBytes) return false;
+    const uchar* f = m_map + m_size - kFooterBytes;
+    if (std::memcmp(f + 16, kEndMagic, 8) != 0) return false;
+    const qint64 indexOffset = static_cast<qint64>(qFromLittleEndian<quint64>(f + 8));
+    if (indexOffset < kHeaderBytes || indexOffset + 8 > m_size - kFooterBytes) return false;
+    const uchar* p = m_map + indexOffset;
+    if (std::memcmp(p, kIndexMagic, 4) != 0) return false;
+    const quint32 count = qFromLittleEndian<quint32>(p + 4);
+    if (indexOffset + 8 + qint64(count) * kIndexEntryBytes > m_size - kFooterBytes) return false;
+
+    QVector<SessionContainer::ChunkInfo> chunks;
+    chunks.reserve(count);
+    p += 8;
+    for (quint32 i = 0; i < count; ++i, p += kIndexEntryBytes) {
+        SessionContainer::ChunkInfo c;
+        c.offset = static_cast<qint64>(qFromLittleEndian<quint64>(p));
+        c.firstTNs = qFromLittleEndian<quint64>(p + 8);
+        c.lastTNs = qFromLittleEndian<quint64>(p + 16);
+        c.records = qFromLittleEndian<quint32>(p + 24);
+        c.channelMask = qFromLittleEndian<quint32>(p + 28);
+        if (c.offset < kHeaderBytes || c.offset + kChunkHeaderBytes > indexOffset) return false;
+        c.bodyBytes = qFromLittleEndian<quint32>(m_map + c.offset + 4);
+        if (c.offset + kChunkHeaderBytes + c.bodyBytes > indexOffset) return false;
+        chunks.append(c);
+    }
+    m_chunks = chunks;
+    return true;
+}
+
+void SessionReader::scanChunks()
+{
+    m_chunks.clear();
+    qint64 pos = kHeaderBytes;
+    while (pos + kChunkHeaderBytes <= m_size) {
+        const uchar* h = m_map + pos;
+        if (std::memcmp(h, kChunkMagic, 4) != 0) break;
+        SessionContainer::ChunkInfo c;
+        c.offset = pos;
+        c.bodyBytes = qFromLittleEndian<quint32>(h + 4);
+        c.records = qFromLittleEndian<quint32>(h + 8);
+        c.channelMask = qFromLittleEndian<quint32>(h + 12);
+        c.firstTNs = qFromLittleEndian<quint64>(h + 16);
+        c.lastTNs = qFromLittleEndian<quint64>(h + 24);
+        if (pos + kChunkHeaderBytes + c.bodyBytes > m_size) break;   // cut short while writing
+        m_chunks.append(c);
+        pos += kChunkHeaderBytes + c.bodyBytes;
+    }
+}
+
+void SessionReader::seek(quint64 tNs)
+{
+    // First chunk that still has records at or after tNs
+    const auto it = std::lower_bound(m_chunks.cbegin(), m_chunks.cend(), tNs,
+                                     [](const SessionContainer::ChunkInfo& c, quint64 t) { return c.lastTNs < t; });
+    m_chunk = static_cast<int>(it - m_chunks.cbegin());
+    if (m_chunk >= m_chunks.size()) return;
+
+    // Records in a chunk are in receive order: skip to the first one due
+    const SessionContainer::ChunkInfo& c = m_chunks.at(m_chunk);
+    const qint64 end = c.offset + kChunkHeaderBytes + c.bodyBytes;
+    m_pos = c.offset + kChunkHeaderBytes;
+    while (m_pos + kRecordHeaderBytes <= end) {
+        const uchar* p = m_map + m_pos;
+        if (qFromLittleEndian<quint64>(p) >= tNs) return;
+        m_pos += kRecordHeaderBytes + qFromLittleEndian<quint32>(p + 12);
+    }
+}
+
+bool SessionReader::next(SessionContainer::Record& rec)
+{
+    while (m_chunk < m_chunks.size()) {
+        const SessionContainer::ChunkInfo& c = m_chunks.at(m_chunk);
+        const qint64 end = c.offset + kChunkHeaderBytes + c.bodyBytes;
+        if (m_pos + kRecordHeaderBytes > end) {
+            if (++m_chunk < m_chunks.size())
+                m_pos = m_chunks.at(m_chunk).offset + kChunkHeaderBytes;
+            continue;
+        }
+        const uchar* p = m_map + m_pos;
+        const quint32 size = qFromLittleEndian<quint32>(p + 12);
+        if (m_pos + kRecordHeaderBytes + size > end)
+            return false;
+        rec.tNs = qFromLittleEndian<quint64>(p);
+        rec.channel = qFromLittleEndian<quint16>(p + 8);
+        rec.payload = reinterpret_cast<const char*>(p + kRecordHeaderBytes);
+        rec.size = static_cast<int>(size);
+        m_pos += kRecordHeaderBytes + size;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <QWaitCondition>
+#include <QtGlobal>
+#include <atomic>
+#include <functional>
+
+class QThread;
+
+// Drive session container (*.hmises): every received stream (Navigation, CameraBatch, Controls,
+// CanBatch, PerceptionFrame) as its raw protobuf payload, in one file that is chunked and indexed by
+// time so a player can seek without reading what it skips.
+//
+//   header   "HMISESS1" | u16 version | u16 headerBytes | u32 reserved | i64 startEpochMs
+//            | u64 reserved                                                       (32 bytes)
+//   chunk    "HCHK" | u32 bodyBytes | u32 records | u32 channelMask | u64 firstTNs | u64 lastTNs
+//            (32 bytes) followed by bodyBytes of records
+//   record   u64 tNs | u16 channel | u16 reserved | u32 size | payload              (16 + size)
+//   trailer  channel table "HCHN" | u32 count | per channel: u16 id | u16 nameLen | u16 typeLen
+//            | u16 reserved | name | type
+//            chunk index "HIDX" | u32 count | per chunk: u64 offset | u64 firstTNs | u64 lastTNs
+//            | u32 records | u32 channelMask                                     (32 bytes each)
+//   footer   u64 channelTableOffset | u64 chunkIndexOffset | "HMISEND1"         (24 bytes)
+//
+// Little-endian; tNs counts from the start of the session on the receiver's monotonic clock. The
+// trailer is written when the writer stops; a file cut short (power loss) has none, and the reader
+// rebuilds the index by walking the chunk headers, losing at most the chunk that was being written.
+namespace SessionContainer {
+
+enum Channel : quint16 {
+    Navigation = 0,   // vehicle_msgs.Navigation       (Controls stream, type 0x01)
+    CameraBatch,      // vehicle_msgs.CameraBatch      (Controls stream, type 0x02)
+    Controls,         // vehicle_msgs.Controls         (Controls stream, type 0x03)
+    CanBatch,         // can_stream.CanBatch           (Logger stream)
+    Perception,       // hmi.perception.v1.PerceptionFrame
+    ChannelCount
+};
+const char* channelName(quint16 channel);
+const char* channelType(quint16 channel);
+inline QString fileSuffix() { return QStringLiteral("hmises"); }
+
+struct ChunkInfo
+{
+    qint64 offset = 0;          // of the chunk header
+    quint64 firstTNs = 0;
+    quint64 lastTNs = 0;
+    quint32 records = 0;
+    quint32 channelMask = 0;    // bit per Channel present in the chunk
+    quint32 bodyBytes = 0;
+};
+
+struct Record
+{
+    quint64 tNs = 0;
+    quint16 channel = 0;
+    const char* payload = nullptr;   // view into the reader's mapping
+    int size = 0;
+};
+
+} // namespace SessionContainer
+
+// Background writer, same scheme as CanLogWriter: GlobalReceiver appends on the RX thread, which
+// only copies the record into a front buffer; a dedicated thread swaps it with the back buffer,
+// collects the records into chunks and writes a chunk when it reaches kChunkBytes or chunkMaxAgeMs,
+// so the file is a sequence of complete chunks and a slow SD card never stalls deframing. When the
+// queue is over its byte budget the record is dropped and counted rather than blocking the caller.
+//
+// The file is written as "<path>.partial" and renamed to `path` once the trailer is written and
+// synced. stop() returns at once; the Finished callback reports when the file is complete.
+class SessionWriter
+{
+public:
+    struct Config
+    {
+        int flushIntervalMs = 250;                     // writer wakes at least this often
+        int chunkMaxAgeMs = 1000;                      // bounds what a crash loses
+        qsizetype maxQueuedBytes = 64 * 1024 * 1024;   // camera JPEGs dominate
+    };
+    // Runs on the writer thread after the file was closed; ok is false when a write or the rename
+    // failed (the file then keeps its ".partial" name) or the file was discarded.
+    using Finished = std::function<void(const QString& path, bool ok)>;
+
+    static constexpr int kVersion = 1;
+    static constexpr qsizetype kChunkBytes = 1024 * 1024;
+
+    SessionWriter() = default;
+    ~SessionWriter();   // stops and waits for the writer thread
+    SessionWriter(const SessionWriter&) = delete;
+    SessionWriter& operator=(const SessionWriter&) = delete;
+
+    // Opens the file and writes its header (synchronously, so a bad path is reported here), then
+    // starts the writer thread.
+    bool start(const QString& path, qint64 startEpochMs, const Config& config, const Finished& onFinished,
+               QString* error = nullptr);
+    // Drains the queue, then writes the trailer and renames the file, or deletes it when `discard`.
+    // Returns immediately; later calls are ignored.
+    void stop(bool discard = false);
+    // Blocks until the writer thread has exited.
+    void wait();
+
+    // Queues one record. False (and the record is counted as dropped) when the queue is full.
+    bool append(quint64 tNs, quint16 channel, const char* payload, int size);
+
+    QString path() const { return m_path; }
+    quint64 records() const { return m_records.load(std::memory_order_relaxed); }
+    quint64 droppedRecords() const { return m_droppedRecords.load(std::memory_order_relaxed); }
+    qint64 queuedBytes() const { return m_queuedBytes.load(std::memory_order_relaxed); }
+    quint64 writtenBytes() const { return m_writtenBytes.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void addRecords(const QByteArray& records);
+    void writeChunk();
+    void writeTrailer();
+    void writeOut(const QByteArray& bytes);
+
+    Config m_config;
+    QString m_path;              // final name
+    Finished m_onFinished;
+    QThread* m_thread = nullptr;
+
+    // Writer thread only (between start and the end of run)
+    QFile m_file;                // "<path>.partial"
+    QByteArray m_chunk;          // header placeholder + records
+    SessionContainer::ChunkInfo m_current;
+    QElapsedTimer m_chunkAge;
+    QVector<SessionContainer::ChunkInfo> m_index;
+    bool m_failed = false;
+
+    QMutex m_mutex;
+    QWaitCondition m_wake;
+    QByteArray m_front;          // guarded by m_mutex; encoded records
+    bool m_stopRequested = false;   // guarded by m_mutex
+    bool m_discard = false;         // guarded by m_mutex
+
+    std::atomic<quint64> m_records{0};
+    std::atomic<quint64> m_droppedRecords{0};
+    std::atomic<qint64> m_queuedBytes{0};
+    std::atomic<quint64> m_writtenBytes{0};
+};
+
+// Memory-mapped reader with time seek.
+class SessionReader
+{
+public:
+    ~SessionReader() { close(); }
+
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return m_map != nullptr; }
+    QString errorString() const { return m_error; }
+
+    qint64 startEpochMs() const { return m_startEpochMs; }
+    // False when the trailer was missing and the index was rebuilt from the chunks
+    bool complete() const { return m_complete; }
+    const QVector<SessionContainer::ChunkInfo>& chunks() const { return m_chunks; }
+    quint64 durationNs() const { return m_chunks.isEmpty() ? 0 : m_chunks.constLast().lastTNs; }
+
+    // Positions next() at the first record with tNs >= tNs
+    void seek(quint64 tNs);
+    void rewind() { m_chunk = 0; m_pos = m_chunks.isEmpty() ? 0 : m_chunks.constFirst().offset + 32; }
+    // False at the end of the session or on a corrupt record
+    bool next(SessionContainer::Record& rec);
+
+private:
+    bool readTrailer();
+    void scanChunks();
+
+    QFile m_file;
+    const uchar* m_map = nullptr;
+    qint64 m_size = 0;
+    qint64 m_startEpochMs = 0;
+    bool m_complete = false;
+    QVector<SessionContainer::ChunkInfo> m_chunks;
+    int m_chunk = 0;       // chunk being read
+    qint64 m_pos = 0;      // next record
+    QString m_error;
+};
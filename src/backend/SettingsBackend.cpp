@@ -2,6 +2,8 @@
 #include "GlobalTransmitter.h"
 #include "NavigationBackend.h"
 #include "GlobalReceiver.h"
+#include "RxConflator.h"
+#include "ShmRing.h"
 #include <QSettings>
 #include <QHostAddress>
 #include <QDebug>
@@ -87,6 +89,54 @@ void SettingsBackend::setRxPortLogger(int port)
     emit rxPortLoggerChanged();
 }
 
+void SettingsBackend::setRxTransport(const QString& transport)
+{
+    const QString t = transport.trimmed().toLower();
+    if (m_rxTransport == t) return;
+    if (!validateTransport(t)) {
+        emit settingsError("Transport must be tcp, udp or shm");
+        return;
+    }
+    m_rxTransport = t;
+    emit rxTransportChanged();
+}
+
+void SettingsBackend::setRxTransportPerception(const QString& transport)
+{
+    const QString t = transport.trimmed().toLower();
+    if (m_rxTransportPerception == t) return;
+    if (!validateTransport(t)) {
+        emit settingsError("Transport must be tcp, udp or shm");
+        return;
+    }
+    m_rxTransportPerception = t;
+    emit rxTransportPerceptionChanged();
+}
+
+void SettingsBackend::setRxTransportLogger(const QString& transport)
+{
+    const QString t = transport.trimmed().toLower();
+    if (m_rxTransportLogger == t) return;
+    if (!validateTransport(t, false)) {
+        emit settingsError("Logger transport must be tcp or shm");
+        return;
+    }
+    m_rxTransportLogger = t;
+    emit rxTransportLoggerChanged();
+}
+
+void SettingsBackend::setRxMulticastGroup(const QString& group)
+{
+    const QString g = group.trimmed();
+    if (m_rxMulticastGroup == g) return;
+    if (!validateMulticastGroup(g)) {
+        emit settingsError("Multicast group must be an IPv4 address in 224.0.0.0/4");
+        return;
+    }
+    m_rxMulticastGroup = g;
+    emit rxMulticastGroupChanged();
+}
+
 void SettingsBackend::setGnssTimeout(int timeout)
 {
     if (m_gnssTimeout == timeout) return;
@@ -98,6 +148,20 @@ void SettingsBackend::setGnssTimeout(int timeout)
     emit gnssTimeoutChanged();
 }
 
+void SettingsBackend::setRxConflateNavigation(bool v)
+{
+    if (m_rxConflateNavigation == v) return;
+    m_rxConflateNavigation = v;
+    emit rxConflateNavigationChanged();
+}
+
+void SettingsBackend::setRxConflatePerception(bool v)
+{
+    if (m_rxConflatePerception == v) return;
+    m_rxConflatePerception = v;
+    emit rxConflatePerceptionChanged();
+}
+
 void SettingsBackend::setDefaultZoom(int zoom)
 {
     if (m_defaultZoom == zoom) return;
@@ -227,7 +291,13 @@ void SettingsBackend::loadSettings()
     m_rxPort = m_settings->value("rxPort", 5001).toInt();
     m_rxPortPerception = m_settings->value("rxPortPerception", 6002).toInt();
     m_rxPortLogger = m_settings->value("rxPortLogger", 6003).toInt();
+    m_rxTransport = m_settings->value("rxTransport", "tcp").toString();
+    m_rxTransportPerception = m_settings->value("rxTransportPerception", "tcp").toString();
+    m_rxTransportLogger = m_settings->value("rxTransportLogger", "tcp").toString();
+    m_rxMulticastGroup = m_settings->value("rxMulticastGroup", QString()).toString();
     m_gnssTimeout = m_settings->value("gnssTimeout", 1200).toInt();
+    m_rxConflateNavigation = m_settings->value("rxConflateNavigation", false).toBool();
+    m_rxConflatePerception = m_settings->value("rxConflatePerception", false).toBool();
     m_settings->endGroup();
 
     m_settings->beginGroup("map");
@@ -279,7 +349,13 @@ void SettingsBackend::loadSettings()
     emit rxPortChanged();
     emit rxPortPerceptionChanged();
     emit rxPortLoggerChanged();
+    emit rxTransportChanged();
+    emit rxTransportPerceptionChanged();
+    emit rxTransportLoggerChanged();
+    emit rxMulticastGroupChanged();
     emit gnssTimeoutChanged();
+    emit rxConflateNavigationChanged();
+    emit rxConflatePerceptionChanged();
     emit defaultZoomChanged();
     emit followVehicleChanged();
     emit map3dEnabledChanged();
@@ -326,7 +402,13 @@ void SettingsBackend::saveSettings()
     m_settings->setValue("rxPort", m_rxPort);
     m_settings->setValue("rxPortPerception", m_rxPortPerception);
     m_settings->setValue("rxPortLogger", m_rxPortLogger);
+    m_settings->setValue("rxTransport", m_rxTransport);
+    m_settings->setValue("rxTransportPerception", m_rxTransportPerception);
+    m_settings->setValue("rxTransportLogger", m_rxTransportLogger);
+    m_settings->setValue("rxMulticastGroup", m_rxMulticastGroup);
     m_settings->setValue("gnssTimeout", m_gnssTimeout);
+    m_settings->setValue("rxConflateNavigation", m_rxConflateNavigation);
+    m_settings->setValue("rxConflatePerception", m_rxConflatePerception);
     m_settings->endGroup();
 
     m_settings->beginGroup("map");
@@ -392,7 +474,13 @@ void SettingsBackend::resetToDefaults()
     m_rxPort = 5001;
     m_rxPortPerception = 6002;
     m_rxPortLogger = 6003;
+    m_rxTransport = "tcp";
+    m_rxTransportPerception = "tcp";
+    m_rxTransportLogger = "tcp";
+    m_rxMulticastGroup.clear();
     m_gnssTimeout = 1200;
+    m_rxConflateNavigation = false;
+    m_rxConflatePerception = false;
     m_defaultZoom = 19;
     m_followVehicle = true;
     m_map3dEnabled = false;
@@ -422,7 +510,13 @@ void SettingsBackend::resetToDefaults()
     emit rxPortChanged();
     emit rxPortPerceptionChanged();
     emit rxPortLoggerChanged();
+    emit rxTransportChanged();
+    emit rxTransportPerceptionChanged();
+    emit rxTransportLoggerChanged();
+    emit rxMulticastGroupChanged();
     emit gnssTimeoutChanged();
+    emit rxConflateNavigationChanged();
+    emit rxConflatePerceptionChanged();
     emit defaultZoomChanged();
     emit followVehicleChanged();
     emit map3dEnabledChanged();
@@ -470,6 +564,15 @@ bool SettingsBackend::validateSettings()
         emit settingsError("Invalid RX port logger (must be 1-65535)");
         return false;
     }
+    if (!validateTransport(m_rxTransport) || !validateTransport(m_rxTransportPerception)
+        || !validateTransport(m_rxTransportLogger, false)) {
+        emit settingsError("Invalid RX transport (tcp, udp or shm; logger: tcp or shm)");
+        return false;
+    }
+    if (!validateMulticastGroup(m_rxMulticastGroup)) {
+        emit settingsError("Invalid RX multicast group");
+        return false;
+    }
     if (m_gnssTimeout < 100 || m_gnssTimeout > 10000) {
         emit settingsError("GNSS timeout must be between 100 and 10000 ms");
         return false;
@@ -493,7 +596,43 @@ void SettingsBackend::applyNetworkSettings()
     // Apply GNSS timeout and RX ports to NavigationBackend
     if (m_nav) {
         m_nav->setGnssTimeout(m_gnssTimeout);
-        m_nav->applyRxPorts(m_rxPort, m_rxPortPerception, m_rxPortLogger);
+        NavigationBackend::RxEndpoints ep;
+        ep.controlsPort = m_rxPort;
+        ep.perceptionPort = m_rxPortPerception;
+        ep.loggerPort = m_rxPortLogger;
+        ep.controlsTransport = m_rxTransport;
+        ep.perceptionTransport = m_rxTransportPerception;
+        ep.loggerTransport = m_rxTransportLogger;
+        ep.multicastGroup = m_rxMulticastGroup;
+        // Advanced, QSettings only: shared-memory segment names (network/rxShmName<Stream>)
+        m_settings->beginGroup("network");
+        ep.controlsShm = m_settings->value("rxShmNameControls", QString::fromLatin1(kShmDefaultControls)).toString();
+        ep.perceptionShm = m_settings->value("rxShmNamePerception", QString::fromLatin1(kShmDefaultPerception)).toString();
+        ep.loggerShm = m_settings->value("rxShmNameLogger", QString::fromLatin1(kShmDefaultLogger)).toString();
+        m_settings->endGroup();
+        m_nav->applyRxEndpoints(ep);
+        if (RxConflator* conflator = m_nav->rxConflator()) {
+            conflator->setConflateNavigation(m_rxConflateNavigation);
+            conflator->setConflatePerception(m_rxConflatePerception);
+        }
+
+        // Advanced, QSettings only: per-stream RX memory caps in KiB (network/rxMaxFrameKB<Stream>,
+        // network/rxMaxBufferKB<Stream>); defaults match GlobalReceiver::StreamLimits
+        struct LimitKeys { GlobalReceiver::StreamKind kind; const char* name; int frameKB; int bufferKB; };
+        const LimitKeys limitKeys[] = {
+            { GlobalReceiver::StreamKind::Controls,   "Controls",   16 * 1024, 32 * 1024 },
+            { GlobalReceiver::StreamKind::Perception, "Perception", 4 * 1024,  8 * 1024 },
+            { GlobalReceiver::StreamKind::Logger,     "Logger",     4 * 1024,  8 * 1024 },
+        };
+        m_settings->beginGroup("network");
+        for (const LimitKeys& k : limitKeys) {
+            const int frameKB = m_settings->value(QStringLiteral("rxMaxFrameKB%1").arg(QLatin1String(k.name)), k.frameKB).toInt();
+            const int bufferKB = m_settings->value(QStringLiteral("rxMaxBufferKB%1").arg(QLatin1String(k.name)), k.bufferKB).toInt();
+            m_nav->applyRxStreamLimits(static_cast<int>(k.kind),
+                                       qBound(1, frameKB, 1024 * 1024) * 1024,
+                                       static_cast<qint64>(qMax(1, bufferKB)) * 1024);
+        }
+        m_settings->endGroup();
     }
 
     // Note: Further RX port changes take effect on next apply (e.g. Save in Settings)
@@ -513,6 +652,19 @@ bool SettingsBackend::validateHost(const QString& host)
     return addr.setAddress(host);
 }
 
+bool SettingsBackend::validateTransport(const QString& transport, bool allowUdp)
+{
+    return transport == QLatin1String("tcp") || transport == QLatin1String("shm")
+        || (allowUdp && transport == QLatin1String("udp"));
+}
+
+bool SettingsBackend::validateMulticastGroup(const QString& group)
+{
+    if (group.isEmpty()) return true; // unicast
+    QHostAddress addr;
+    return addr.setAddress(group) && addr.protocol() == QAbstractSocket::IPv4Protocol && addr.isMulticast();
+}
+
 void SettingsBackend::applyInitialSettings()
 {
     // Apply loaded settings to backends after they're connected
@@ -553,7 +705,13 @@ void SettingsBackend::loadFromUserConfigFile(const QString& path)
     if (o.contains("rxPort")) m_rxPort = num("rxPort", m_rxPort);
     if (o.contains("rxPortPerception")) m_rxPortPerception = num("rxPortPerception", m_rxPortPerception);
     if (o.contains("rxPortLogger")) m_rxPortLogger = num("rxPortLogger", m_rxPortLogger);
+    if (o.contains("rxTransport")) m_rxTransport = str("rxTransport");
+    if (o.contains("rxTransportPerception")) m_rxTransportPerception = str("rxTransportPerception");
+    if (o.contains("rxTransportLogger")) m_rxTransportLogger = str("rxTransportLogger");
+    if (o.contains("rxMulticastGroup")) m_rxMulticastGroup = str("rxMulticastGroup");
     if (o.contains("gnssTimeout")) m_gnssTimeout = num("gnssTimeout", m_gnssTimeout);
+    if (o.contains("rxConflateNavigation")) m_rxConflateNavigation = bol("rxConflateNavigation", m_rxConflateNavigation);
+    if (o.contains("rxConflatePerception")) m_rxConflatePerception = bol("rxConflatePerception", m_rxConflatePerception);
     if (o.contains("defaultZoom")) m_defaultZoom = num("defaultZoom", m_defaultZoom);
     if (o.contains("followVehicle")) m_followVehicle = bol("followVehicle", m_followVehicle);
     if (o.contains("map3dEnabled")) m_map3dEnabled = bol("map3dEnabled", m_map3dEnabled);
@@ -599,7 +757,13 @@ void SettingsBackend::loadFromUserConfigFile(const QString& path)
     emit rxPortChanged();
     emit rxPortPerceptionChanged();
     emit rxPortLoggerChanged();
+    emit rxTransportChanged();
+    emit rxTransportPerceptionChanged();
+    emit rxTransportLoggerChanged();
+    emit rxMulticastGroupChanged();
     emit gnssTimeoutChanged();
+    emit rxConflateNavigationChanged();
+    emit rxConflatePerceptionChanged();
     emit defaultZoomChanged();
     emit followVehicleChanged();
     emit map3dEnabledChanged();
@@ -640,7 +804,13 @@ void SettingsBackend::saveToUserConfigFile(const QString& path)
     o.insert(QStringLiteral("rxPort"), m_rxPort);
     o.insert(QStringLiteral("rxPortPerception"), m_rxPortPerception);
     o.insert(QStringLiteral("rxPortLogger"), m_rxPortLogger);
+    o.insert(QStringLiteral("rxTransport"), m_rxTransport);
+    o.insert(QStringLiteral("rxTransportPerception"), m_rxTransportPerception);
+    o.insert(QStringLiteral("rxTransportLogger"), m_rxTransportLogger);
+    o.insert(QStringLiteral("rxMulticastGroup"), m_rxMulticastGroup);
     o.insert(QStringLiteral("gnssTimeout"), m_gnssTimeout);
+    o.insert(QStringLiteral("rxConflateNavigation"), m_rxConflateNavigation);
+    o.insert(QStringLiteral("rxConflatePerception"), m_rxConflatePerception);
     o.insert(QStringLiteral("defaultZoom"), m_defaultZoom);
     o.insert(QStringLiteral("followVehicle"), m_followVehicle);
     o.insert(QStringLiteral("map3dEnabled"), m_map3dEnabled);
@@ -18,7 +18,16 @@ class SettingsBackend : public QObject
     Q_PROPERTY(int rxPort READ rxPort WRITE setRxPort NOTIFY rxPortChanged)
     Q_PROPERTY(int rxPortPerception READ rxPortPerception WRITE setRxPortPerception NOTIFY rxPortPerceptionChanged)
     Q_PROPERTY(int rxPortLogger READ rxPortLogger WRITE setRxPortLogger NOTIFY rxPortLoggerChanged)
+    // RX transport per stream: "tcp", "udp" (sequence-numbered datagrams; not for the logger) or
+    // "shm" (same-host shared-memory ring), see GlobalReceiver
+    Q_PROPERTY(QString rxTransport READ rxTransport WRITE setRxTransport NOTIFY rxTransportChanged)
+    Q_PROPERTY(QString rxTransportPerception READ rxTransportPerception WRITE setRxTransportPerception NOTIFY rxTransportPerceptionChanged)
+    Q_PROPERTY(QString rxTransportLogger READ rxTransportLogger WRITE setRxTransportLogger NOTIFY rxTransportLoggerChanged)
+    Q_PROPERTY(QString rxMulticastGroup READ rxMulticastGroup WRITE setRxMulticastGroup NOTIFY rxMulticastGroupChanged)
     Q_PROPERTY(int gnssTimeout READ gnssTimeout WRITE setGnssTimeout NOTIFY gnssTimeoutChanged)
+    // Latest-value conflation of the Navigation / Perception RX streams (see RxConflator)
+    Q_PROPERTY(bool rxConflateNavigation READ rxConflateNavigation WRITE setRxConflateNavigation NOTIFY rxConflateNavigationChanged)
+    Q_PROPERTY(bool rxConflatePerception READ rxConflatePerception WRITE setRxConflatePerception NOTIFY rxConflatePerceptionChanged)
 
     // Map Settings
     Q_PROPERTY(int defaultZoom READ defaultZoom WRITE setDefaultZoom NOTIFY defaultZoomChanged)
@@ -69,8 +78,20 @@ public:
     void setRxPortPerception(int port);
     int rxPortLogger() const { return m_rxPortLogger; }
     void setRxPortLogger(int port);
+    QString rxTransport() const { return m_rxTransport; }
+    void setRxTransport(const QString& transport);
+    QString rxTransportPerception() const { return m_rxTransportPerception; }
+    void setRxTransportPerception(const QString& transport);
+    QString rxTransportLogger() const { return m_rxTransportLogger; }
+    void setRxTransportLogger(const QString& transport);
+    QString rxMulticastGroup() const { return m_rxMulticastGroup; }
+    void setRxMulticastGroup(const QString& group);
     int gnssTimeout() const { return m_gnssTimeout; }
     void setGnssTimeout(int timeout);
+    bool rxConflateNavigation() const { return m_rxConflateNavigation; }
+    void setRxConflateNavigation(bool v);
+    bool rxConflatePerception() const { return m_rxConflatePerception; }
+    void setRxConflatePerception(bool v);
 
     // Map Settings
     int defaultZoom() const { return m_defaultZoom; }
@@ -147,7 +168,13 @@ signals:
     void rxPortChanged();
     void rxPortPerceptionChanged();
     void rxPortLoggerChanged();
+    void rxTransportChanged();
+    void rxTransportPerceptionChanged();
+    void rxTransportLoggerChanged();
+    void rxMulticastGroupChanged();
     void gnssTimeoutChanged();
+    void rxConflateNavigationChanged();
+    void rxConflatePerceptionChanged();
     void defaultZoomChanged();
     void followVehicleChanged();
     void map3dEnabledChanged();
@@ -183,7 +210,13 @@ private:
     int m_rxPort;
     int m_rxPortPerception;  // default 6002; TX side not ready yet, so not started by default
     int m_rxPortLogger;      // default 6003 for CAN logger stream
+    QString m_rxTransport = QStringLiteral("tcp");
+    QString m_rxTransportPerception = QStringLiteral("tcp");
+    QString m_rxTransportLogger = QStringLiteral("tcp");
+    QString m_rxMulticastGroup;  // empty = unicast
     int m_gnssTimeout;
+    bool m_rxConflateNavigation = false;
+    bool m_rxConflatePerception = false;
 
     // Map Settings
     int m_defaultZoom;
@@ -227,6 +260,8 @@ private:
     void applyNetworkSettings();
     bool validatePort(int port);
     bool validateHost(const QString& host);
+    bool validateTransport(const QString& transport, bool allowUdp = true);
+    bool validateMulticastGroup(const QString& group);
 
     void loadFromUserConfigFile(const QString& path);
     void saveToUserConfigFile(const QString& path);
@@ -0,0 +1,236 @@
+#include "ShmRing.h"
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define HMI_SHMRING_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef HMI_SHMRING_POSIX
+namespace {
+
+uint64_t roundUpPow2(uint64_t v)
+{
+    uint64_t p = 4096;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+std::string errnoString(const char* what)
+{
+    return std::string(what) + ": " + std::strerror(errno);
+}
+
+} // namespace
+#endif
+
+// ---- ShmRingSegment ----
+
+ShmRingSegment::~ShmRingSegment()
+{
+    close();
+}
+
+bool ShmRingSegment::isSupported()
+{
+#ifdef HMI_SHMRING_POSIX
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool ShmRingSegment::open(const std::string& name, bool create, uint64_t capacity)
+{
+    close();
+    m_name = name;
+    m_error.clear();
+#ifndef HMI_SHMRING_POSIX
+    (void)create;
+    (void)capacity;
+    m_error = "POSIX shared memory not supported on this platform";
+    return false;
+#else
+
+    int fd = ::shm_open(name.c_str(), O_RDWR | (create ? O_CREAT : 0), 0660);
+    if (fd < 0) {
+        m_error = errnoString("shm_open");
+        return false;
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        m_error = errnoString("fstat");
+        ::close(fd);
+        return false;
+    }
+
+    bool initialise = false;
+    size_t bytes = static_cast<size_t>(st.st_size);
+    if (bytes == 0) {
+        if (!create) {
+            m_error = "segment not initialised yet";
+            ::close(fd);
+            return false;
+        }
+        bytes = headerBytes() + roundUpPow2(capacity);
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            m_error = errnoString("ftruncate");
+            ::close(fd);
+            return false;
+        }
+        initialise = true;
+    } else if (bytes < headerBytes()) {
+        m_error = "segment too small";
+        ::close(fd);
+        return false;
+    }
+
+    void* map = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        m_error = errnoString("mmap");
+        return false;
+    }
+
+    auto* h = static_cast<ShmRingHeader*>(map);
+    if (initialise) {
+        h = new (map) ShmRingHeader;
+        h->version = kShmRingVersion;
+        h->capacity = bytes - headerBytes();
+        h->head.store(0, std::memory_order_relaxed);
+        h->tail.store(0, std::memory_order_relaxed);
+        h->framesWritten.store(0, std::memory_order_relaxed);
+        h->framesDropped.store(0, std::memory_order_relaxed);
+        h->magic.store(kShmRingMagic, std::memory_order_release);
+    } else if (h->magic.load(std::memory_order_acquire) != kShmRingMagic
+               || h->version != kShmRingVersion
+               || h->capacity == 0 || (h->capacity & (h->capacity - 1)) != 0
+               || headerBytes() + h->capacity > bytes) {
+        m_error = "segment has an incompatible layout";
+        ::munmap(map, bytes);
+        return false;
+    }
+
+    m_map = map;
+    m_mapBytes = bytes;
+    m_header = h;
+    m_data = static_cast<char*>(map) + headerBytes();
+    return true;
+#endif
+}
+
+void ShmRingSegment::close()
+{
+#ifdef HMI_SHMRING_POSIX
+    if (m_map)
+        ::munmap(m_map, m_mapBytes);
+#endif
+    m_map = nullptr;
+    m_mapBytes = 0;
+    m_header = nullptr;
+    m_data = nullptr;
+}
+
+// ---- ShmRingProducer ----
+
+bool ShmRingProducer::write(const void* payload, uint32_t len)
+{
+    ShmRingHeader* h = m_seg.header();
+    if (!h) return false;
+
+    const uint64_t cap = h->capacity;
+    const uint64_t rec = ShmRingSegment::recordBytes(len);
+    if (len == kShmWrapMarker || rec > cap / 2) {
+        h->framesDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint64_t head = h->head.load(std::memory_order_relaxed);
+    const uint64_t tail = h->tail.load(std::memory_order_acquire);
+    uint64_t off = head & (cap - 1);
+    const uint64_t toEnd = cap - off;
+    const uint64_t need = (rec > toEnd) ? toEnd + rec : rec;
+    if (cap - (head - tail) < need) {
+        h->framesDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    char* data = m_seg.data();
+    if (rec > toEnd) {
+        // toEnd is a multiple of kShmRecordAlign, so the marker always fits
+        std::memcpy(data + off, &kShmWrapMarker, sizeof(uint32_t));
+        head += toEnd;
+        off = 0;
+    }
+    std::memcpy(data + off, &len, sizeof(uint32_t));
+    std::memcpy(data + off + sizeof(uint32_t), payload, len);
+    h->head.store(head + rec, std::memory_order_release);
+    h->framesWritten.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// ---- ShmRingConsumer ----
+
+bool ShmRingConsumer::open(const std::string& name)
+{
+    if (!m_seg.open(name, false))
+        return false;
+    ShmRingHeader* h = m_seg.header();
+    h->tail.store(h->head.load(std::memory_order_acquire), std::memory_order_release);
+    m_pendingRelease = 0;
+    return true;
+}
+
+bool ShmRingConsumer::peek(const char*& payload, uint32_t& len)
+{
+    ShmRingHeader* h = m_seg.header();
+    if (!h) return false;
+
+    const uint64_t cap = h->capacity;
+    uint64_t tail = h->tail.load(std::memory_order_relaxed);
+    const uint64_t head = h->head.load(std::memory_order_acquire);
+
+    while (tail != head) {
+        const uint64_t off = tail & (cap - 1);
+        uint32_t n = 0;
+        std::memcpy(&n, m_seg.data() + off, sizeof(uint32_t));
+        if (n == kShmWrapMarker) {
+            tail += cap - off;
+            h->tail.store(tail, std::memory_order_release);
+            continue;
+        }
+        const uint64_t rec = ShmRingSegment::recordBytes(n);
+        if (rec > cap - off || rec > head - tail) {
+            // Producer restarted with a different view of the ring, or memory was scribbled on
+            ++m_corrupt;
+            h->tail.store(head, std::memory_order_release);
+            return false;
+        }
+        payload = m_seg.data() + off + sizeof(uint32_t);
+        len = n;
+        m_pendingRelease = tail + rec;
+        return true;
+    }
+    return false;
+}
+
+void ShmRingConsumer::release()
+{
+    if (ShmRingHeader* h = m_seg.header(); h && m_pendingRelease)
+        h->tail.store(m_pendingRelease, std::memory_order_release);
+    m_pendingRelease = 0;
+}
+
+uint64_t ShmRingConsumer::pendingBytes() const
+{
+    const ShmRingHeader* h = m_seg.header();
+    if (!h) return 0;
+    return h->head.load(std::memory_order_acquire) - h->tail.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+// Single-producer / single-consumer byte ring in POSIX shared memory, used by GlobalReceiver as a
+// same-host alternative to the TCP streams. Plain C++17 with no Qt dependency so publishers
+// (perception, CAN) can link it directly.
+//
+// Segment layout: ShmRingHeader, then `capacity` data bytes. Records are
+//   [u32 length (host order)][payload bytes][padding to 8]
+// and never straddle the end of the data area: when a record does not fit before the end, the
+// producer writes kShmWrapMarker there and restarts at offset 0. A payload is therefore always
+// contiguous and the consumer hands a pointer into the mapping straight to the parser.
+//
+// head / tail are monotonically increasing byte counters (offset = counter % capacity). Only the
+// producer writes head, only the consumer writes tail. When the ring is full the producer drops the
+// frame (framesDropped) instead of blocking the publisher.
+//
+// Producer example:
+//   ShmRingProducer ring;
+//   if (ring.open("/hmi_rx_perception", 4 << 20))
+//       ring.write(bytes.data(), bytes.size());   // one serialized PerceptionFrame
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+constexpr uint32_t kShmRingMagic = 0x52494D48u;  // "HMIR"
+constexpr uint32_t kShmRingVersion = 1;
+constexpr uint32_t kShmWrapMarker = 0xFFFFFFFFu;
+constexpr uint32_t kShmRecordAlign = 8;
+
+// Payload format per stream is the same as the TCP frame without its length prefix
+// (Controls keeps its 0x01/0x02/0x03 type byte).
+constexpr const char* kShmDefaultControls = "/hmi_rx_controls";
+constexpr const char* kShmDefaultPerception = "/hmi_rx_perception";
+constexpr const char* kShmDefaultLogger = "/hmi_rx_can";
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory ring needs lock-free 64-bit atomics");
+
+struct ShmRingHeader
+{
+    std::atomic<uint32_t> magic;  // stored last (release) by the creator; kShmRingMagic once initialised
+    uint32_t version;
+    uint64_t capacity;      // data bytes, power of two
+    alignas(64) std::atomic<uint64_t> head;           // producer: bytes published
+    alignas(64) std::atomic<uint64_t> tail;           // consumer: bytes released
+    alignas(64) std::atomic<uint64_t> framesWritten;  // producer statistics
+    std::atomic<uint64_t> framesDropped;              // ring full / frame too large
+};
+
+// Mapping of one ring segment; shared by producer and consumer.
+class ShmRingSegment
+{
+public:
+    ShmRingSegment() = default;
+    ~ShmRingSegment();
+    ShmRingSegment(const ShmRingSegment&) = delete;
+    ShmRingSegment& operator=(const ShmRingSegment&) = delete;
+
+    // create=true: create and initialise the segment if missing (capacity rounded up to a power of
+    // two), otherwise reuse it as is. create=false: attach to an initialised segment only.
+    bool open(const std::string& name, bool create, uint64_t capacity = 0);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+    // POSIX shm_open/mmap available? open() always fails elsewhere.
+    static bool isSupported();
+
+    const std::string& name() const { return m_name; }
+    const std::string& errorString() const { return m_error; }
+    ShmRingHeader* header() const { return m_header; }
+    char* data() const { return m_data; }
+    uint64_t capacity() const { return m_header ? m_header->capacity : 0; }
+
+    static constexpr size_t headerBytes() { return (sizeof(ShmRingHeader) + 63) & ~size_t(63); }
+    static constexpr uint64_t recordBytes(uint32_t len)
+    {
+        return (uint64_t(len) + 4 + kShmRecordAlign - 1) & ~uint64_t(kShmRecordAlign - 1);
+    }
+
+private:
+    std::string m_name;
+    std::string m_error;
+    void* m_map = nullptr;
+    size_t m_mapBytes = 0;
+    ShmRingHeader* m_header = nullptr;
+    char* m_data = nullptr;
+};
+
+// Reference producer for publishers on the same host.
+class ShmRingProducer
+{
+public:
+    bool open(const std::string& name, uint64_t capacity = 4u << 20) { return m_seg.open(name, true, capacity); }
+    void close() { m_seg.close(); }
+    bool isOpen() const { return m_seg.isOpen(); }
+    const std::string& errorString() const { return m_seg.errorString(); }
+
+    // Publishes one payload. Returns false (and counts a drop) when the ring is full or the payload
+    // exceeds half the capacity; never blocks.
+    bool write(const void* payload, uint32_t len);
+
+private:
+    ShmRingSegment m_seg;
+};
+
+// Consumer side (GlobalReceiver). peek() views the oldest record in place; release() frees it.
+class ShmRingConsumer
+{
+public:
+    // Attaches and skips anything already queued (stale frames from before the HMI started).
+    bool open(const std::string& name);
+    void close() { m_seg.close(); }
+    bool isOpen() const { return m_seg.isOpen(); }
+    const std::string& errorString() const { return m_seg.errorString(); }
+
+    // True when a record is available; payload stays valid until release().
+    bool peek(const char*& payload, uint32_t& len);
+    void release();
+
+    uint64_t framesDropped() const { return m_seg.header() ? m_seg.header()->framesDropped.load(std::memory_order_relaxed) : 0; }
+    uint64_t framesWritten() const { return m_seg.header() ? m_seg.header()->framesWritten.load(std::memory_order_relaxed) : 0; }
+    uint64_t pendingBytes() const;
+    // Corrupt record lengths seen (ring skipped to the producer's head)
+    uint64_t corruptRecords() const { return m_corrupt; }
+
+private:
+    ShmRingSegment m_seg;
+    uint64_t m_pendingRelease = 0;  // tail after the peeked record
+    uint64_t m_corrupt = 0;
+};
@@ -0,0 +1,101 @@
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QString>
+#include <QTextStream>
+#include <cstdio>
+#include <vector>
+
+#include "CanLogFormat.h"
+
+// HMI_CanLogBench: per-event cost of encoding a CAN recording, old CSV path against the current
+// encoders, on a synthetic batch shaped like real traffic (mostly 8-byte payloads).
+//   HMI_CanLogBench [events] [rounds]
+namespace {
+
+// LoggerBackend's CSV path before the table-driven formatter: QTextStream plus a QString per payload
+QString legacyDataToHex(const std::string& data)
+{
+    if (data.empty()) return QString();
+    QByteArray ba(data.data(), static_cast<int>(data.size()));
+    return QString::fromLatin1(ba.toHex(' ').constData());
+}
+
+void legacyCsv(QByteArray& out, const can_stream::CanBatch& batch)
+{
+    out.resize(0);
+    QTextStream s(&out, QIODevice::WriteOnly);
+    for (const can_stream::CanEvent& e : batch.events()) {
+        s << e.bus_id() << ","
+          << e.can_id() << ","
+          << (e.is_extended() ? "1" : "0") << ","
+          << (e.is_rtr() ? "1" : "0") << ","
+          << e.ts_ns() << ","
+          << e.dlc() << ","
+          << legacyDataToHex(e.data()) << "\n";
+    }
+    s.flush();
+}
+
+void tableCsv(QByteArray& out, const can_stream::CanBatch& batch)
+{
+    out.resize(0);
+    for (const can_stream::CanEvent& e : batch.events())
+        CanLog::appendCsvLine(out, e);
+}
+
+void binary(QByteArray& out, const can_stream::CanBatch& batch)
+{
+    out.resize(0);
+    for (const can_stream::CanEvent& e : batch.events())
+        CanLog::appendRecord(out, e);
+}
+
+template <typename Fn>
+void run(const char* name, Fn fn, const can_stream::CanBatch& batch, int rounds)
+{
+    QByteArray out;
+    fn(out, batch);  // warm-up; also sizes `out` so rounds measure steady state
+    QElapsedTimer t;
+    t.start();
+    for (int r = 0; r < rounds; ++r)
+        fn(out, batch);
+    const double ns = static_cast<double>(t.nsecsElapsed()) / (static_cast<double>(rounds) * batch.events_size());
+    std::printf("%-12s %8.1f ns/event  %6.1f bytes/event\n", name, ns,
+                static_cast<double>(out.size()) / batch.events_size());
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = QCoreApplication::arguments();
+    const int events = args.size() > 1 ? qMax(1, args.at(1).toInt()) : 100000;
+    const int rounds = args.size() > 2 ? qMax(1, args.at(2).toInt()) : 20;
+
+    QRandomGenerator rng(20240611);
+    can_stream::CanBatch batch;
+    quint64 ts = 1'700'000'000'000'000'000ULL;
+    for (int i = 0; i < events; ++i) {
+        can_stream::CanEvent* e = batch.add_events();
+        const bool extended = rng.bounded(4) == 0;
+        const quint32 dlc = rng.bounded(10) == 0 ? rng.bounded(9) : 8;
+        e->set_bus_id(rng.bounded(4));
+        e->set_can_id(extended ? rng.bounded(0x20000000u) : rng.bounded(0x800u));
+        e->set_is_extended(extended);
+        e->set_ts_ns(ts += 50'000 + rng.bounded(20'000));
+        e->set_dlc(dlc);
+        std::string data(dlc, '\0');
+        for (char& c : data)
+            c = static_cast<char>(rng.bounded(256));
+        e->set_data(data);
+    }
+
+    std::printf("%d events x %d rounds\n", events, rounds);
+    run("csv-legacy", legacyCsv, batch, rounds);
+    run("csv-table", tableCsv, batch, rounds);
+    run("binary", binary, batch, rounds);
+    return 0;
+}
@@ -0,0 +1,436 @@
+#include "CanLogConverter.h"
+#include "CanLogIndex.h"
+#include "LogBlockFile.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QThread>
+#include <QtEndian>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr char kColMagic[8] = { 'H', 'M', 'I', 'C', 'C', 'O', 'L', '1' };
+constexpr char kColEndMagic[8] = { 'H', 'M', 'I', 'C', 'E', 'N', 'D', '1' };
+constexpr qsizetype kBlockRawBytes = 1024 * 1024;   // same block size as CanLogWriter
+
+template <typename T>
+void appendLe(QByteArray& out, T v)
+{
+    uchar b[sizeof(T)];
+    qToLittleEndian<T>(v, b);
+    out.append(reinterpret_cast<const char*>(b), sizeof(T));
+}
+
+void toEvent(const CanLog::Record& r, can_stream::CanEvent& e)
+{
+    e.set_bus_id(r.busId);
+    e.set_can_id(r.canId);
+    e.set_is_extended(r.flags & CanLog::kFlagExtended);
+    e.set_is_rtr(r.flags & CanLog::kFlagRtr);
+    e.set_ts_ns(r.tsNs);
+    e.set_dlc(r.dlc);
+    e.set_data(reinterpret_cast<const char*>(r.data), qMin<quint8>(r.dlc, 8));
+}
+
+// Column buffers of one row group
+struct Columns
+{
+    std::vector<quint64> ts;
+    std::vector<quint32> id;
+    std::vector<quint8> bus, flags, dlc, data;
+    quint64 minTs = 0, maxTs = 0;
+
+    size_t rows() const { return ts.size(); }
+    void add(const CanLog::Record& r)
+    {
+        if (ts.empty() || r.tsNs < minTs) minTs = r.tsNs;
+        if (ts.empty() || r.tsNs > maxTs) maxTs = r.tsNs;
+        ts.push_back(r.tsNs);
+        id.push_back(r.canId);
+        bus.push_back(r.busId);
+        flags.push_back(r.flags);
+        dlc.push_back(r.dlc);
+        data.insert(data.end(), r.data, r.data + 8);
+    }
+    void clear()
+    {
+        ts.clear(); id.clear(); bus.clear(); flags.clear(); dlc.clear(); data.clear();
+    }
+};
+
+} // namespace
+
+QByteArray CanColumnar::makeHeader()
+{
+    QByteArray h(kHeaderBytes, '\0');
+    uchar* p = reinterpret_cast<uchar*>(h.data());
+    std::memcpy(p, kColMagic, sizeof(kColMagic));
+    qToLittleEndian<quint16>(kVersion, p + 8);
+    qToLittleEndian<quint16>(kHeaderBytes, p + 10);
+    return h;
+}
+
+CanLogConverter::CanLogConverter(const Options& options)
+    : m_options(options)
+{
+    m_threads = options.threads > 0 ? options.threads : qMax(1, QThread::idealThreadCount());
+}
+
+bool CanLogConverter::convert(const QString& inputPath, const QString& outputPath)
+{
+    m_stats = Stats();
+    m_groups.clear();
+    m_outPos = 0;
+
+    QFile probe(inputPath);
+    if (!probe.open(QIODevice::ReadOnly)) {
+        m_error = inputPath + ": " + probe.errorString();
+        return false;
+    }
+    const bool compressed = probe.peek(sizeof(LogBlock::kMagic)) == QByteArray(LogBlock::kMagic, sizeof(LogBlock::kMagic));
+    probe.close();
+
+    // Session files are named after their start time; .canb headers carry it explicitly
+    const QDateTime named = QDateTime::fromString(QFileInfo(inputPath).fileName().left(19), QStringLiteral("MM-dd-yyyy_HH-mm-ss"));
+    m_startEpochMs = named.isValid() ? named.toMSecsSinceEpoch() : 0;
+
+    m_out.setFileName(outputPath);
+    if (!m_out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_error = outputPath + ": " + m_out.errorString();
+        return false;
+    }
+    const bool ok = compressed ? convertCompressed(inputPath) : convertPlain(inputPath);
+    if (!ok || !finishOutput()) {
+        m_out.close();
+        return false;
+    }
+    m_out.close();
+    return true;
+}
+
+qint64 CanLogConverter::parseStreamHeader(const char* data, qint64 size)
+{
+    if (size >= CanLog::kHeaderBytes && std::memcmp(data, CanLog::kMagic, sizeof(CanLog::kMagic)) == 0) {
+        const uchar* p = reinterpret_cast<const uchar*>(data);
+        m_inBinary = true;
+        m_recordBytes = qFromLittleEndian<quint16>(p + 12);
+        if (m_recordBytes < CanLog::kRecordBytes) {
+            m_error = QStringLiteral("unsupported .canb record size %1").arg(m_recordBytes);
+            return -1;
+        }
+        m_startEpochMs = qFromLittleEndian<qint64>(p + 16);
+        return qFromLittleEndian<quint16>(p + 10);
+    }
+    m_inBinary = false;
+    // CSV: skip the header line if present
+    const QByteArray header = CanLog::csvHeader();
+    if (size >= header.size() - 1 && std::memcmp(data, header.constData(), header.size() - 1) == 0) {
+        const char* nl = static_cast<const char*>(std::memchr(data, '\n', static_cast<size_t>(size)));
+        return nl ? (nl - data) + 1 : size;
+    }
+    return 0;
+}
+
+qint64 CanLogConverter::alignedLength(const char* data, qint64 size) const
+{
+    if (m_inBinary)
+        return size - size % m_recordBytes;
+    for (qint64 i = size; i > 0; --i) {
+        if (data[i - 1] == '\n')
+            return i;
+    }
+    return 0;
+}
+
+bool CanLogConverter::convertPlain(const QString& inputPath)
+{
+    QFile in(inputPath);
+    if (!in.open(QIODevice::ReadOnly)) {
+        m_error = inputPath + ": " + in.errorString();
+        return false;
+    }
+    const qint64 size = in.size();
+    const char* map = size > 0 ? reinterpret_cast<const char*>(in.map(0, size)) : nullptr;
+    if (size > 0 && !map) {
+        m_error = inputPath + ": " + in.errorString();
+        return false;
+    }
+    const qint64 skip = parseStreamHeader(map, size);
+    if (skip < 0 || !writeStream(m_options.to == Format::Csv ? CanLog::csvHeader()
+                                 : m_options.to == Format::Binary ? CanLog::makeHeader(m_startEpochMs)
+                                 : CanColumnar::makeHeader()))
+        return false;
+    m_stats.bytesIn = size;
+
+    qint64 pos = skip;
+    while (pos < size) {
+        qint64 len = qMin(kWindowBytes, size - pos);
+        const bool last = pos + len == size;
+        const qint64 aligned = alignedLength(map + pos, len);
+        if (!last || m_inBinary)
+            len = aligned;
+        if (len == 0) {
+            if (last || m_inBinary) break;   // partial trailing record
+            // A line longer than the window: extend to its end
+            const void* nl = std::memchr(map + pos + kWindowBytes, '\n', static_cast<size_t>(size - pos - kWindowBytes));
+            len = nl ? static_cast<const char*>(nl) - (map + pos) + 1 : size - pos;
+        }
+        if (!processWindow(map + pos, len))
+            return false;
+        pos += len;
+    }
+    return true;
+}
+
+bool CanLogConverter::convertCompressed(const QString& inputPath)
+{
+    // One reader per thread: LogBlockReader seeks its own file handle
+    std::vector<LogBlockReader> readers(static_cast<size_t>(m_threads));
+    for (LogBlockReader& r : readers) {
+        if (!r.open(inputPath)) {
+            m_error = inputPath + ": " + r.errorString();
+            return false;
+        }
+    }
+    const int blocks = readers.front().blocks().size();
+    m_stats.bytesIn = readers.front().rawSize();
+
+    QByteArray carry;
+    bool headerDone = false;
+    const int perWindow = m_threads * 4;
+    for (int first = 0; first < blocks; first += perWindow) {
+        const int count = qMin(perWindow, blocks - first);
+        std::vector<QByteArray> raw(static_cast<size_t>(count));
+        std::vector<char> ok(static_cast<size_t>(count), 0);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < m_threads && t < count; ++t) {
+            workers.emplace_back([&, t]() {
+                for (int i = t; i < count; i += m_threads)
+                    ok[i] = readers[t].readBlock(first + i, raw[i]);
+            });
+        }
+        for (std::thread& w : workers)
+            w.join();
+
+        QByteArray window = carry;
+        bool damaged = false;
+        for (int i = 0; i < count; ++i) {
+            if (!ok[i]) {
+                // Same policy as the other readers: everything up to the damaged block is kept
+                qWarning("[CanLogConv] damaged block %d, stopping there", first + i);
+                damaged = true;
+                break;
+            }
+            window.append(raw[i]);
+        }
+        qint64 start = 0;
+        if (!headerDone) {
+            start = parseStreamHeader(window.constData(), window.size());
+            if (start < 0 || !writeStream(m_options.to == Format::Csv ? CanLog::csvHeader()
+                                          : m_options.to == Format::Binary ? CanLog::makeHeader(m_startEpochMs)
+                                          : CanColumnar::makeHeader()))
+                return false;
+            headerDone = true;
+        }
+        const bool last = damaged || first + count >= blocks;
+        qint64 len = alignedLength(window.constData() + start, window.size() - start);
+        if (last && !m_inBinary)
+            len = window.size() - start;   // final line may lack its newline
+        if (!processWindow(window.constData() + start, len))
+            return false;
+        carry = window.mid(start + len);
+        if (damaged) break;
+    }
+    return true;
+}
+
+bool CanLogConverter::processWindow(const char* data, qint64 size)
+{
+    if (size <= 0) return true;
+
+    // Piece boundaries at record / line starts
+    std::vector<const char*> cuts;
+    cuts.push_back(data);
+    for (int t = 1; t < m_threads; ++t) {
+        qint64 at = size * t / m_threads;
+        if (m_inBinary) {
+            at -= at % m_recordBytes;
+        } else {
+            const void* nl = std::memchr(data + at, '\n', static_cast<size_t>(size - at));
+            at = nl ? static_cast<const char*>(nl) - data + 1 : size;
+        }
+        if (data + at > cuts.back())
+            cuts.push_back(data + at);
+    }
+    cuts.push_back(data + size);
+
+    const size_t pieces = cuts.size() - 1;
+    std::vector<PieceResult> results(pieces);
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < pieces; ++i)
+        workers.emplace_back([&, i]() { processPiece(cuts[i], cuts[i + 1], results[i]); });
+    processPiece(cuts[0], cuts[1], results[0]);
+    for (std::thread& w : workers)
+        w.join();
+
+    for (PieceResult& r : results) {
+        for (RowGroup g : r.groups) {
+            g.offset += m_outPos;
+            m_groups.append(g);
+        }
+        if (!writeOutput(r.out))
+            return false;
+        m_outPos += r.rawBytes;
+        m_stats.eventsIn += r.eventsIn;
+        m_stats.eventsOut += r.eventsOut;
+        m_stats.badLines += r.badLines;
+    }
+    return true;
+}
+
+void CanLogConverter::processPiece(const char* begin, const char* end, PieceResult& result) const
+{
+    const Options& o = m_options;
+    QByteArray& out = result.out;
+    out.reserve((end - begin) + (end - begin) / 2);
+    can_stream::CanEvent scratch;
+    Columns cols;
+
+    const auto flushGroup = [&]() {
+        if (cols.rows() == 0) return;
+        const quint32 rows = static_cast<quint32>(cols.rows());
+        RowGroup g;
+        g.offset = out.size();
+        g.rows = rows;
+        g.minTsNs = cols.minTs;
+        g.maxTsNs = cols.maxTs;
+        result.groups.append(g);
+        out.append("HCRG", 4);
+        appendLe<quint32>(out, rows);
+        appendLe<quint64>(out, cols.minTs);
+        appendLe<quint64>(out, cols.maxTs);
+        for (quint64 v : cols.ts) appendLe<quint64>(out, v);
+        for (quint32 v : cols.id) appendLe<quint32>(out, v);
+        out.append(reinterpret_cast<const char*>(cols.bus.data()), rows);
+        out.append(reinterpret_cast<const char*>(cols.flags.data()), rows);
+        out.append(reinterpret_cast<const char*>(cols.dlc.data()), rows);
+        out.append(reinterpret_cast<const char*>(cols.data.data()), static_cast<qsizetype>(rows) * 8);
+        cols.clear();
+    };
+
+    // Filter one event and encode it; `raw` is its input bytes (CSV line without "\n", or record)
+    const auto take = [&](const CanLog::Record& r, const char* raw, qsizetype rawSize) {
+        ++result.eventsIn;
+        if (r.tsNs < o.fromNs || r.tsNs > o.toNs || r.busId > 3 || !(o.busMask & (1u << r.busId))
+            || !o.idFilter.accepts(r.busId, r.canId, r.flags & CanLog::kFlagExtended))
+            return;
+        ++result.eventsOut;
+        switch (o.to) {
+        case Format::Csv:
+            if (!m_inBinary) {
+                out.append(raw, rawSize);   // already in the output format
+                out.append('\n');
+            } else {
+                toEvent(r, scratch);
+                CanLog::appendCsvLine(out, scratch);
+            }
+            break;
+        case Format::Binary:
+            if (m_inBinary && m_recordBytes == CanLog::kRecordBytes) {
+                out.append(raw, rawSize);
+            } else {
+                toEvent(r, scratch);
+                CanLog::appendRecord(out, scratch);
+            }
+            break;
+        case Format::Columnar:
+            cols.add(r);
+            if (cols.rows() == CanColumnar::kRowGroupRows)
+                flushGroup();
+            break;
+        }
+    };
+
+    CanLog::Record r;
+    if (m_inBinary) {
+        for (const char* p = begin; p + m_recordBytes <= end; p += m_recordBytes) {
+            CanLog::decodeRecord(reinterpret_cast<const uchar*>(p), r);
+            take(r, p, CanLog::kRecordBytes);
+        }
+    } else {
+        const char* line = begin;
+        while (line < end) {
+            const char* nl = static_cast<const char*>(std::memchr(line, '\n', static_cast<size_t>(end - line)));
+            const char* lineEnd = nl ? nl : end;
+            const char* trimmed = (lineEnd > line && lineEnd[-1] == '\r') ? lineEnd - 1 : lineEnd;
+            if (trimmed > line) {
+                if (CanLogIndex::parseCsvLine(line, trimmed, r))
+                    take(r, line, trimmed - line);
+                else
+                    ++result.badLines;
+            }
+            line = lineEnd + 1;
+        }
+    }
+    flushGroup();
+
+    result.rawBytes = out.size();
+    if (o.compressLevel > 0)
+        pack(out);
+}
+
+void CanLogConverter::pack(QByteArray& raw) const
+{
+    QByteArray packed;
+    packed.reserve(raw.size() / 2 + 64);
+    for (qsizetype pos = 0; pos < raw.size(); pos += kBlockRawBytes)
+        LogBlock::appendBlock(packed, raw.constData() + pos, qMin(kBlockRawBytes, raw.size() - pos), m_options.compressLevel);
+    raw.swap(packed);
+}
+
+bool CanLogConverter::writeStream(QByteArray raw)
+{
+    const qint64 rawBytes = raw.size();
+    if (m_options.compressLevel > 0) {
+        if (m_outPos == 0 && !writeOutput(LogBlock::makeHeader()))
+            return false;
+        pack(raw);
+    }
+    if (!writeOutput(raw))
+        return false;
+    m_outPos += rawBytes;
+    return true;
+}
+
+bool CanLogConverter::writeOutput(const QByteArray& bytes)
+{
+    if (bytes.isEmpty()) return true;
+    if (m_out.write(bytes) != bytes.size()) {
+        m_error = m_out.fileName() + ": " + m_out.errorString();
+        return false;
+    }
+    m_stats.bytesOut += bytes.size();
+    return true;
+}
+
+bool CanLogConverter::finishOutput()
+{
+    if (m_options.to != Format::Columnar)
+        return true;
+    QByteArray footer;
+    footer.append("HCRI", 4);
+    appendLe<quint32>(footer, static_cast<quint32>(m_groups.size()));
+    for (const RowGroup& g : m_groups) {
+        appendLe<quint64>(footer, static_cast<quint64>(g.offset));
+        appendLe<quint32>(footer, g.rows);
+        appendLe<quint32>(footer, 0);
+        appendLe<quint64>(footer, g.minTsNs);
+        appendLe<quint64>(footer, g.maxTsNs);
+    }
+    appendLe<quint64>(footer, static_cast<quint64>(m_outPos));
+    footer.append(kColEndMagic, sizeof(kColEndMagic));
+    return writeStream(footer);
+}
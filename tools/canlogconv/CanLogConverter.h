@@ -0,0 +1,115 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+#include "CanIdFilter.h"
+#include "CanLogFormat.h"
+
+// Columnar CAN export (*.cancol): events grouped into row groups, each column stored contiguously
+// so analysis tools can load one column (e.g. ts_ns or can_id) without touching the payloads.
+//
+//   header     "HMICCOL1" | u16 version | u16 headerBytes | u32 reserved              (16 bytes)
+//   row group  "HCRG" | u32 rows | u64 minTsNs | u64 maxTsNs                          (24 bytes)
+//              | u64 ts_ns[rows] | u32 can_id[rows] | u8 bus_id[rows] | u8 flags[rows]
+//              | u8 dlc[rows] | u8 data[rows * 8]
+//   footer     "HCRI" | u32 groups | per group: u64 offset | u32 rows | u32 reserved
+//              | u64 minTsNs | u64 maxTsNs                                          (32 bytes each)
+//              | u64 footerOffset | "HMICEND1"
+//
+// Little-endian; flags as in .canb (bit 0 extended, bit 1 RTR); data zero-padded to 8 bytes.
+namespace CanColumnar {
+
+constexpr quint16 kVersion = 1;
+constexpr int kHeaderBytes = 16;
+constexpr int kRowGroupRows = 65536;
+inline QString fileSuffix() { return QStringLiteral("cancol"); }
+
+QByteArray makeHeader();
+
+} // namespace CanColumnar
+
+// Converts one CAN recording (.csv, .canb, either optionally .hbz block-compressed) into CSV, .canb
+// or columnar output, keeping only events that pass the filters. The input is processed in windows
+// of kWindowBytes; each window is cut at record boundaries into one piece per thread, pieces are
+// parsed, filtered and encoded (and compressed) in parallel, and written back in input order, so
+// the output is identical to a single-threaded run.
+class CanLogConverter
+{
+public:
+    enum class Format { Csv, Binary, Columnar };
+
+    struct Options
+    {
+        Format to = Format::Csv;
+        int compressLevel = 0;          // > 0: wrap the output in LogBlock (.hbz) blocks
+        int threads = 0;                // 0 = QThread::idealThreadCount()
+        quint64 fromNs = 0;
+        quint64 toNs = ~quint64(0);     // inclusive
+        quint32 busMask = 0xF;          // bit per bus_id 0..3
+        CanIdFilter idFilter;
+    };
+
+    struct Stats
+    {
+        quint64 eventsIn = 0;
+        quint64 eventsOut = 0;
+        quint64 badLines = 0;           // CSV lines that did not parse
+        qint64 bytesIn = 0;             // uncompressed input stream
+        qint64 bytesOut = 0;
+    };
+
+    static constexpr qint64 kWindowBytes = 256 * 1024 * 1024;
+
+    explicit CanLogConverter(const Options& options);
+
+    bool convert(const QString& inputPath, const QString& outputPath);
+    QString errorString() const { return m_error; }
+    const Stats& stats() const { return m_stats; }
+
+private:
+    struct RowGroup
+    {
+        qint64 offset = 0;              // relative to the piece output until written
+        quint32 rows = 0;
+        quint64 minTsNs = 0;
+        quint64 maxTsNs = 0;
+    };
+    struct PieceResult
+    {
+        QByteArray out;                 // encoded, and block-compressed when enabled
+        qint64 rawBytes = 0;            // encoded size before compression
+        QVector<RowGroup> groups;
+        quint64 eventsIn = 0;
+        quint64 eventsOut = 0;
+        quint64 badLines = 0;
+    };
+
+    qint64 parseStreamHeader(const char* data, qint64 size);   // bytes to skip, or -1
+    qint64 alignedLength(const char* data, qint64 size) const;  // complete records in [data, data + size)
+    bool convertPlain(const QString& inputPath);
+    bool convertCompressed(const QString& inputPath);
+    bool processWindow(const char* data, qint64 size);
+    void processPiece(const char* begin, const char* end, PieceResult& result) const;
+    void pack(QByteArray& raw) const;          // replaces `raw` by its LogBlock framing
+    bool writeStream(QByteArray raw);           // header / footer bytes of the output stream
+    bool writeOutput(const QByteArray& bytes);
+    bool finishOutput();
+
+    Options m_options;
+    int m_threads = 1;
+    Stats m_stats;
+    QString m_error;
+
+    // Input stream description
+    bool m_inBinary = false;
+    int m_recordBytes = CanLog::kRecordBytes;
+    qint64 m_startEpochMs = 0;
+
+    QFile m_out;
+    qint64 m_outPos = 0;                // position in the output stream (before compression)
+    QVector<RowGroup> m_groups;         // columnar: written row groups
+};
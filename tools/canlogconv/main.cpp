@@ -0,0 +1,114 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QStringList>
+
+#include "CanLogConverter.h"
+#include "LogBlockFile.h"
+
+// HMI_CanLogConv: converts and filters CAN recordings offline, on all cores, e.g.
+//   HMI_CanLogConv 05-01-2025_10-00-00_001.canb.hbz out.csv --bus HS --filter 7E0-7EF
+//   HMI_CanLogConv big.csv big.cancol --from-ns 1000000000 --to-ns 2000000000
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("HMI_CanLogConv"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral(
+        "Convert CAN recordings (.csv, .canb, optionally .hbz) to CSV, .canb or columnar .cancol,\n"
+        "keeping only events that pass the filters."));
+    parser.addHelpOption();
+    parser.addPositionalArgument(QStringLiteral("input"), QStringLiteral("Recording to read."));
+    parser.addPositionalArgument(QStringLiteral("output"), QStringLiteral("File to write; the format follows its suffix unless --to is given."));
+
+    const QCommandLineOption toOpt(QStringLiteral("to"),
+        QStringLiteral("Output format: csv, canb or cancol."), QStringLiteral("format"));
+    const QCommandLineOption compressOpt(QStringLiteral("compress"),
+        QStringLiteral("Block-compress the output at zlib <level> 1..9 (default: only when the output ends in .hbz)."),
+        QStringLiteral("level"));
+    const QCommandLineOption threadsOpt(QStringLiteral("threads"),
+        QStringLiteral("Worker threads (default: all cores)."), QStringLiteral("n"), QStringLiteral("0"));
+    const QCommandLineOption fromOpt(QStringLiteral("from-ns"),
+        QStringLiteral("Keep events with ts_ns >= <ns>."), QStringLiteral("ns"));
+    const QCommandLineOption toNsOpt(QStringLiteral("to-ns"),
+        QStringLiteral("Keep events with ts_ns <= <ns>."), QStringLiteral("ns"));
+    const QCommandLineOption busOpt(QStringLiteral("bus"),
+        QStringLiteral("Comma-separated buses to keep (HS, CE, SC, LS or 0..3)."), QStringLiteral("list"));
+    const QCommandLineOption filterOpt(QStringLiteral("filter"),
+        QStringLiteral("CAN-ID filter expression, same syntax as the logger's ID filter."), QStringLiteral("expr"));
+    parser.addOptions({ toOpt, compressOpt, threadsOpt, fromOpt, toNsOpt, busOpt, filterOpt });
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 2)
+        parser.showHelp(1);
+    const QString input = args.at(0);
+    const QString output = args.at(1);
+
+    CanLogConverter::Options options;
+    QString suffix = QFileInfo(output).fileName().toLower();
+    const bool hbz = suffix.endsWith("." + LogBlock::fileSuffix());
+    if (hbz)
+        suffix.chop(LogBlock::fileSuffix().size() + 1);
+    QString format = parser.value(toOpt).toLower();
+    if (format.isEmpty())
+        format = suffix.section('.', -1);
+    if (format == QLatin1String("csv"))
+        options.to = CanLogConverter::Format::Csv;
+    else if (format == CanLog::fileSuffix())
+        options.to = CanLogConverter::Format::Binary;
+    else if (format == CanColumnar::fileSuffix())
+        options.to = CanLogConverter::Format::Columnar;
+    else {
+        qWarning() << "[CanLogConv] unknown output format" << format;
+        return 1;
+    }
+    options.compressLevel = parser.isSet(compressOpt) ? qBound(1, parser.value(compressOpt).toInt(), 9) : (hbz ? 1 : 0);
+    options.threads = parser.value(threadsOpt).toInt();
+    if (parser.isSet(fromOpt))
+        options.fromNs = parser.value(fromOpt).toULongLong();
+    if (parser.isSet(toNsOpt))
+        options.toNs = parser.value(toNsOpt).toULongLong();
+    if (parser.isSet(busOpt)) {
+        static const char* const names[] = { "HS", "CE", "SC", "LS" };
+        options.busMask = 0;
+        for (const QString& b : parser.value(busOpt).split(',', Qt::SkipEmptyParts)) {
+            int bus = -1;
+            for (int i = 0; i < 4; ++i) {
+                if (b.trimmed().compare(QLatin1String(names[i]), Qt::CaseInsensitive) == 0 || b.trimmed() == QString::number(i))
+                    bus = i;
+            }
+            if (bus < 0) {
+                qWarning() << "[CanLogConv] unknown bus" << b;
+                return 1;
+            }
+            options.busMask |= 1u << bus;
+        }
+    }
+    QString filterError;
+    if (!options.idFilter.compile(parser.value(filterOpt), &filterError)) {
+        qWarning() << "[CanLogConv] bad --filter:" << filterError;
+        return 1;
+    }
+
+    CanLogConverter converter(options);
+    QElapsedTimer timer;
+    timer.start();
+    if (!converter.convert(input, output)) {
+        qWarning() << "[CanLogConv]" << converter.errorString();
+        return 1;
+    }
+    const double sec = qMax<qint64>(1, timer.nsecsElapsed()) / 1e9;
+    const CanLogConverter::Stats& s = converter.stats();
+    qInfo().noquote() << QStringLiteral("[CanLogConv] %1 -> %2 events (%3 bad lines), %4 MB -> %5 MB in %6 s: "
+                                        "%7 Mevents/s, %8 MB/s")
+                             .arg(s.eventsIn).arg(s.eventsOut).arg(s.badLines)
+                             .arg(s.bytesIn / 1e6, 0, 'f', 1).arg(s.bytesOut / 1e6, 0, 'f', 1)
+                             .arg(sec, 0, 'f', 2)
+                             .arg(s.eventsIn / sec / 1e6, 0, 'f', 2)
+                             .arg(s.bytesIn / sec / 1e6, 0, 'f', 1);
+    return 0;
+}
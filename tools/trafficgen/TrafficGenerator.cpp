@@ -0,0 +1,365 @@
+#include "TrafficGenerator.h"
+
+#include <QBuffer>
+#include <QDebug>
+#include <QImage>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QtEndian>
+#include <QtMath>
+#include <cmath>
+#include <limits>
+
+namespace {
+// Loop around the Ohio State campus so the map page has something sensible to draw
+constexpr double kCenterLat = 40.0017;
+constexpr double kCenterLon = -83.0160;
+constexpr double kLoopRadiusDeg = 0.002;
+constexpr double kLoopPeriodSec = 120.0;
+constexpr int kMaxCatchUpPerTick = 1000;
+constexpr int kMaxDatagram = 65507;
+}
+
+TrafficGenerator::TrafficGenerator(const Config& config, QObject* parent)
+    : QObject(parent)
+    , m_cfg(config)
+{
+    m_tickTimer.setTimerType(Qt::PreciseTimer);
+    m_tickTimer.setInterval(1);
+    connect(&m_tickTimer, &QTimer::timeout, this, &TrafficGenerator::tick);
+    m_reportTimer.setInterval(1000);
+    connect(&m_reportTimer, &QTimer::timeout, this, &TrafficGenerator::report);
+}
+
+void TrafficGenerator::start()
+{
+    if (!m_hostAddr.setAddress(m_cfg.host))
+        m_hostAddr = QHostAddress(QHostAddress::LocalHost);
+    setupLinks();
+
+    auto addStream = [this](const QString& name, double hz, Link* link, std::function<void(Stream&)> fn) {
+        if (hz <= 0.0) return;
+        Stream s;
+        s.name = name;
+        s.hz = hz;
+        s.link = link;
+        s.emitOne = std::move(fn);
+        m_streams.push_back(std::move(s));
+    };
+    addStream(QStringLiteral("navigation"), m_cfg.navHz, &m_controls, [this](Stream& s) { emitNavigation(s); });
+    addStream(QStringLiteral("controls"), m_cfg.controlsHz, &m_controls, [this](Stream& s) { emitControls(s); });
+    addStream(QStringLiteral("camera"), m_cfg.cameraHz, &m_controls, [this](Stream& s) { emitCameraBatch(s); });
+    addStream(QStringLiteral("perception"), m_cfg.perceptionHz, &m_perception, [this](Stream& s) { emitPerception(s); });
+    if (m_cfg.canEventsPerSec > 0.0)
+        addStream(QStringLiteral("can"), m_cfg.canBatchHz, &m_logger, [this](Stream& s) { emitCanBatch(s); });
+
+    if (m_cfg.cameraHz > 0.0) {
+        const QByteArray jpeg = makeJpeg(m_cfg.jpegBytes);
+        qInfo() << "[TrafficGen] camera JPEG" << jpeg.size() << "bytes x" << m_cfg.cameras << "cameras";
+        for (int i = 0; i < m_cfg.cameras; ++i) {
+            auto* f = m_camera.add_frames();
+            f->set_camera_id("cam" + std::to_string(i));
+            f->set_jpeg_data(jpeg.constData(), static_cast<size_t>(jpeg.size()));
+        }
+    }
+
+    qInfo() << "[TrafficGen] host" << m_cfg.host << "transport" << m_cfg.transport
+            << "| nav" << m_cfg.navHz << "Hz x" << m_cfg.waypoints << "waypoints"
+            << "| perception" << m_cfg.perceptionHz << "Hz x" << m_cfg.objects << "objects"
+            << "| CAN" << m_cfg.canEventsPerSec << "ev/s in" << m_cfg.canBatchHz << "batches/s on"
+            << m_cfg.canBuses << "buses"
+            << "| camera" << m_cfg.cameraHz << "Hz";
+
+    m_clock.start();
+    m_tickTimer.start();
+    m_reportTimer.start();
+    if (m_cfg.durationSec > 0) {
+        QTimer::singleShot(m_cfg.durationSec * 1000, this, [this]() {
+            report();
+            m_tickTimer.stop();
+            m_reportTimer.stop();
+            for (Link* l : { &m_controls, &m_perception, &m_logger }) {
+                if (l->tcp) l->tcp->flush();
+            }
+            emit finished();
+        });
+    }
+}
+
+void TrafficGenerator::setupLinks()
+{
+    const bool udp = (m_cfg.transport == QLatin1String("udp"));
+    const bool shm = (m_cfg.transport == QLatin1String("shm"));
+
+    m_controls.name = QStringLiteral("controls");
+    m_controls.kind = LinkKind::Controls;
+    m_controls.port = m_cfg.controlsPort;
+    m_perception.name = QStringLiteral("perception");
+    m_perception.kind = LinkKind::Perception;
+    m_perception.port = m_cfg.perceptionPort;
+    m_logger.name = QStringLiteral("logger");
+    m_logger.kind = LinkKind::Logger;
+    m_logger.port = m_cfg.loggerPort;
+
+    for (Link* l : { &m_controls, &m_perception, &m_logger }) {
+        if (shm) {
+            const char* name = l->kind == LinkKind::Controls ? kShmDefaultControls
+                             : l->kind == LinkKind::Perception ? kShmDefaultPerception
+                             : kShmDefaultLogger;
+            l->shm = std::make_unique<ShmRingProducer>();
+            const uint64_t capacity = (l->kind == LinkKind::Controls && m_cfg.cameraHz > 0.0) ? (64u << 20) : (4u << 20);
+            if (!l->shm->open(name, capacity))
+                qWarning() << "[TrafficGen] shm" << name << QString::fromStdString(l->shm->errorString());
+        } else if (udp && l->kind != LinkKind::Logger) {
+            l->udp = new QUdpSocket(this);
+        } else {
+            l->tcp = new QTcpSocket(this);
+            l->tcp->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+            ensureConnected(*l);
+        }
+    }
+}
+
+void TrafficGenerator::ensureConnected(Link& link)
+{
+    if (!link.tcp || link.tcp->state() != QAbstractSocket::UnconnectedState)
+        return;
+    const qint64 nowMs = m_clock.isValid() ? m_clock.elapsed() : 0;
+    if (nowMs - link.lastConnectAttemptMs < 1000)
+        return;
+    link.lastConnectAttemptMs = nowMs;
+    link.tcp->connectToHost(m_hostAddr, link.port);
+}
+
+bool TrafficGenerator::send(Link& link, quint8 type, const google::protobuf::MessageLite& msg, Stream& stream)
+{
+    const size_t bodySize = msg.ByteSizeLong();
+    const int typeBytes = type ? 1 : 0;
+    if (bodySize + typeBytes > static_cast<size_t>(std::numeric_limits<int>::max() - 8)) {
+        ++stream.dropped;
+        return false;
+    }
+    const int payloadSize = static_cast<int>(bodySize) + typeBytes;
+
+    // [4-byte prefix: TCP length or UDP sequence; absent for shm][type][body]
+    const int prefix = link.shm ? 0 : 4;
+    m_out.resize(prefix + payloadSize);
+    uchar* out = reinterpret_cast<uchar*>(m_out.data());
+    if (link.udp)
+        qToBigEndian<quint32>(link.seq, out);
+    else if (link.kind == LinkKind::Logger && !link.shm)
+        qToLittleEndian<quint32>(static_cast<quint32>(payloadSize), out);
+    else if (!link.shm)
+        qToBigEndian<quint32>(static_cast<quint32>(payloadSize), out);
+    if (type)
+        out[prefix] = type;
+    msg.SerializeWithCachedSizesToArray(out + prefix + typeBytes);
+
+    bool ok = false;
+    if (link.shm) {
+        ok = link.shm->isOpen() && link.shm->write(m_out.constData(), static_cast<uint32_t>(m_out.size()));
+    } else if (link.udp) {
+        ok = m_out.size() <= kMaxDatagram
+             && link.udp->writeDatagram(m_out, m_hostAddr, link.port) == m_out.size();
+        ++link.seq;
+    } else if (link.tcp) {
+        ensureConnected(link);
+        ok = link.tcp->state() == QAbstractSocket::ConnectedState
+             && link.tcp->bytesToWrite() < m_cfg.maxQueuedBytes
+             && link.tcp->write(m_out) == m_out.size();
+    }
+
+    if (ok) {
+        ++stream.delivered;
+        stream.bytes += static_cast<quint64>(m_out.size());
+    } else {
+        ++stream.dropped;
+    }
+    return ok;
+}
+
+void TrafficGenerator::tick()
+{
+    const double t = m_clock.nsecsElapsed() / 1e9;
+    for (Link* l : { &m_controls, &m_perception, &m_logger })
+        ensureConnected(*l);
+
+    for (Stream& s : m_streams) {
+        const auto due = static_cast<quint64>(t * s.hz) + 1;   // first message at t = 0
+        int budget = kMaxCatchUpPerTick;
+        while (s.sent < due && budget-- > 0) {
+            s.emitOne(s);
+            ++s.sent;
+        }
+        if (s.sent < due)
+            s.sent = due;   // generator itself fell behind; do not burst later
+    }
+}
+
+void TrafficGenerator::report()
+{
+    QStringList parts;
+    for (Stream& s : m_streams) {
+        const quint64 d = s.delivered - s.deliveredAtReport;
+        const quint64 b = s.bytes - s.bytesAtReport;
+        const quint64 x = s.dropped - s.droppedAtReport;
+        parts << QStringLiteral("%1 %2/s %3 KB/s drop %4")
+                     .arg(s.name)
+                     .arg(d)
+                     .arg(b / 1024.0, 0, 'f', 1)
+                     .arg(x);
+        s.deliveredAtReport = s.delivered;
+        s.bytesAtReport = s.bytes;
+        s.droppedAtReport = s.dropped;
+    }
+    qInfo().noquote() << "[TrafficGen]" << parts.join(QStringLiteral(" | "));
+}
+
+// ---- message builders ----
+
+void TrafficGenerator::emitNavigation(Stream& s)
+{
+    const double t = m_clock.nsecsElapsed() / 1e9;
+    const double a = 2.0 * M_PI * t / kLoopPeriodSec;
+    m_nav.set_current_lat(static_cast<float>(kCenterLat + kLoopRadiusDeg * std::sin(a)));
+    m_nav.set_current_lon(static_cast<float>(kCenterLon + kLoopRadiusDeg * std::cos(a)));
+    m_nav.set_heading_deg(static_cast<float>(std::fmod(360.0 - qRadiansToDegrees(a), 360.0)));
+    m_nav.set_safety_states(0);
+
+    // Waypoints ahead of the vehicle along the loop; repeated fields keep their elements
+    const int n = qMax(0, m_cfg.waypoints);
+    while (m_nav.waypoints_size() > n)
+        m_nav.mutable_waypoints()->RemoveLast();
+    while (m_nav.waypoints_size() < n)
+        m_nav.add_waypoints();
+    for (int i = 0; i < n; ++i) {
+        const double ai = a + (i + 1) * (M_PI / 2.0) / n;
+        auto* wp = m_nav.mutable_waypoints(i);
+        wp->set_lat(static_cast<float>(kCenterLat + kLoopRadiusDeg * std::sin(ai)));
+        wp->set_lon(static_cast<float>(kCenterLon + kLoopRadiusDeg * std::cos(ai)));
+    }
+    send(*s.link, 0x01, m_nav, s);
+}
+
+void TrafficGenerator::emitControls(Stream& s)
+{
+    static const char* const kInstructions[] = { "STRAIGHT", "LEFT", "RIGHT" };
+    const quint64 step = s.sent / 50;   // change the maneuver every few seconds
+    const int turn = static_cast<int>(step % 3);
+    m_ctl.set_manual_takeover_flag(0);
+    m_ctl.set_next_instruction(kInstructions[turn]);
+    m_ctl.set_next_distance_m(turn == 0 ? std::numeric_limits<float>::infinity()
+                                        : static_cast<float>(100.0 - (s.sent % 50) * 2.0));
+    m_ctl.set_turn_signal_cmd(turn);
+    send(*s.link, 0x03, m_ctl, s);
+}
+
+void TrafficGenerator::emitPerception(Stream& s)
+{
+    const double t = m_clock.nsecsElapsed() / 1e9;
+    const double a = 2.0 * M_PI * t / kLoopPeriodSec;
+    const double lat = kCenterLat + kLoopRadiusDeg * std::sin(a);
+    const double lon = kCenterLon + kLoopRadiusDeg * std::cos(a);
+
+    const int n = qMax(0, m_cfg.objects);
+    while (m_perceptionFrame.objects_size() > n)
+        m_perceptionFrame.mutable_objects()->RemoveLast();
+    while (m_perceptionFrame.objects_size() < n)
+        m_perceptionFrame.add_objects();
+    for (int i = 0; i < n; ++i) {
+        auto* o = m_perceptionFrame.mutable_objects(i);
+        const int type = 1 + (i % 9);
+        o->set_object_type_id(type);
+        // Ring of objects 20..80 m around the vehicle, slowly rotating
+        const double r = (0.0002 + 0.0006 * ((i * 37) % 100) / 100.0);
+        const double ai = a * 3.0 + i * 2.399963;   // golden angle spread
+        o->mutable_coord_abs()->set_latitude(static_cast<float>(lat + r * std::sin(ai)));
+        o->mutable_coord_abs()->set_longitude(static_cast<float>(lon + r * std::cos(ai)));
+        o->clear_traffic_sign_data();
+        if (type == 9) {
+            if (i % 2) {
+                o->add_traffic_sign_data(1);   // SPEED_LIMIT_MPH
+                o->add_traffic_sign_data(25);
+            } else {
+                o->add_traffic_sign_data(3);   // STOP
+            }
+        }
+    }
+    send(*s.link, 0, m_perceptionFrame, s);
+}
+
+void TrafficGenerator::emitCanBatch(Stream& s)
+{
+    // K events/s spread over batchHz batches; the fractional remainder carries over
+    const double exact = m_cfg.canEventsPerSec / m_cfg.canBatchHz + m_canCarry;
+    const int n = static_cast<int>(exact);
+    m_canCarry = exact - n;
+
+    while (m_can.events_size() > n)
+        m_can.mutable_events()->RemoveLast();
+    while (m_can.events_size() < n)
+        m_can.add_events();
+
+    const quint64 tsNs = static_cast<quint64>(m_clock.nsecsElapsed());
+    const int buses = qMax(1, m_cfg.canBuses);
+    for (int i = 0; i < n; ++i) {
+        const quint64 k = m_canEventCounter++;
+        auto* e = m_can.mutable_events(i);
+        e->set_bus_id(static_cast<quint32>(k % buses));
+        e->set_can_id(static_cast<quint32>(0x100 + (k / buses) % 64));
+        e->set_is_extended(false);
+        e->set_is_rtr(false);
+        e->set_ts_ns(tsNs);
+        e->set_dlc(8);
+        char data[8];
+        qToLittleEndian<quint64>(k, data);
+        e->set_data(data, sizeof(data));
+    }
+    send(*s.link, 0, m_can, s);
+}
+
+void TrafficGenerator::emitCameraBatch(Stream& s)
+{
+    m_camera.set_timestamp(m_clock.nsecsElapsed());
+    send(*s.link, 0x02, m_camera, s);
+}
+
+QByteArray TrafficGenerator::makeJpeg(int targetBytes)
+{
+    // Gradient plus noise compresses roughly like a camera frame; resize until the encoded size is
+    // close to the target (JPEG size cannot be set directly)
+    QRandomGenerator rng(42);
+    QByteArray best;
+    double side = std::sqrt(qMax(1024, targetBytes) * 2.0);
+    for (int attempt = 0; attempt < 5; ++attempt) {
+        const int w = qMax(16, static_cast<int>(side * 4.0 / 3.0));
+        const int h = qMax(16, static_cast<int>(side * 3.0 / 4.0));
+        QImage img(w, h, QImage::Format_RGB32);
+        for (int y = 0; y < h; ++y) {
+            auto* line = reinterpret_cast<QRgb*>(img.scanLine(y));
+            for (int x = 0; x < w; ++x) {
+                const int noise = static_cast<int>(rng.bounded(64));
+                line[x] = qRgb((x * 255 / w + noise) & 0xff, (y * 255 / h + noise) & 0xff, (noise * 3) & 0xff);
+            }
+        }
+        QByteArray bytes;
+        QBuffer buf(&bytes);
+        buf.open(QIODevice::WriteOnly);
+        img.save(&buf, "JPEG", 85);
+        if (bytes.isEmpty())
+            break;   // no JPEG image plugin
+        best = bytes;
+        const double ratio = static_cast<double>(targetBytes) / bytes.size();
+        if (ratio > 0.9 && ratio < 1.1)
+            break;
+        side *= std::sqrt(ratio);
+    }
+    if (best.isEmpty()) {
+        // Keeps the wire load right even though the HMI will not decode it
+        qWarning() << "[TrafficGen] JPEG encoder unavailable, sending filler bytes";
+        best = QByteArray(qMax(4, targetBytes), '\0');
+        best[0] = char(0xFF); best[1] = char(0xD8);
+        best[best.size() - 2] = char(0xFF); best[best.size() - 1] = char(0xD9);
+    }
+    return best;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHostAddress>
+#include <QPointer>
+#include <QString>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUdpSocket>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "HMI_RX_CONTROLS.pb.h"
+#include "HMI_RX_CAN.pb.h"
+#include "HMI_RX_PERCEPTION.pb.h"
+#include "ShmRing.h"
+
+namespace google::protobuf { class MessageLite; }
+
+// Synthetic vehicle traffic in exactly the framing GlobalReceiver expects:
+//   Controls port   4-byte big-endian length, then type byte (0x01 Navigation, 0x02 CameraBatch,
+//                   0x03 Controls) and the message
+//   Perception port 4-byte big-endian length, PerceptionFrame
+//   Logger port     4-byte little-endian length, CanBatch
+// With transport "udp" Controls/Perception go out as datagrams ([u32 BE sequence][payload]) and with
+// "shm" every stream is published to the default shared-memory rings (src/shmring).
+//
+// Every stream is rate-scheduled against one monotonic clock. A message that finds its TCP socket
+// disconnected, or more than maxQueuedBytes already waiting, is counted as dropped instead of
+// queued, so the per-second report shows where the HMI stops keeping up.
+class TrafficGenerator : public QObject
+{
+    Q_OBJECT
+public:
+    struct Config {
+        QString host = QStringLiteral("127.0.0.1");
+        quint16 controlsPort = 5001;
+        quint16 perceptionPort = 6002;
+        quint16 loggerPort = 6003;
+        QString transport = QStringLiteral("tcp");   // tcp | udp | shm
+
+        double navHz = 10.0;
+        int waypoints = 50;
+        double controlsHz = 5.0;
+        double perceptionHz = 10.0;
+        int objects = 20;
+        double canEventsPerSec = 2000.0;
+        double canBatchHz = 100.0;
+        int canBuses = 4;
+        double cameraHz = 0.0;
+        int cameras = 3;
+        int jpegBytes = 60000;
+
+        int durationSec = 0;                          // 0 = run until interrupted
+        qint64 maxQueuedBytes = 8 * 1024 * 1024;
+    };
+
+    explicit TrafficGenerator(const Config& config, QObject* parent = nullptr);
+
+    void start();
+
+signals:
+    void finished();
+
+private slots:
+    void tick();
+    void report();
+
+private:
+    enum class LinkKind { Controls, Perception, Logger };
+
+    struct Link {
+        QString name;
+        LinkKind kind = LinkKind::Controls;
+        quint16 port = 0;
+        QPointer<QTcpSocket> tcp;
+        QPointer<QUdpSocket> udp;
+        std::unique_ptr<ShmRingProducer> shm;
+        quint32 seq = 0;
+        qint64 lastConnectAttemptMs = -1000000;
+    };
+
+    struct Stream {
+        QString name;
+        double hz = 0.0;
+        Link* link = nullptr;
+        std::function<void(Stream&)> emitOne;
+        quint64 sent = 0;           // messages scheduled so far
+        quint64 delivered = 0;
+        quint64 dropped = 0;
+        quint64 bytes = 0;
+        quint64 deliveredAtReport = 0;
+        quint64 bytesAtReport = 0;
+        quint64 droppedAtReport = 0;
+    };
+
+    void setupLinks();
+    void ensureConnected(Link& link);
+    // Frames `msg` for the link (type 0 = no type byte) and sends it; false when dropped
+    bool send(Link& link, quint8 type, const google::protobuf::MessageLite& msg, Stream& stream);
+
+    void emitNavigation(Stream& s);
+    void emitControls(Stream& s);
+    void emitPerception(Stream& s);
+    void emitCanBatch(Stream& s);
+    void emitCameraBatch(Stream& s);
+
+    static QByteArray makeJpeg(int targetBytes);
+
+    Config m_cfg;
+    QHostAddress m_hostAddr;
+    Link m_controls;
+    Link m_perception;
+    Link m_logger;
+    std::vector<Stream> m_streams;
+
+    QTimer m_tickTimer;
+    QTimer m_reportTimer;
+    QElapsedTimer m_clock;
+
+    // Reused message objects and output buffer
+    vehicle_msgs::Navigation m_nav;
+    vehicle_msgs::Controls m_ctl;
+    vehicle_msgs::CameraBatch m_camera;
+    hmi::perception::v1::PerceptionFrame m_perceptionFrame;
+    can_stream::CanBatch m_can;
+    QByteArray m_out;
+
+    double m_canCarry = 0.0;   // fractional CAN events carried to the next batch
+    quint64 m_canEventCounter = 0;
+    quint64 m_frameCounter = 0;
+};
@@ -0,0 +1,76 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+
+#include "TrafficGenerator.h"
+
+// HMI_TrafficGen: drives a running HMI with synthetic vehicle traffic, e.g.
+//   HMI_TrafficGen --host 127.0.0.1 --nav-hz 50 --waypoints 500 --can-rate 20000 --camera-hz 10
+int main(int argc, char* argv[])
+{
+    // Headless: QImage (JPEG encoding) works without a QGuiApplication
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("HMI_TrafficGen"));
+
+    TrafficGenerator::Config cfg;
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Synthetic vehicle traffic for load-testing the HMI."));
+    parser.addHelpOption();
+
+    auto num = [](const char* name, const char* help, const QString& def) {
+        return QCommandLineOption(QString::fromLatin1(name), QString::fromLatin1(help), QStringLiteral("n"), def);
+    };
+    const QCommandLineOption hostOpt(QStringLiteral("host"), QStringLiteral("HMI address."), QStringLiteral("addr"), cfg.host);
+    const QCommandLineOption transportOpt(QStringLiteral("transport"),
+        QStringLiteral("tcp, udp (Controls/Perception; CAN stays tcp) or shm."), QStringLiteral("name"), cfg.transport);
+    const QCommandLineOption controlsPortOpt = num("controls-port", "Controls port.", QString::number(cfg.controlsPort));
+    const QCommandLineOption perceptionPortOpt = num("perception-port", "Perception port.", QString::number(cfg.perceptionPort));
+    const QCommandLineOption loggerPortOpt = num("logger-port", "CAN logger port.", QString::number(cfg.loggerPort));
+    const QCommandLineOption navHzOpt = num("nav-hz", "Navigation messages per second.", QString::number(cfg.navHz));
+    const QCommandLineOption waypointsOpt = num("waypoints", "Waypoints per Navigation message.", QString::number(cfg.waypoints));
+    const QCommandLineOption controlsHzOpt = num("controls-hz", "Controls messages per second.", QString::number(cfg.controlsHz));
+    const QCommandLineOption perceptionHzOpt = num("perception-hz", "Perception frames per second.", QString::number(cfg.perceptionHz));
+    const QCommandLineOption objectsOpt = num("objects", "Objects per Perception frame.", QString::number(cfg.objects));
+    const QCommandLineOption canRateOpt = num("can-rate", "CAN events per second (across all buses).", QString::number(cfg.canEventsPerSec));
+    const QCommandLineOption canBatchHzOpt = num("can-batch-hz", "CanBatch messages per second.", QString::number(cfg.canBatchHz));
+    const QCommandLineOption canBusesOpt = num("can-buses", "Number of CAN buses.", QString::number(cfg.canBuses));
+    const QCommandLineOption cameraHzOpt = num("camera-hz", "Camera batches per second (0 = off).", QString::number(cfg.cameraHz));
+    const QCommandLineOption camerasOpt = num("cameras", "Frames per camera batch (cam0..).", QString::number(cfg.cameras));
+    const QCommandLineOption jpegBytesOpt = num("jpeg-bytes", "Approximate JPEG size per frame.", QString::number(cfg.jpegBytes));
+    const QCommandLineOption durationOpt = num("duration", "Seconds to run (0 = until interrupted).", QString::number(cfg.durationSec));
+    const QCommandLineOption maxQueuedOpt = num("max-queued", "Per-socket send backlog (bytes) before dropping.", QString::number(cfg.maxQueuedBytes));
+    parser.addOptions({ hostOpt, transportOpt, controlsPortOpt, perceptionPortOpt, loggerPortOpt,
+                        navHzOpt, waypointsOpt, controlsHzOpt, perceptionHzOpt, objectsOpt,
+                        canRateOpt, canBatchHzOpt, canBusesOpt, cameraHzOpt, camerasOpt, jpegBytesOpt,
+                        durationOpt, maxQueuedOpt });
+    parser.process(app);
+
+    cfg.host = parser.value(hostOpt);
+    cfg.transport = parser.value(transportOpt).toLower();
+    if (cfg.transport != QLatin1String("tcp") && cfg.transport != QLatin1String("udp")
+        && cfg.transport != QLatin1String("shm")) {
+        qWarning() << "[TrafficGen] unknown transport" << cfg.transport;
+        return 1;
+    }
+    cfg.controlsPort = static_cast<quint16>(parser.value(controlsPortOpt).toUInt());
+    cfg.perceptionPort = static_cast<quint16>(parser.value(perceptionPortOpt).toUInt());
+    cfg.loggerPort = static_cast<quint16>(parser.value(loggerPortOpt).toUInt());
+    cfg.navHz = parser.value(navHzOpt).toDouble();
+    cfg.waypoints = parser.value(waypointsOpt).toInt();
+    cfg.controlsHz = parser.value(controlsHzOpt).toDouble();
+    cfg.perceptionHz = parser.value(perceptionHzOpt).toDouble();
+    cfg.objects = parser.value(objectsOpt).toInt();
+    cfg.canEventsPerSec = parser.value(canRateOpt).toDouble();
+    cfg.canBatchHz = qMax(1.0, parser.value(canBatchHzOpt).toDouble());
+    cfg.canBuses = qMax(1, parser.value(canBusesOpt).toInt());
+    cfg.cameraHz = parser.value(cameraHzOpt).toDouble();
+    cfg.cameras = qMax(1, parser.value(camerasOpt).toInt());
+    cfg.jpegBytes = qMax(1024, parser.value(jpegBytesOpt).toInt());
+    cfg.durationSec = parser.value(durationOpt).toInt();
+    cfg.maxQueuedBytes = qMax<qint64>(64 * 1024, parser.value(maxQueuedOpt).toLongLong());
+
+    TrafficGenerator gen(cfg);
+    QObject::connect(&gen, &TrafficGenerator::finished, &app, &QCoreApplication::quit, Qt::QueuedConnection);
+    gen.start();
+    return app.exec();
+}